@@ -13,7 +13,6 @@
 
 #include <FairLogger.h>
 
-#include <TF1.h>
 #include <TH1.h>
 #include <TString.h>
 
@@ -128,8 +127,8 @@ int E12014::FillHitSums(std::vector<double> &exp, std::vector<double> &sim, cons
       if (fMap->GetPadSize(expHit->GetPadNum()) != 0)
          continue;
 
-      auto funcExp = AtTools::GetHitFunctionTB(*expHit, fPar);
-      if (funcExp == nullptr)
+      auto kernelExp = AtTools::GetHitKernelTB(*expHit, fPar);
+      if (!kernelExp.IsValid())
          continue;
 
       // We have a hit we want to save for both exp and fisison.
@@ -143,8 +142,8 @@ int E12014::FillHitSums(std::vector<double> &exp, std::vector<double> &sim, cons
       }
       if (simHit == nullptr)
          continue;
-      auto funcSim = AtTools::GetHitFunctionTB(*simHit, fPar);
-      if (funcSim == nullptr)
+      auto kernelSim = AtTools::GetHitKernelTB(*simHit, fPar);
+      if (!kernelSim.IsValid())
          continue;
 
       AtPad *pad = nullptr;
@@ -153,13 +152,14 @@ int E12014::FillHitSums(std::vector<double> &exp, std::vector<double> &sim, cons
 
       numGoodHits++;
       // Get the pad that corresponds to
-      //  We now have the sim and exp hits. Fill the arrays
-      for (int tb = fTBMin; tb < 512; ++tb) {
+      //  We now have the sim and exp hits. Fill the arrays where the exp hit has charge
+      auto range = kernelExp.GetTBRange(fTBMin, 512, kernelExp.GetNumSigmaAbove(threshold));
+      for (int tb = range.first; tb < range.second; ++tb) {
 
-         auto val = funcExp->Eval(tb);
+         auto val = kernelExp.Eval(tb);
          if (val > threshold) {
             exp[tb] += val;
-            sim[tb] += funcSim->Eval(tb);
+            sim[tb] += kernelSim.Eval(tb);
             if (pad && expADC)
                (*expADC)[tb] += pad->GetADC(tb);
          }
@@ -179,13 +179,12 @@ void E12014::FillSimSum(std::vector<double> &sim, const std::vector<AtHit *> &si
 
    for (auto &expHit : simHits) {
 
-      auto funcExp = AtTools::GetHitFunctionTB(*expHit);
-      if (funcExp == nullptr)
+      auto kernel = AtTools::GetHitKernelTB(*expHit);
+      if (!kernel.IsValid())
          continue;
 
-      for (int tb = fTBMin; tb < 512; ++tb) {
-         sim[tb] += funcExp->Eval(tb);
-      }
+      for (int tb = fTBMin; tb < 512; ++tb)
+         sim[tb] += kernel.Eval(tb);
    }
 }
 
@@ -269,16 +268,12 @@ E12014::FillHitSum(std::vector<double> &vec, const std::vector<AtHit *> &hits, i
       if (hit->GetCharge() > satThresh)
          continue;
 
-      auto func = AtTools::GetHitFunctionTB(*hit);
-      if (func == nullptr)
+      auto kernel = AtTools::GetHitKernelTB(*hit);
+      if (!kernel.IsValid())
          continue;
 
       // Add the charge to the array
-      for (int tb = 0; tb < vec.size(); ++tb) {
-         auto val = func->Eval(tb);
-         if (val > threshold)
-            vec[tb] += val;
-      }
+      AtTools::AddHitToTrace(kernel, vec.data(), vec.size(), 1, threshold, false, kernel.GetNumSigmaAbove(threshold));
       // Add the pad to the return list
       goodPads.insert(hit->GetPadNum());
    }
@@ -309,17 +304,13 @@ void E12014::FillSimHitSum(std::vector<double> &vec, const std::vector<AtHit *>
       if (hit->GetCharge() > satThresh)
          continue;
 
-      auto func = AtTools::GetHitFunctionTB(*hit);
-      if (func == nullptr)
+      auto kernel = AtTools::GetHitKernelTB(*hit);
+      if (!kernel.IsValid())
          continue;
 
       // Add the charge to the array
       LOG(debug) << "Adding pad " << hit->GetPadNum();
-
-      for (int tb = 0; tb < vec.size(); ++tb) {
-         auto val = func->Eval(tb) * amp;
-         if (val > threshold)
-            vec[tb] += val;
-      }
+      AtTools::AddHitToTrace(kernel, vec.data(), vec.size(), amp, threshold, false,
+                             kernel.GetNumSigmaAbove(threshold, amp));
    }
 }
@@ -44,7 +44,7 @@ public:
 
    void SetTrackCand(std::vector<AtTrack> tracks) { fTrackCand = std::move(tracks); }
    void AddTrack(const AtTrack &track) { fTrackCand.push_back(track); }
-   void AddTrack(AtTrack &&track) { fTrackCand.push_back(track); }
+   void AddTrack(AtTrack &&track) { fTrackCand.push_back(std::move(track)); }
 
    template <typename... Ts>
    void AddNoise(Ts &&... params)
@@ -11,7 +11,7 @@
 #include <TMathBase.h> // for Abs
 #include <TObject.h>   // for TObject
 #include <TRandom.h>
-#include <TString.h> // for operator!=, TString
+#include <TString.h> // for TString
 
 #include <algorithm> // for max
 #include <utility>   // for move
@@ -59,7 +59,7 @@ std::vector<AtClusterize::SimPointPtr> AtClusterize::ProcessEvent(const TClonesA
 
 std::vector<AtClusterize::SimPointPtr> AtClusterize::processPoint(AtMCPoint &mcPoint, int pointID)
 {
-   if (mcPoint.GetVolName() != "drift_volume") {
+   if (mcPoint.GetVolID() != AtMCPoint::kDriftVolume) {
       LOG(info) << "Skipping point " << pointID << ". Not in drift volume.";
       return {};
    }
@@ -81,17 +81,18 @@ std::vector<AtClusterize::SimPointPtr> AtClusterize::processPoint(AtMCPoint &mcP
       step = (currentPoint - fPrevPoint) / genElectrons;
    }
 
-   auto sigTrans = getTransverseDiffusion(currentPoint.z());  // mm
-   auto sigLong = getLongitudinalDiffusion(currentPoint.z()); // us
-
    std::vector<SimPointPtr> ret;
 
-   // Need to loop through electrons
+   // Need to loop through electrons. Each one is created at the center of its share of the
+   // segment between the previous and current point, and diffuses over its own drift time.
    for (int i = 0; i < genElectrons; ++i) {
-      auto loc = applyDiffusion(currentPoint + i * step, sigTrans, sigLong);
+      auto origin = fPrevPoint + (i + 0.5) * step;
+      auto sigTrans = getTransverseDiffusion(origin.z());  // mm
+      auto sigLong = getLongitudinalDiffusion(origin.z()); // us
+      auto loc = applyDiffusion(origin, sigTrans, sigLong);
       XYZVector locVec(loc.X(), loc.Y(), loc.Z());
       ret.push_back(std::make_unique<AtSimulatedPoint>(pointID, i, locVec));
-      LOG(debug2) << loc << " from " << currentPoint + i * step;
+      LOG(debug2) << loc << " from " << origin;
    }
 
    fPrevPoint = currentPoint;
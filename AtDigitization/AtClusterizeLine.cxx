@@ -10,7 +10,7 @@
 #include <Math/Vector3D.h>
 #include <Math/Vector3Dfwd.h>
 #include <TClonesArray.h>
-#include <TString.h> // for operator!=, TString
+#include <TString.h> // for TString
 
 #include <algorithm> // for max
 #include <memory>
@@ -34,7 +34,7 @@ void AtClusterizeLine::FillTClonesArray(TClonesArray &array, std::vector<SimPoin
 
 std::vector<AtClusterize::SimPointPtr> AtClusterizeLine::processPoint(AtMCPoint &mcPoint, int pointID)
 {
-   if (mcPoint.GetVolName() != "drift_volume") {
+   if (mcPoint.GetVolID() != AtMCPoint::kDriftVolume) {
       LOG(info) << "Skipping point " << pointID << ". Not in drift volume.";
       return {};
    }
@@ -0,0 +1,223 @@
+#include "AtPadIntegrator.h"
+
+#include "AtMap.h"
+
+#include <FairLogger.h>
+
+#include <TCollection.h> // for TIter
+#include <TGraph.h>
+#include <TH2Poly.h>
+#include <TList.h>
+#include <TMath.h>
+
+#include <algorithm> // for max, min, sort, unique
+#include <cmath>     // for ceil, erfc, exp, floor, sqrt
+#include <memory>    // for unique_ptr
+
+namespace {
+// 5 point Gauss-Legendre quadrature on [-1, 1]
+constexpr double cGLNodes[] = {-0.9061798459386640, -0.5384693101056831, 0, 0.5384693101056831, 0.9061798459386640};
+constexpr double cGLWeights[] = {0.2369268850561891, 0.4786286704993665, 0.5688888888888889, 0.4786286704993665,
+                                 0.2369268850561891};
+} // namespace
+
+AtPadIntegrator::AtPadIntegrator(AtMap &map)
+{
+   std::unique_ptr<TH2Poly> padPlane(map.GetPadPlane());
+   TIter next(padPlane->GetBins());
+   while (auto bin = dynamic_cast<TH2PolyBin *>(next())) {
+      auto graph = dynamic_cast<TGraph *>(bin->GetPolygon());
+      if (graph == nullptr) {
+         LOG(warn) << "Skipping bin " << bin->GetBinNumber() << " of the pad plane that is not a single polygon.";
+         continue;
+      }
+
+      Pad pad;
+      pad.padNum = map.BinToPad(bin->GetBinNumber());
+      if (pad.padNum < 0)
+         continue;
+      // Polygons are closed by repeating the first vertex, which we drop
+      int numVertices = graph->GetN();
+      if (numVertices > 1 && graph->GetX()[0] == graph->GetX()[numVertices - 1] &&
+          graph->GetY()[0] == graph->GetY()[numVertices - 1])
+         --numVertices;
+      if (numVertices < 3)
+         continue;
+
+      double xSum = 0;
+      double ySum = 0;
+      for (int i = 0; i < numVertices; ++i) {
+         pad.vertices.emplace_back(graph->GetX()[i], graph->GetY()[i]);
+         xSum += graph->GetX()[i];
+         ySum += graph->GetY()[i];
+      }
+      pad.center = XYPoint(xSum / numVertices, ySum / numVertices);
+
+      if (pad.padNum >= fPadIndex.size())
+         fPadIndex.resize(pad.padNum + 1, -1);
+      fPadIndex[pad.padNum] = fPads.size();
+      fPads.push_back(std::move(pad));
+   }
+
+   BuildGrid();
+   LOG(debug) << "Read " << fPads.size() << " pads into a grid of " << fNumCellsX << "x" << fNumCellsY
+              << " cells of size " << fCellSize;
+}
+
+/// Bin the pads in a grid with cells the average size of a pad.
+void AtPadIntegrator::BuildGrid()
+{
+   if (fPads.empty())
+      return;
+
+   struct Box {
+      double xMin, xMax, yMin, yMax;
+   };
+   std::vector<Box> boxes;
+   double sizeSum = 0;
+   for (auto &pad : fPads) {
+      Box box{pad.vertices[0].X(), pad.vertices[0].X(), pad.vertices[0].Y(), pad.vertices[0].Y()};
+      for (auto &vert : pad.vertices) {
+         box.xMin = std::min(box.xMin, vert.X());
+         box.xMax = std::max(box.xMax, vert.X());
+         box.yMin = std::min(box.yMin, vert.Y());
+         box.yMax = std::max(box.yMax, vert.Y());
+      }
+      sizeSum += std::max(box.xMax - box.xMin, box.yMax - box.yMin);
+      boxes.push_back(box);
+   }
+
+   fXMin = boxes[0].xMin;
+   fYMin = boxes[0].yMin;
+   double xMax = boxes[0].xMax;
+   double yMax = boxes[0].yMax;
+   for (auto &box : boxes) {
+      fXMin = std::min(fXMin, box.xMin);
+      fYMin = std::min(fYMin, box.yMin);
+      xMax = std::max(xMax, box.xMax);
+      yMax = std::max(yMax, box.yMax);
+   }
+
+   fCellSize = sizeSum / fPads.size();
+   if (fCellSize <= 0)
+      fCellSize = 1;
+   fNumCellsX = std::floor((xMax - fXMin) / fCellSize) + 1;
+   fNumCellsY = std::floor((yMax - fYMin) / fCellSize) + 1;
+   fCells.assign(fNumCellsX * fNumCellsY, {});
+
+   for (int i = 0; i < boxes.size(); ++i) {
+      int ixMin = (boxes[i].xMin - fXMin) / fCellSize;
+      int ixMax = (boxes[i].xMax - fXMin) / fCellSize;
+      int iyMin = (boxes[i].yMin - fYMin) / fCellSize;
+      int iyMax = (boxes[i].yMax - fYMin) / fCellSize;
+      for (int ix = ixMin; ix <= ixMax; ++ix)
+         for (int iy = iyMin; iy <= iyMax; ++iy)
+            fCells[ix + iy * fNumCellsX].push_back(i);
+   }
+}
+
+bool AtPadIntegrator::GetPadCenter(int padNum, XYPoint &center) const
+{
+   if (padNum < 0 || padNum >= fPadIndex.size() || fPadIndex[padNum] < 0)
+      return false;
+   center = fPads[fPadIndex[padNum]].center;
+   return true;
+}
+
+std::vector<std::pair<int, double>> AtPadIntegrator::Integrate(const XYPoint &center, double sigma) const
+{
+   std::vector<std::pair<int, double>> ret;
+   if (fCells.empty() || sigma <= 0)
+      return ret;
+
+   auto toCell = [this](double val, double min, int numCells) {
+      return std::clamp<int>(std::floor((val - min) / fCellSize), 0, numCells - 1);
+   };
+   auto dist = fNumSigma * sigma;
+   int ixMin = toCell(center.X() - dist, fXMin, fNumCellsX);
+   int ixMax = toCell(center.X() + dist, fXMin, fNumCellsX);
+   int iyMin = toCell(center.Y() - dist, fYMin, fNumCellsY);
+   int iyMax = toCell(center.Y() + dist, fYMin, fNumCellsY);
+
+   std::vector<int> candidates;
+   for (int ix = ixMin; ix <= ixMax; ++ix)
+      for (int iy = iyMin; iy <= iyMax; ++iy)
+         candidates.insert(candidates.end(), fCells[ix + iy * fNumCellsX].begin(), fCells[ix + iy * fNumCellsX].end());
+   std::sort(candidates.begin(), candidates.end());
+   candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+   for (auto i : candidates) {
+      auto frac = IntegratePolygon(fPads[i].vertices, center, sigma, fNumSigma);
+      if (frac > fThreshold)
+         ret.emplace_back(fPads[i].padNum, frac);
+   }
+   return ret;
+}
+
+/**
+ * Sum over the edges of the line integral of Phi(x)G(y) dy. Only the part of each edge within
+ * numSigma of the center in y contributes, and of that only the part within numSigma in x needs
+ * quadrature.
+ */
+double AtPadIntegrator::IntegratePolygon(const std::vector<XYPoint> &vertices, const XYPoint &center, double sigma,
+                                         double numSigma)
+{
+   const double norm = 1. / (sigma * TMath::Sqrt2());
+   auto cdfX = [&](double x) { return 0.5 * std::erfc(-(x - center.X()) * norm); };
+   auto cdfY = [&](double y) { return 0.5 * std::erfc(-(y - center.Y()) * norm); };
+   auto gausY = [&](double y) {
+      auto u = (y - center.Y()) * norm;
+      return std::exp(-u * u) * norm / TMath::Sqrt(TMath::Pi());
+   };
+
+   double sum = 0;
+   for (int i = 0; i < vertices.size(); ++i) {
+      const auto &a = vertices[i];
+      const auto &b = vertices[(i + 1) % vertices.size()];
+      double dy = b.Y() - a.Y();
+      if (dy == 0)
+         continue;
+
+      // Parameterize the edge as a + t(b - a) and clip t to the y window around the center
+      double t0 = (center.Y() - numSigma * sigma - a.Y()) / dy;
+      double t1 = (center.Y() + numSigma * sigma - a.Y()) / dy;
+      double tMin = std::max(0., std::min(t0, t1));
+      double tMax = std::min(1., std::max(t0, t1));
+      if (tMin >= tMax)
+         continue;
+
+      double dx = b.X() - a.X();
+      if (dx == 0) {
+         sum += cdfX(a.X()) * (cdfY(a.Y() + tMax * dy) - cdfY(a.Y() + tMin * dy));
+         continue;
+      }
+
+      // Beyond numSigma in x Phi is 0 or 1, so only the part of the edge within the window needs quadrature
+      double u0 = (center.X() - numSigma * sigma - a.X()) / dx;
+      double u1 = (center.X() + numSigma * sigma - a.X()) / dx;
+      double qMin = std::clamp(std::min(u0, u1), tMin, tMax);
+      double qMax = std::clamp(std::max(u0, u1), tMin, tMax);
+      auto addOutside = [&](double tLow, double tHigh) {
+         if (tLow < tHigh && a.X() + (tLow + tHigh) / 2. * dx > center.X())
+            sum += cdfY(a.Y() + tHigh * dy) - cdfY(a.Y() + tLow * dy);
+      };
+      addOutside(tMin, qMin);
+      addOutside(qMax, tMax);
+      if (qMin >= qMax)
+         continue;
+
+      double length = (qMax - qMin) * std::sqrt(dx * dx + dy * dy);
+      int numPieces = std::ceil(length / (2 * sigma));
+      double halfWidth = (qMax - qMin) / numPieces / 2.;
+      for (int n = 0; n < numPieces; ++n) {
+         double mid = qMin + (2 * n + 1) * halfWidth;
+         for (int k = 0; k < 5; ++k) {
+            double t = mid + cGLNodes[k] * halfWidth;
+            sum += cGLWeights[k] * halfWidth * cdfX(a.X() + t * dx) * gausY(a.Y() + t * dy) * dy;
+         }
+      }
+   }
+
+   // The sign depends on the orientation of the polygon
+   return std::abs(sum);
+}
@@ -0,0 +1,72 @@
+#ifndef ATPADINTEGRATOR_H
+#define ATPADINTEGRATOR_H
+
+#include <Math/Point2D.h> // for XYPoint
+
+#include <utility> // for pair
+#include <vector>
+
+class AtMap;
+
+/**
+ * Integrates a 2D gaussian (e.g. a charge cloud after transverse diffusion) over the pads of the
+ * pad plane of an AtMap, without sampling.
+ *
+ * By Green's theorem the integral of G(x)G(y) over a pad is the sum over its edges of the line
+ * integral of Phi(x)G(y) dy, where Phi is the gaussian CDF. Vertical edges are integrated
+ * analytically, and the other edges with Gauss-Legendre quadrature on pieces no longer than 2 sigma.
+ * Only pads within fNumSigma of the center are considered, found through a uniform grid over the
+ * bounding boxes of the pads.
+ *
+ * Integrate is const, so once configured one object can be shared between threads.
+ */
+class AtPadIntegrator {
+public:
+   using XYPoint = ROOT::Math::XYPoint;
+
+private:
+   struct Pad {
+      int padNum;
+      std::vector<XYPoint> vertices;
+      XYPoint center; //< Average of the vertices
+   };
+
+   std::vector<Pad> fPads;
+   std::vector<int> fPadIndex; //< fPadIndex[padNum] = index of pad in fPads or -1
+
+   // Grid used to find the pads near a point
+   double fXMin{0};
+   double fYMin{0};
+   double fCellSize{1};
+   int fNumCellsX{0};
+   int fNumCellsY{0};
+   std::vector<std::vector<int>> fCells; //< Indices in fPads of the pads overlapping each cell
+
+   double fNumSigma{5};    //< Distance from the center to integrate to
+   double fThreshold{1e-6}; //< Pads with a smaller fraction of the charge are dropped
+
+public:
+   /// Read the geometry of the pads from the pad plane of map
+   AtPadIntegrator(AtMap &map);
+
+   void SetNumSigma(double numSigma) { fNumSigma = numSigma; }
+   void SetThreshold(double threshold) { fThreshold = threshold; }
+
+   /// Center of the pad (average of its vertices). Returns false if the pad is not in the map.
+   bool GetPadCenter(int padNum, XYPoint &center) const;
+
+   /**
+    * Fraction of a gaussian centered at center with a standard deviation of sigma (in both x and y)
+    * landing on each pad. Returns pairs of (padNum, fraction).
+    */
+   std::vector<std::pair<int, double>> Integrate(const XYPoint &center, double sigma) const;
+
+   /// Integral of a normalized gaussian over a polygon
+   static double IntegratePolygon(const std::vector<XYPoint> &vertices, const XYPoint &center, double sigma,
+                                  double numSigma = 5);
+
+private:
+   void BuildGrid();
+};
+
+#endif //#ifndef ATPADINTEGRATOR_H
@@ -0,0 +1,107 @@
+#include "AtPolyaSampler.h"
+
+#include <cmath>
+
+namespace {
+uint64_t splitMix64(uint64_t x)
+{
+   x += 0x9e3779b97f4a7c15ULL;
+   x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+   x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+   return x ^ (x >> 31);
+}
+} // namespace
+
+AtCounterRNG::AtCounterRNG(uint64_t seed, uint64_t stream)
+   : fSeed(seed), fKey(splitMix64(splitMix64(seed) ^ stream))
+{
+}
+
+uint64_t AtCounterRNG::NextInt()
+{
+   return splitMix64(fKey ^ splitMix64(fCounter++));
+}
+
+/// Marsaglia polar method, keeping the second number for the next call.
+double AtCounterRNG::Gaus()
+{
+   if (fHasSpare) {
+      fHasSpare = false;
+      return fSpare;
+   }
+
+   double u, v, s;
+   do {
+      u = 2 * Uniform() - 1;
+      v = 2 * Uniform() - 1;
+      s = u * u + v * v;
+   } while (s >= 1);
+
+   auto scale = std::sqrt(-2 * std::log(s) / s);
+   fSpare = v * scale;
+   fHasSpare = true;
+   return u * scale;
+}
+
+double AtPolyaSampler::GetSigma() const
+{
+   return fMean / std::sqrt(fShape);
+}
+
+/// Draws the same numbers as calling Sample(rng) n times (up to round off).
+void AtPolyaSampler::Sample(AtCounterRNG &rng, double *gains, size_t n) const
+{
+   // Constants of the Marsaglia-Tsang method only depend on the shape. Shapes below one get the
+   // same boost as in SampleGamma.
+   const bool boost = fShape < 1;
+   const double d = (boost ? fShape + 1 : fShape) - 1. / 3.;
+   const double c = 1 / std::sqrt(9 * d);
+   const double scale = fMean / fShape * d;
+
+   for (size_t i = 0; i < n; ++i) {
+      while (true) {
+         double x = rng.Gaus();
+         double v = 1 + c * x;
+         if (v <= 0)
+            continue;
+         v = v * v * v;
+         double u = rng.Uniform();
+         if (u < 1 - 0.0331 * x * x * x * x || std::log(u) < 0.5 * x * x + d * (1 - v + std::log(v))) {
+            gains[i] = scale * v;
+            break;
+         }
+      }
+      if (boost)
+         gains[i] *= std::pow(rng.Uniform(), 1 / fShape);
+   }
+}
+
+double AtPolyaSampler::SampleMean(AtCounterRNG &rng, int numElectrons) const
+{
+   if (numElectrons <= 0)
+      return 0;
+   return SampleGamma(rng, fShape * numElectrons) * fMean / (fShape * numElectrons);
+}
+
+/**
+ * Marsaglia and Tsang, "A simple method for generating gamma variables", ACM TOMS 26 (2000).
+ * Shapes below one are sampled with shape + 1 and scaled by u^(1/shape).
+ */
+double AtPolyaSampler::SampleGamma(AtCounterRNG &rng, double shape)
+{
+   if (shape < 1)
+      return SampleGamma(rng, shape + 1) * std::pow(rng.Uniform(), 1 / shape);
+
+   const double d = shape - 1. / 3.;
+   const double c = 1 / std::sqrt(9 * d);
+   while (true) {
+      double x = rng.Gaus();
+      double v = 1 + c * x;
+      if (v <= 0)
+         continue;
+      v = v * v * v;
+      double u = rng.Uniform();
+      if (u < 1 - 0.0331 * x * x * x * x || std::log(u) < 0.5 * x * x + d * (1 - v + std::log(v)))
+         return d * v;
+   }
+}
@@ -0,0 +1,65 @@
+#ifndef ATPOLYASAMPLER_H
+#define ATPOLYASAMPLER_H
+
+#include <cstddef> // for size_t
+#include <cstdint> // for uint64_t
+
+/**
+ * Counter-based random number generator. The n-th number of a stream is a hash (SplitMix64) of
+ * the seed, the stream number, and n, so there is no shared state and every copy of an object
+ * (e.g. an AtPulse cloned for a thread) can use its own stream without locking.
+ */
+class AtCounterRNG {
+private:
+   uint64_t fSeed{0};
+   uint64_t fKey{0}; //< Hash of the seed and stream
+   uint64_t fCounter{0};
+   bool fHasSpare{false};
+   double fSpare{0};
+
+public:
+   AtCounterRNG(uint64_t seed = 0, uint64_t stream = 0);
+
+   uint64_t GetSeed() const { return fSeed; }
+   uint64_t NextInt();
+   /// Uniform in (0, 1)
+   double Uniform() { return ((NextInt() >> 11) + 0.5) * 0x1.0p-53; }
+   /// Standard normal
+   double Gaus();
+};
+
+/**
+ * Samples the avalanche gain of electrons in the micromegas. The gain follows a Polya distribution
+ * with mean G and parameter theta, p(g) ~ (g/G)^theta exp(-(theta+1) g/G), which is a gamma
+ * distribution with shape theta+1 and scale G/(theta+1). Gamma variables are drawn with the
+ * Marsaglia-Tsang method.
+ *
+ * Since a sum of gamma variables with the same scale is gamma distributed, the average gain of N
+ * electrons is a single draw (SampleMean) instead of N.
+ */
+class AtPolyaSampler {
+private:
+   double fMean{0};
+   double fShape{2};
+
+public:
+   AtPolyaSampler() = default;
+   AtPolyaSampler(double mean, double theta = 1) : fMean(mean), fShape(theta + 1) {}
+
+   double GetMean() const { return fMean; }
+   double GetTheta() const { return fShape - 1; }
+   /// Standard deviation of the gain of a single electron
+   double GetSigma() const;
+
+   /// Gain of a single electron
+   double Sample(AtCounterRNG &rng) const { return SampleGamma(rng, fShape) * fMean / fShape; }
+   /// Fill gains with the gain of n electrons
+   void Sample(AtCounterRNG &rng, double *gains, size_t n) const;
+   /// Average gain of numElectrons electrons
+   double SampleMean(AtCounterRNG &rng, int numElectrons) const;
+
+   /// Gamma distributed number with unit scale
+   static double SampleGamma(AtCounterRNG &rng, double shape);
+};
+
+#endif //#ifndef ATPOLYASAMPLER_H
@@ -17,14 +17,21 @@
 #include <Math/Point2Dfwd.h> // for XYPoint
 #include <Rtypes.h>          // for Int_t
 #include <TAxis.h>
-#include <TMath.h> // for Gamma, Sqrt
+#include <TMath.h> // for Sqrt
 #include <TRandom.h>
 #include <TString.h> // for TString
 
+#include <atomic>
 #include <utility> // for move
 
 using XYPoint = ROOT::Math::XYPoint;
-AtPulse::AtPulse(AtMapPtr map, ResponseFunc response) : fMap(map), fResponse(response) // NOLINT
+
+namespace {
+std::atomic<uint64_t> fNumStreams{0}; // Every AtPulse (including copies) gets its own random stream
+} // namespace
+
+AtPulse::AtPulse(AtMapPtr map, ResponseFunc response)
+   : fMap(map), fResponse(response), fRandom(gRandom->Integer(kMaxUInt), fNumStreams++) // NOLINT
 {
    // Make sure the pad plane is generated so we can just access it for reading info (ie multiple threads will not be
    // trying to create the underlying TH2poly.
@@ -36,7 +43,8 @@ AtPulse::AtPulse(const AtPulse &other)
      fGETGain(other.fGETGain), fPeakingTime(other.fPeakingTime), fTBTime(other.fTBTime), fNumTbs(other.fNumTbs),
      fTBEntrance(other.fTBEntrance), fTBPadPlane(other.fTBPadPlane), fResponse(other.fResponse),
      fUseFastGain(other.fUseFastGain), fNoiseSigma(other.fNoiseSigma), fSaveCharge(other.fSaveCharge),
-     fDoConvolution(other.fDoConvolution), fAvgGainDeviation(other.fAvgGainDeviation)
+     fDoConvolution(other.fDoConvolution), fGainSampler(other.fGainSampler),
+     fRandom(other.fRandom.GetSeed(), fNumStreams++)
 {
 
    // For reasons unknown, copying the historgam from other (calling copy constructor) causes a huge performance hit.
@@ -50,7 +58,6 @@ AtPulse::AtPulse(const AtPulse &other)
    }
 
    fPadsWithCharge = other.fPadsWithCharge;
-   fGainFunc = (other.fGainFunc) ? std::make_unique<TF1>(*other.fGainFunc) : nullptr;
 }
 
 AtRawEvent AtPulse::GenerateEvent(std::vector<SimPointPtr> &vec)
@@ -142,17 +149,7 @@ void AtPulse::SetParameters(const AtDigiPar *fPar)
    fTBEntrance = fPar->GetTBEntrance();
    fTBPadPlane = fTBEntrance - fPar->GetZPadPlane() / 10. / fTBTime / fPar->GetDriftVelocity();
 
-   fGainFunc = std::make_unique<TF1>(
-      "gain", "pow([1]+1,[1]+1)/ROOT::Math::tgamma([1]+1)*pow((x/[0]),[1])*exp(-([1]+1)*(x/[0]))", 0,
-      fGain * 5); // Polya distribution of gain
-   fGainFunc->SetParameter(0, fGain);
-   fGainFunc->SetParameter(1, 1);
-
-   auto b = fGainFunc->GetParameter(1);
-   fAvgGainDeviation = fGain / (b + 1);
-   fAvgGainDeviation *=
-      TMath::Sqrt(TMath::Gamma(b + 3) / TMath::Gamma(b + 1) -
-                  TMath::Gamma(b + 2) * TMath::Gamma(b + 2) / TMath::Gamma(b + 1) / TMath::Gamma(b + 1));
+   fGainSampler = AtPolyaSampler(fGain, 1); // Polya distribution of gain
 
    LOG(info) << "Gain: " << fGain;
    LOG(info) << "GETGain: " << fGETGain;
@@ -214,10 +211,8 @@ double AtPulse::GetGain(int padNum, int numElectrons)
       lowGain = fLowGainFactor;
 
    if (fUseFastGain && numElectrons > 10)
-      return gRandom->Gaus(fGain, fAvgGainDeviation / TMath::Sqrt(numElectrons)) * lowGain;
+      return (fGain + fRandom.Gaus() * fGainSampler.GetSigma() / TMath::Sqrt(numElectrons)) * lowGain;
 
-   double g = 0;
-   for (Int_t i = 0; i < numElectrons; i++)
-      g += fGainFunc->GetRandom();
-   return g / numElectrons * lowGain;
+   // The sum of the (gamma distributed) gain of each electron is a single gamma distributed number
+   return fGainSampler.SampleMean(fRandom, numElectrons) * lowGain;
 }
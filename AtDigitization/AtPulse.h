@@ -1,11 +1,12 @@
 #ifndef ATPULSE_H
 #define ATPULSE_H
 
+#include "AtPolyaSampler.h"
+
 #include <Math/Point3D.h>
 #include <Math/Point3Dfwd.h> // for XYZPoint
 #include <Math/Vector3D.h>
 #include <Math/Vector3Dfwd.h>
-#include <TF1.h> //Needed for unique_ptr<TF1>
 #include <TH1.h> //Needed for unique_ptr<TH1F>
 
 #include <functional> // for function
@@ -50,8 +51,8 @@ protected:
    std::vector<std::unique_ptr<TH1F>> fPadCharge; //!<
    std::set<int> fPadsWithCharge;                 //!<
 
-   std::unique_ptr<TF1> fGainFunc; //!<
-   double fAvgGainDeviation{};
+   AtPolyaSampler fGainSampler; //!< Polya distribution of the gain
+   AtCounterRNG fRandom;        //!< Random stream for the gain, unique to each copy
 
 public:
    AtPulse(AtMapPtr map, ResponseFunc response = nullptr);
@@ -59,6 +60,7 @@ public:
 
    void SetParameters(const AtDigiPar *fPar);
    AtMapPtr GetMap() { return fMap; }
+   /// Approximate the average gain of more than 10 electrons with a gaussian
    void UseFastGain(bool val) { fUseFastGain = val; }
    void SetNoiseSigma(double val) { fNoiseSigma = val; }
    void SetSaveCharge(bool val) { fSaveCharge = val; }
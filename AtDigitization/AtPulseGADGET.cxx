@@ -13,6 +13,9 @@
 #include <TH1.h>
 #include <TMath.h>
 
+#include <algorithm> // for min
+#include <array>
+#include <cmath>
 #include <iostream>
 #include <set> // for set
 class AtPad;
@@ -26,16 +29,81 @@ using XYPoint = ROOT::Math::XYPoint;
 using namespace ElectronicResponse;
 AtPulseGADGET::AtPulseGADGET(AtMapPtr map) : AtPulse(map) {}
 
+namespace {
+// Table of erf(x) for x in [-kErfMax, kErfMax] used for linear interpolation. The interpolation error
+// is about 1e-7, much smaller than the statistical fluctuation of the charge.
+constexpr double kErfMax = 6;
+constexpr int kErfBinsPerUnit = 1024;
+constexpr int kErfTableSize = 2 * kErfMax * kErfBinsPerUnit + 1;
+
+const std::array<double, kErfTableSize> &ErfTable()
+{
+   static const auto table = []() {
+      std::array<double, kErfTableSize> ret{};
+      for (int i = 0; i < kErfTableSize; ++i)
+         ret[i] = std::erf(-kErfMax + double(i) / kErfBinsPerUnit);
+      return ret;
+   }();
+   return table;
+}
+} // namespace
+
+Double_t AtPulseGADGET::FastErf(Double_t x)
+{
+   if (x <= -kErfMax)
+      return -1;
+   if (x >= kErfMax)
+      return 1;
+
+   const auto &table = ErfTable();
+   double pos = (x + kErfMax) * kErfBinsPerUnit;
+   int bin = std::min<int>(pos, kErfTableSize - 2);
+   double frac = pos - bin;
+   return table[bin] + frac * (table[bin + 1] - table[bin]);
+}
+
+Double_t AtPulseGADGET::GetSigma(Double_t time) const
+{
+   return TMath::Sqrt(2 * time / (R * C) + 2 * Dc * t_amp) * SigmaPercent;
+}
+
 Double_t AtPulseGADGET::ChargeDispersion(Double_t G, Double_t time, Double_t x0, Double_t y0, Double_t xi, Double_t yi)
 {
-   Double_t Sigma = TMath::Sqrt(2 * time / (R * C) + 2 * Dc * t_amp) * SigmaPercent;
+   Double_t Sigma = GetSigma(time);
    Double_t rtTwo = TMath::Sqrt(2);
-   Double_t Charge =
-      G / 4 * (TMath::Erf((xi + W / 2 - x0) / (rtTwo * Sigma)) - TMath::Erf((xi - W / 2 - x0) / (rtTwo * Sigma))) *
-      (TMath::Erf((yi + W / 2 - y0) / (rtTwo * Sigma)) - TMath::Erf((yi - W / 2 - y0) / (rtTwo * Sigma)));
+   Double_t Charge = G / 4 * (FastErf((xi + W / 2 - x0) / (rtTwo * Sigma)) - FastErf((xi - W / 2 - x0) / (rtTwo * Sigma))) *
+                     (FastErf((yi + W / 2 - y0) / (rtTwo * Sigma)) - FastErf((yi - W / 2 - y0) / (rtTwo * Sigma)));
    return Charge;
 };
 
+/**
+ * Get the center of padNum and the pads in the Items x Items grid around it. The lookup of the pads
+ * does not depend on the electron so it is cached for every valid pad number.
+ */
+const AtPulseGADGET::PadGrid &AtPulseGADGET::GetPadGrid(Int_t padNum)
+{
+   Int_t numPads = fMap->GetNumPads();
+   bool validPad = padNum >= 0 && padNum < numPads;
+   if (validPad && fPadGrid.size() != numPads)
+      fPadGrid.assign(numPads, PadGrid{});
+   if (validPad && !fPadGrid[padNum].fPads.empty())
+      return fPadGrid[padNum];
+
+   static thread_local PadGrid invalidGrid;
+   PadGrid &grid = validPad ? fPadGrid[padNum] : invalidGrid;
+   grid.fCenter = fMap->CalcPadCenter(padNum);
+   grid.fPads.resize(Items * Items);
+
+   for (Int_t i = 0; i < Items; i++) {
+      for (Int_t j = 0; j < Items; j++) {
+         auto pad = fMap->GetPadNum(XYPoint{grid.fCenter.X() + (i - AdjecentPads) * W,
+                                            grid.fCenter.Y() + (j - AdjecentPads) * W});
+         grid.fPads[i * Items + j] = (pad < 0 || pad >= numPads) ? -1 : pad;
+      }
+   }
+   return grid;
+}
+
 bool AtPulseGADGET::AssignElectronsToPad(AtSimulatedPoint *point)
 {
    fSkippy = 0;
@@ -59,40 +127,38 @@ bool AtPulseGADGET::AssignElectronsToPad(AtSimulatedPoint *point)
       padNumber = fMap->GetPadNum(XYPoint{xElectron + 0.001, yElectron + 0.001});
    };
 
-   auto PadCenter = fMap->CalcPadCenter(padNumber); // get pad center
+   const auto &grid = GetPadGrid(padNumber);
 
-   // Setting up cordinates for adjecent pads
-   Double_t coords[Items];
+   // The charge on each pad in the grid is separable in x and y, so only compute the erf differences
+   // for each row and column of the grid.
+   Double_t sigma = GetSigma(eTime) * TMath::Sqrt(2);
+   std::vector<Double_t> xFrac(Items), yFrac(Items);
    for (Int_t n = 0; n < Items; n++) {
-      coords[n] = AdjecentPads * -2.2 + 2.2 * n;
-   };
-   // Store the pad range in a variable
-   Int_t numPads = fMap->GetNumPads();
+      Double_t offset = (n - AdjecentPads) * W;
+      Double_t xi = grid.fCenter.X() + offset - xElectron;
+      Double_t yi = grid.fCenter.Y() + offset - yElectron;
+      xFrac[n] = FastErf((xi + W / 2) / sigma) - FastErf((xi - W / 2) / sigma);
+      yFrac[n] = FastErf((yi + W / 2) / sigma) - FastErf((yi - W / 2) / sigma);
+   }
 
-   // Calculate xPadCurrent and yPadCurrent outside the loop
-   Double_t xPadCurrent, yPadCurrent;
    for (Int_t i = 0; i < Items; i++) {
-      xPadCurrent = PadCenter.X() + coords[i]; // NOLINT
       for (Int_t j = 0; j < Items; j++) {
-         yPadCurrent = PadCenter.Y() + coords[j]; // NOLINT
-
-         // Calculate newpadNumber directly from newbinNumber
-         auto newpadNumber = fMap->GetPadNum(XYPoint{xPadCurrent, yPadCurrent});
-         auto gAvg = GetGain(newpadNumber, point->GetCharge()); // get average gain
+         auto newpadNumber = grid.fPads[i * Items + j];
+         auto gAvg = newpadNumber < 0 ? 0 : GetGain(newpadNumber, point->GetCharge()); // get average gain
 
-         if (newpadNumber < 0 || newpadNumber >= numPads || gAvg == 0) {
+         if (gAvg == 0) {
             LOG(debug) << "Skipping electron...";
             fSkippy++;
             continue;
          }
 
-         Double_t ChargeDispersed = ChargeDispersion(gAvg, eTime, xElectron, yElectron, xPadCurrent, yPadCurrent);
+         Double_t ChargeDispersed = gAvg / 4 * xFrac[i] * yFrac[j];
          fPadCharge[newpadNumber]->Fill(eTime, ChargeDispersed);
          fPadsWithCharge.insert(newpadNumber);
       }
    }
 
-   if (padNumber < 0 || padNumber >= numPads) {
+   if (padNumber < 0 || padNumber >= fMap->GetNumPads()) {
       LOG(debug) << "Skipping electron...";
       return false;
    }
@@ -11,6 +11,7 @@
 #include "AtPulse.h"
 #include "AtRawEvent.h" // for AtRawEvent
 
+#include <Math/Point2D.h> // for XYPoint
 #include <Rtypes.h>
 
 #include <memory> // for make_shared, shared_ptr
@@ -32,8 +33,18 @@ private:
 
    int fSkippy = 0; // keeps track Number of skipped charge disprsion points that have hit our veto pads
 
+   /// Center of a pad and the pad numbers of the Items x Items grid around it (-1 if off the pad plane)
+   struct PadGrid {
+      ROOT::Math::XYPoint fCenter;
+      std::vector<Int_t> fPads;
+   };
+   std::vector<PadGrid> fPadGrid; //! Cached grid around each pad, indexed by pad number
+
 protected:
    Double_t ChargeDispersion(Double_t G, Double_t time, Double_t x0, Double_t y0, Double_t xi, Double_t yi);
+   Double_t GetSigma(Double_t time) const;
+   const PadGrid &GetPadGrid(Int_t padNum);
+   static Double_t FastErf(Double_t x);
    virtual bool AssignElectronsToPad(AtSimulatedPoint *point) override;
 
 public:
@@ -41,7 +52,12 @@ public:
 
    ~AtPulseGADGET() = default;
    void SetSigmaPercent(Float_t sigma) { SigmaPercent = sigma; }
-   void SetAdjecentPads(Int_t pads) { AdjecentPads = pads; };
+   void SetAdjecentPads(Int_t pads)
+   {
+      AdjecentPads = pads;
+      Items = 2 * AdjecentPads + 1;
+      fPadGrid.clear();
+   };
 
    virtual AtRawEvent GenerateEvent(std::vector<AtSimulatedPoint *> &vec) override; //!< Executed for each event.
    virtual std::shared_ptr<AtPulse> Clone() const override { return std::make_shared<AtPulseGADGET>(*this); }
@@ -1,6 +1,7 @@
 #include "AtPulseLine.h"
 
 #include "AtMap.h"
+#include "AtPadIntegrator.h"
 #include "AtSimulatedLine.h"
 #include "AtSimulatedPoint.h"
 
@@ -16,6 +17,7 @@
 #include <TRandom.h>
 
 #include <algorithm> // for copy
+#include <cmath>     // for lround, abs
 #include <memory>
 #include <numeric>
 #include <set> // for set
@@ -31,6 +33,13 @@ AtPulseLine::AtPulseLine(AtMapPtr map, ResponseFunc response) : AtPulse(map, res
    LOG(debug) << "Constructor of AtPulseLineTask";
 }
 
+void AtPulseLine::UseAnalyticIntegration(bool val)
+{
+   fUseAnalyticIntegration = val;
+   if (val && fPadIntegrator == nullptr)
+      fPadIntegrator = std::make_shared<AtPadIntegrator>(*fMap);
+}
+
 int AtPulseLine::throwRandomAndGetPadAfterDiffusion(const ROOT::Math::XYZVector &loc, double diffusionSigma)
 {
    auto r = gRandom->Gaus(0, diffusionSigma);
@@ -43,6 +52,11 @@ int AtPulseLine::throwRandomAndGetPadAfterDiffusion(const ROOT::Math::XYZVector
 
 void AtPulseLine::generateIntegrationMap(AtSimulatedLine &line)
 {
+   if (fUseAnalyticIntegration) {
+      generateAnalyticIntegrationMap(line);
+      return;
+   }
+
    // MC the integration over the pad plane
    fXYintegrationMap.clear();
    auto loc = line.GetPosition();
@@ -63,6 +77,72 @@ void AtPulseLine::generateIntegrationMap(AtSimulatedLine &line)
       elem.second /= (double)validPoints;
 }
 
+void AtPulseLine::generateAnalyticIntegrationMap(AtSimulatedLine &line)
+{
+   fXYintegrationMap.clear();
+   auto loc = line.GetPosition();
+   double sigma = line.GetTransverseDiffusion();
+   auto padNum = fMap->GetPadNum(XYPoint(loc.x(), loc.y()));
+   if (sigma <= 0) {
+      if (padNum >= 0)
+         fXYintegrationMap[padNum] = 1;
+      return;
+   }
+
+   uint64_t key = 0;
+   bool useCache = fCacheResolution > 0 && getCacheKey(padNum, loc, sigma, key);
+   if (useCache) {
+      auto it = fIntegrationCache.find(key);
+      if (it != fIntegrationCache.end()) {
+         fXYintegrationMap.insert(it->second.begin(), it->second.end());
+         return;
+      }
+   }
+
+   // Like the MC integration, normalize to the charge landing on a pad
+   auto fractions = fPadIntegrator->Integrate(XYPoint(loc.x(), loc.y()), sigma);
+   double total = 0;
+   for (auto &[pad, frac] : fractions)
+      total += frac;
+   if (total <= 0)
+      return;
+   for (auto &[pad, frac] : fractions)
+      fXYintegrationMap[pad] = frac / total;
+
+   if (useCache) {
+      if (fIntegrationCache.size() >= fMaxCacheSize)
+         fIntegrationCache.clear();
+      fIntegrationCache.emplace(key,
+                                std::vector<std::pair<int, float>>(fXYintegrationMap.begin(), fXYintegrationMap.end()));
+   }
+}
+
+/**
+ * Packs the pad number (20 bits), the offset of loc from the pad center in x and y (14 bits each),
+ * and sigma (16 bits), in units of fCacheResolution, into key. loc and sigma are moved to the rounded
+ * values so every line with the same key gets the same result. Returns false if a value does not fit.
+ */
+bool AtPulseLine::getCacheKey(int padNum, ROOT::Math::XYZVector &loc, double &sigma, uint64_t &key)
+{
+   XYPoint center;
+   if (!fPadIntegrator->GetPadCenter(padNum, center))
+      return false;
+
+   constexpr long maxOffset = 1 << 13;
+   long dx = std::lround((loc.x() - center.X()) / fCacheResolution);
+   long dy = std::lround((loc.y() - center.Y()) / fCacheResolution);
+   long ds = std::lround(sigma / fCacheResolution);
+   if (std::abs(dx) >= maxOffset || std::abs(dy) >= maxOffset || ds <= 0 || ds >= (1 << 16) || padNum >= (1 << 20))
+      return false;
+
+   key = (static_cast<uint64_t>(padNum) << 44) | (static_cast<uint64_t>(dx + maxOffset) << 30) |
+         (static_cast<uint64_t>(dy + maxOffset) << 16) | static_cast<uint64_t>(ds);
+   loc.SetX(center.X() + dx * fCacheResolution);
+   loc.SetY(center.Y() + dy * fCacheResolution);
+   sigma = ds * fCacheResolution;
+   return true;
+}
+
 bool AtPulseLine::AssignElectronsToPad(AtSimulatedPoint *point)
 {
    auto line = dynamic_cast<AtSimulatedLine *>(point);
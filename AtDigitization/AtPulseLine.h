@@ -3,13 +3,17 @@
 
 #include "AtPulse.h" // for AtPulse::ResponseFunc, AtPulse, AtPuls...
 
+#include <cstdint> // for uint64_t
 #include <map>
 #include <memory> // for make_shared, shared_ptr
 #include <sys/types.h>
+#include <unordered_map>
+#include <utility> // for pair
 #include <vector>
 
 #include "Math/Vector3Dfwd.h"
 
+class AtPadIntegrator;
 class AtSimulatedLine;
 class AtSimulatedPoint;
 
@@ -21,6 +25,13 @@ private:
 
    std::map<int, float> fXYintegrationMap; //! xyIntegrationMap[padNum] = % of e- in event here
 
+   bool fUseAnalyticIntegration{false};
+   double fCacheResolution{0};                            //< mm, 0 disables the cache
+   size_t fMaxCacheSize{100000};                          //< Number of entries before the cache is cleared
+   std::shared_ptr<const AtPadIntegrator> fPadIntegrator; //! Built by UseAnalyticIntegration, shared between clones
+   /// Analytic integration maps indexed by the key from getCacheKey
+   std::unordered_map<uint64_t, std::vector<std::pair<int, float>>> fIntegrationCache; //!
+
 public:
    AtPulseLine(AtMapPtr map, ResponseFunc response = nullptr);
    AtPulseLine(const AtPulseLine &other) = default;
@@ -29,10 +40,27 @@ public:
    void SetNumSigmaToIntegrateZ(ushort zScore) { fNumSigmaToIntegrateZ = zScore; }
    uint GetNumIntegrationPoints() { return fNumIntegrationPoints; }
    ushort SetNumSigmaToIntegrateZ() { return fNumSigmaToIntegrateZ; }
+
+   /**
+    * Integrate the transverse diffusion over the pads with AtPadIntegrator instead of throwing
+    * fNumIntegrationPoints random points. This is deterministic and does not depend on the number
+    * of integration points. The pad geometry is read from the map here, so this must be called
+    * before the pulse is cloned for the clones to share it.
+    */
+   void UseAnalyticIntegration(bool val = true);
+   /**
+    * Cache the analytic integration by pad, offset of the line from the pad center, and diffusion,
+    * all rounded to resolution (mm). Worth it when many lines share a position (e.g. a fixed beam
+    * axis), but introduces an error of order resolution/sigma in the fractions. 0 disables it.
+    */
+   void SetCacheResolution(double resolution) { fCacheResolution = resolution; }
+   void SetMaxCacheSize(size_t size) { fMaxCacheSize = size; }
    virtual std::shared_ptr<AtPulse> Clone() const override { return std::make_shared<AtPulseLine>(*this); }
 
 protected:
    void generateIntegrationMap(AtSimulatedLine &line);
+   void generateAnalyticIntegrationMap(AtSimulatedLine &line);
+   bool getCacheKey(int padNum, ROOT::Math::XYZVector &loc, double &sigma, uint64_t &key);
    int throwRandomAndGetPadAfterDiffusion(const ROOT::Math::XYZVector &loc, double diffusionSigma);
 
    // Returns the bin ID (binMin) that the zIntegral starts from
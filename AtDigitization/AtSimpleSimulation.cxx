@@ -15,11 +15,13 @@
 #include <TObject.h> // for TObject
 
 #include <cmath>     // for sqrt
+#include <memory>    // for make_shared
 #include <stdexcept> // for invalid_argument
 #include <utility>   // for pair
 
 thread_local TClonesArray AtSimpleSimulation::fMCPoints("AtMCPoint");
 thread_local int AtSimpleSimulation::fTrackID = 0;
+std::mutex AtSimpleSimulation::fGeoMutex;
 
 using SpaceChargeModel = std::shared_ptr<AtSpaceChargeModel>;
 using ModelPtr = std::shared_ptr<AtTools::AtELossModel>;
@@ -40,6 +42,14 @@ AtSimpleSimulation::AtSimpleSimulation()
       LOG(fatal) << "No geometry file loaded!";
 }
 
+std::shared_ptr<AtSimpleSimulation> AtSimpleSimulation::Clone() const
+{
+   auto sim = std::make_shared<AtSimpleSimulation>(*this);
+   if (fSCModel)
+      sim->fSCModel = fSCModel->Clone();
+   return sim;
+}
+
 bool AtSimpleSimulation::ParticleID::operator<(const ParticleID &other) const
 {
    if (A < other.A) {
@@ -45,7 +45,7 @@ protected:
    std::map<ParticleID, ModelPtr> fModels;
    SpaceChargeModel fSCModel{nullptr};
    double fDistStep{1.}; // Distance step in mm for particles
-   std::mutex fGeoMutex;
+   static std::mutex fGeoMutex; //< gGeoManager is shared by every copy
 
    // Variables to across an entire event
    static thread_local int fTrackID;
@@ -67,6 +67,12 @@ public:
 
    void NewEvent();
 
+   /**
+    * Copy of this simulation with its own copy of the space charge model, so the copies can
+    * simulate events on different threads. The energy loss models are shared.
+    */
+   std::shared_ptr<AtSimpleSimulation> Clone() const;
+
    /**
     * Simulates a particle over a given distance and returns the position and momentum of the particle at the stoping
     * point. Uses Z and A to provide a model to the protected version of SimulateParticle (see below for more
@@ -60,7 +60,7 @@ void AtSpaceChargeTask::Exec(Option_t *opt)
 
    for (int i = 0; i < fMCPointArray->GetEntries(); ++i) {
       auto mcPoint = dynamic_cast<AtMCPoint *>(fMCPointArray->At(i));
-      if (mcPoint->GetVolName() == "drift_volume")
+      if (mcPoint->GetVolID() == AtMCPoint::kDriftVolume)
          processPoint(mcPoint);
       else
          LOG(info) << "Skipping point " << i << ". Not in drift volume.";
@@ -7,16 +7,14 @@
 #include "AtRawEvent.h"
 
 #include <Rtypes.h>
-#include <TMatrixDfwd.h>
-#include <TMatrixT.h>
 #include <TString.h>
 
 #include <algorithm>
 #include <array>
 #include <cmath>
-#include <cstring>
 #include <iostream>
 #include <string>
+#include <vector>
 
 ClassImp(AtTrigger)
 
@@ -102,99 +100,96 @@ Bool_t AtTrigger::ImplementTrigger(AtRawEvent *rawEvent, AtEvent *event)
    fRawEvent = rawEvent;
    fTrigger = kFALSE;
 
-   TMatrixD triggerSignal(10, 512); // The trigger signal is a vector with 522 positions. The first 10 one will be
-                                    // filled with CoBo number and the rest will be the trigger signal. [(0,10),(0,512)]
-   TMatrixD result(10, 512);
+   constexpr int numCobo = 10;
+   constexpr int numTb = 512;
+   constexpr int numPads = sizeof(fCoboNumArray) / sizeof(fCoboNumArray[0]);
+
+   // Look up pads by number and find the last hit on each pad. A pad's trigger signal overwrites the one
+   // already in the CoBo, so pads are processed once each in the order of their last hit.
+   std::vector<AtPad *> padsByNum(numPads, nullptr);
+   for (auto &pad : fRawEvent->GetPads())
+      if (pad->GetPadNum() >= 0 && pad->GetPadNum() < numPads)
+         padsByNum[pad->GetPadNum()] = pad.get();
+
+   const auto &hits = fEvent->GetHits();
+   std::vector<Int_t> lastHit(numPads, -1);
+   for (Int_t iHit = 0; iHit < hits.size(); ++iHit) {
+      Int_t padNum = hits[iHit]->GetPadNum();
+      if (padNum >= 0 && padNum < numPads)
+         lastHit[padNum] = iHit;
+   }
 
-   Int_t numHits = fEvent->GetNumHits();
+   std::array<std::array<Double_t, numTb>, numCobo> triggerSignal{};
+   std::array<bool, numCobo> coboHit{};
 
-   // Loop over the NUMBER of SIGNALS in the EVENT
-   for (Int_t iHit = 0; iHit < numHits; iHit++) {
-      fHit = *fEvent->GetHits().at(iHit);
-      Int_t PadNumHit = fHit.GetPadNum();
+   for (Int_t iHit = 0; iHit < hits.size(); ++iHit) {
+      fPadNum = hits[iHit]->GetPadNum();
+      if (fPadNum < 0 || fPadNum >= numPads || lastHit[fPadNum] != iHit)
+         continue;
 
-      fPad = fRawEvent->GetPad(PadNumHit);
+      fPad = padsByNum[fPadNum];
       if (fPad == nullptr)
          continue;
-
-      auto fRawAdc = fPad->GetADC();
-      fPadNum = fPad->GetPadNum();
+      fCobo = fCoboNumArray[fPadNum];
+      if (fCobo < 0 || fCobo >= numCobo)
+         continue;
 
       //*************************************************************************************************
       // Calculation of the trigger signal for the given event.
       // Any time the input signal rises above the threshold value, a trigger signal is generated by the AGET for the
       // corresponding channel.
       //*************************************************************************************************
-
-      double trigSignal[512]; // Empty Trigger Signal for each signal of the event
+      const auto &rawAdc = fPad->GetADC();
+      std::array<Double_t, numTb> trigSignal{};
       fTbIdx = 0;
-      memset(trigSignal, 0, sizeof(trigSignal));
-
-      while (fTbIdx < 512) {
-         if (fRawAdc[fTbIdx] > fPad_threshold) {
-            for (Int_t ii = fTbIdx; ii < std::min(fTbIdx + fTrigger_width, 512.); ii++) {
+      while (fTbIdx < numTb) {
+         if (rawAdc[fTbIdx] > fPad_threshold) {
+            for (Int_t ii = fTbIdx; ii < std::min(fTbIdx + fTrigger_width, double(numTb)); ii++)
                trigSignal[ii] += fTrigger_height;
-            }
-            fTbIdx += fTrigger_width;
-
-         }
-
-         else
+            fTbIdx = std::max<Int_t>(fTbIdx + fTrigger_width, fTbIdx + 1);
+         } else
             fTbIdx += 1;
+      }
 
-      } // While
-
-      fCobo = fCoboNumArray[fPadNum];
-
-      for (Int_t j = 0; j < 512; j++) {
-
-         if (trigSignal[j] > 0) {
-            // std::cout<< "TrigSignal: "<< trigSignal[j] << std::endl;
-            triggerSignal(fCobo, j) = trigSignal[j];
-         } // Positive signal if
-
-      } // 3rd foor loop
-      triggerSignal(fCobo, 0) = fCobo;
-
-      //*******************************************************************************************************************************
-      // Calculation of the multiplicity signals from the trigger signals.
-      // Each AGET sums the trigger signals from its channels and outputs this trigger multiplicity to the ADC.
-      // Then the CoBo sums this digitalized multiplicity signals from the AGETs and integrates this signal over a
-      // sliding time window. The input of this part will be the triggerSignals calculated before, and the output will
-      // be the multiplicity signals.
-      //********************************************************************************************************************************
-
-      for (Int_t l = 0; l < 512; l++) {
-         Int_t triggerWindow = l - fTime_window;
-         fMinIdx = std::max(0, triggerWindow);
-         fMaxIdx = l;
+      for (Int_t j = 0; j < numTb; j++)
+         if (trigSignal[j] > 0)
+            triggerSignal[fCobo][j] = trigSignal[j];
+      coboHit[fCobo] = true;
+   }
 
-         for (Int_t ll = 0; ll < 10; ll++) {
-            fAccum = 0;
-            result(ll, 0) = fCobo;
-            for (Int_t jj = fMinIdx; jj < fMaxIdx; jj++) {
-               fAccum += triggerSignal(ll, jj);
-            }
-            result(ll, l) = fAccum * fTime_factor;
+   //*******************************************************************************************************************************
+   // Calculation of the multiplicity signals from the trigger signals.
+   // Each AGET sums the trigger signals from its channels and outputs this trigger multiplicity to the ADC.
+   // Then the CoBo sums this digitalized multiplicity signals from the AGETs and integrates this signal over a
+   // sliding time window [l - fTime_window, l), taken here from a prefix sum of the trigger signal.
+   // The first time bucket of the trigger signal holds the CoBo number, and the multiplicity is accumulated
+   // as an integer so each time bucket contributes its truncated value.
+   //********************************************************************************************************************************
+   std::array<Int_t, numTb + 1> prefix{};
+
+   for (fCobo = 0; fCobo < numCobo; ++fCobo) {
+      if (!coboHit[fCobo])
+         continue;
 
-         } // ll for
+      // The first bin of the multiplicity signal also holds the CoBo number
+      if (fCobo > fMultiplicity_threshold)
+         return fTrigger = kTRUE;
 
-      } // l for
+      prefix[1] = fCobo;
+      for (Int_t tb = 1; tb < numTb; ++tb)
+         prefix[tb + 1] = prefix[tb] + static_cast<Int_t>(triggerSignal[fCobo][tb]);
 
       //*************************************************************************************************
       // Determines if the given multiplicity signals rose above the multiplicity threshold in any CoBo.
       //*************************************************************************************************
-
-      for (Int_t kk = 0; kk < 10; kk++) {
-         if (kk == fCobo) {
-            for (Int_t k = 0; k < 512; k++) {
-               if (result(kk, k) > fMultiplicity_threshold) {
-                  fTrigger = kTRUE;
-               }
-            }
-         }
+      for (Int_t l = 1; l < numTb; ++l) {
+         fMinIdx = std::max(0, static_cast<Int_t>(l - fTime_window));
+         fMaxIdx = l;
+         fAccum = fMinIdx < fMaxIdx ? prefix[fMaxIdx] - prefix[fMinIdx] : 0;
+         if (fAccum * fTime_factor > fMultiplicity_threshold)
+            return fTrigger = kTRUE;
       }
+   }
 
-   } // Loop on entries of the event
    return fTrigger;
 }
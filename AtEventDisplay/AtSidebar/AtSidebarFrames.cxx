@@ -131,8 +131,10 @@ AtSidebarEventControl::~AtSidebarEventControl()
 
 void AtSidebarEventControl::Update(DataHandling::AtSubject *changedSubject)
 {
-   if (changedSubject == &fEntryNumber && fCurrentEventEntry)
+   if (changedSubject == &fEntryNumber && fCurrentEventEntry) {
       fCurrentEventEntry->SetIntNumber(fEntryNumber.Get());
+      fLoadTimeLabel->SetText(TString::Format(fLoadTimeString, fEntryNumber.GetLoadTime()));
+   }
 }
 
 void AtSidebarEventControl::SelectEvent()
@@ -188,6 +190,9 @@ void AtSidebarEventControl::FillFrame()
       fButtonFrame->AddFrame(fRerunButton, new TGLayoutHints(kLHintsCenterY, 1, 1, 1, 1));
    }
    this->AddFrame(fButtonFrame, new TGLayoutHints(kLHintsCenterX));
+
+   fLoadTimeLabel = new TGLabel(this, TString::Format(fLoadTimeString, 0.));
+   this->AddFrame(fLoadTimeLabel, new TGLayoutHints(kLHintsCenterX | kLHintsExpandX));
 }
 
 AtSidebarBranchControl::AtSidebarBranchControl(DataHandling::AtBranch &rawEvent, DataHandling::AtBranch &event,
@@ -119,8 +119,10 @@ private:
    TGLabel *fCurrentEventLabel{nullptr};
    TGNumberEntry *fCurrentEventEntry{nullptr};
    TGTextButton *fRerunButton{nullptr};
+   TGLabel *fLoadTimeLabel{nullptr};
 
    TGHorizontalFrame *fButtonFrame{nullptr};
+   static constexpr char fLoadTimeString[] = "Load time: %.1f ms";
 
 public:
    AtSidebarEventControl(DataHandling::AtTreeEntry &entryNum, const TGWindow *p = nullptr, UInt_t w = 1, UInt_t h = 1,
@@ -34,6 +34,7 @@
 #include <TH2Poly.h>             // for TH2Poly
 #include <TNamed.h>              // for TNamed
 #include <TObject.h>             // for TObject
+#include <TQObject.h>            // for gTQSender
 #include <TRootEmbeddedCanvas.h> // for TRootEmbeddedCanvas
 #include <TString.h>             // for Form, TString
 #include <TStyle.h>              // for TStyle, gStyle
@@ -172,6 +173,15 @@ void AtTabMain::DrawPadPlane()
    gStyle->SetOptStat(0);
    gStyle->SetPalette(103);
    gPad->Update();
+
+   // Cache the bin of every pad so the pad plane can be filled without searching for the bin
+   auto map = AtViewerManager::Instance()->GetMap();
+   fPadToBin.assign(map->GetNumPads(), -1);
+   for (int bin = 1; bin <= fPadPlane->GetNumberOfBins(); ++bin) {
+      auto padNum = map->BinToPad(bin);
+      if (padNum >= 0 && padNum < fPadToBin.size())
+         fPadToBin[padNum] = bin;
+   }
 }
 
 void AtTabMain::DrawPadWave()
@@ -277,11 +287,18 @@ void AtTabMain::UpdatePadPlane()
    auto &hits = fEvent->GetHits();
 
    for (auto &hit : hits) {
-      int padMultiHit = GetFairRootInfo<AtEvent>()->GetHitPadMult(hit->GetPadNum());
+      auto padNum = hit->GetPadNum();
+      int padMultiHit = fEvent->GetHitPadMult(padNum);
       if (hit->GetCharge() < fThreshold || padMultiHit > fMaxHitMulti)
          continue;
-      auto position = hit->GetPosition();
-      fPadPlane->Fill(position.X(), position.Y(), hit->GetCharge());
+
+      if (padNum >= 0 && padNum < fPadToBin.size() && fPadToBin[padNum] > 0) {
+         auto bin = fPadToBin[padNum];
+         fPadPlane->SetBinContent(bin, fPadPlane->GetBinContent(bin) + hit->GetCharge());
+      } else {
+         auto position = hit->GetPosition();
+         fPadPlane->Fill(position.X(), position.Y(), hit->GetCharge());
+      }
    }
 
    fCvsPadPlane->Modified();
@@ -292,20 +309,27 @@ void AtTabMain::SetPointsFromHits(TEvePointSet &hitSet, const std::vector<std::u
    SetPointsFromHits(hitSet, ContainerManip::GetPointerVector(hits));
 }
 
+/**
+ * Hits are stored in the point set with their index as an integer ID. The TNamed used to label
+ * the point is only created when the point is picked (see PointSelected).
+ */
 void AtTabMain::SetPointsFromHits(TEvePointSet &hitSet, const std::vector<AtHit *> &hits)
 {
    Int_t nHits = hits.size();
+   Int_t stride = GetDrawStride(nHits);
 
-   hitSet.Reset(nHits);
+   hitSet.Reset(nHits / stride + 1, 1);
    hitSet.SetOwnIds(true);
    fHitAttr.Copy(hitSet); // Copy attributes from fHitAttr into hitSet.
+   ConnectPointSelected(hitSet);
 
-   for (Int_t iHit = 0; iHit < nHits; iHit++) {
+   auto event = GetFairRootInfo<AtEvent>();
+   for (Int_t iHit = 0; iHit < nHits; iHit += stride) {
 
       auto &hit = *hits.at(iHit);
       Int_t PadMultHit = 0;
-      if (GetFairRootInfo<AtEvent>())
-         PadMultHit = GetFairRootInfo<AtEvent>()->GetHitPadMult(hit.GetPadNum());
+      if (event)
+         PadMultHit = event->GetHitPadMult(hit.GetPadNum());
 
       if (hit.GetCharge() < fThreshold || PadMultHit > fMaxHitMulti)
          continue;
@@ -313,7 +337,7 @@ void AtTabMain::SetPointsFromHits(TEvePointSet &hitSet, const std::vector<AtHit
       auto position = hit.GetPosition();
 
       hitSet.SetNextPoint(position.X() / 10., position.Y() / 10., position.Z() / 10.); // Convert into cm
-      hitSet.SetPointId(new TNamed(Form("Hit %d", iHit), ""));
+      hitSet.SetPointIntIds(&iHit);
    }
 
    gEve->ElementChanged(&hitSet);
@@ -322,11 +346,13 @@ void AtTabMain::SetPointsFromHits(TEvePointSet &hitSet, const std::vector<AtHit
 void AtTabMain::SetPointsFromTrack(TEvePointSet &hitSet, const AtTrack &track)
 {
    Int_t nHits = track.GetHitArray().size();
+   Int_t stride = GetDrawStride(nHits);
 
-   hitSet.Reset(nHits);
+   hitSet.Reset(nHits / stride + 1, 1);
    hitSet.SetOwnIds(true);
+   ConnectPointSelected(hitSet);
 
-   for (Int_t i = 0; i < nHits; i++) {
+   for (Int_t i = 0; i < nHits; i += stride) {
 
       auto &hit = *track.GetHitArray()[i];
 
@@ -335,12 +361,40 @@ void AtTabMain::SetPointsFromTrack(TEvePointSet &hitSet, const AtTrack &track)
 
       auto position = hit.GetPosition();
       hitSet.SetNextPoint(position.X() / 10., position.Y() / 10., position.Z() / 10.); // Convert into cm
-      hitSet.SetPointId(new TNamed(Form("Hit %d", i), ""));
+      hitSet.SetPointIntIds(&i);
    }
 
    gEve->ElementChanged(&hitSet);
 }
 
+/**
+ * Get the step through a hit set of size nHits so that at most about fMaxHitsDrawn hits are drawn.
+ */
+Int_t AtTabMain::GetDrawStride(Int_t nHits)
+{
+   if (fMaxHitsDrawn <= 0 || nHits <= fMaxHitsDrawn)
+      return 1;
+   return (nHits + fMaxHitsDrawn - 1) / fMaxHitsDrawn;
+}
+
+void AtTabMain::ConnectPointSelected(TEvePointSet &hitSet)
+{
+   if (!hitSet.HasConnection("PointSelected(Int_t)"))
+      hitSet.Connect("PointSelected(Int_t)", "AtTabMain", this, "PointSelected(Int_t)");
+}
+
+void AtTabMain::PointSelected(Int_t id)
+{
+   auto hitSet = dynamic_cast<TEvePointSet *>(static_cast<TQObject *>(gTQSender));
+   if (hitSet == nullptr || id < 0 || id >= hitSet->Size())
+      return;
+
+   Int_t hitIdx = hitSet->GetPointIntIds(id)[0];
+   if (hitSet->GetPointId(id) == nullptr)
+      hitSet->SetPointId(id, new TNamed(Form("Hit %d", hitIdx), ""));
+   LOG(info) << "Selected hit " << hitIdx << " in " << hitSet->GetElementName();
+}
+
 bool AtTabMain::DrawWave(Int_t PadNum)
 {
    fPadWave->Reset();
@@ -46,11 +46,13 @@ protected:
 
    Int_t fThreshold{0};    //< Min charge to draw hit
    Int_t fMaxHitMulti{10}; //< Max hits in a pad for hit to be drawn
+   Int_t fMaxHitsDrawn{0}; //< If >0, hit sets larger than this are downsampled to about this many points
 
    TAttMarker fHitAttr{kPink, kFullDotMedium, 1};
 
    TCanvas *fCvsPadPlane{nullptr};
    TH2Poly *fPadPlane{nullptr};
+   std::vector<Int_t> fPadToBin; //< Bin in fPadPlane for each pad number (-1 if not in pad plane)
 
    TCanvas *fCvsPadWave{nullptr};
    TH1I *fPadWave{nullptr};
@@ -73,6 +75,8 @@ public:
    void SetThreshold(Int_t val) { fThreshold = val; }
    void SetHitAttributes(TAttMarker attr) { fHitAttr = std::move(attr); }
    void SetMultiHit(Int_t hitMax) { fMaxHitMulti = hitMax; }
+   /// Set the maximum number of points to draw in a hit set. Larger sets are downsampled (0 draws every hit).
+   void SetMaxHitsDrawn(Int_t maxHits) { fMaxHitsDrawn = maxHits; }
 
    /**
     * This function is responsible for selecting the pad we are currently examining and passing
@@ -80,6 +84,9 @@ public:
     */
    static void SelectPad();
 
+   /// Slot called when a point in one of the hit sets is picked. Creates the label of the hit on demand.
+   void PointSelected(Int_t id);
+
 protected:
    void MakeTab(TEveWindowSlot *slot) override;
 
@@ -89,6 +96,8 @@ protected:
    void SetPointsFromHits(TEvePointSet &hitSet, const std::vector<std::unique_ptr<AtHit>> &hits);
    void SetPointsFromHits(TEvePointSet &hitSet, const std::vector<AtHit *> &hits);
    void SetPointsFromTrack(TEvePointSet &hitSet, const AtTrack &track);
+   void ConnectPointSelected(TEvePointSet &hitSet);
+   Int_t GetDrawStride(Int_t nHits);
 
 private:
    // Functions to draw the initial canvases
@@ -14,8 +14,9 @@
 
 #include <FairLogger.h>
 
+#include <Rtypes.h> // for kRed
 #include <TCanvas.h>
-#include <TF1.h>
+#include <TGraph.h>
 #include <TH1.h> // for TH1D
 
 #include <iostream> // for operator<<, basic_ostream::operator<<
@@ -184,10 +185,14 @@ void AtTabPad::DrawArrayAug(TH1D *hist, const AtPad &pad, TString augName)
    hist->Draw();
 }
 
-void AtTabPad::DrawHit(const AtPad &pad, TF1Vec &vec)
+void AtTabPad::DrawHit(const AtPad &pad, GraphVec &vec)
 {
    vec.clear();
 
+   // Number of points and sigma to draw of each hit
+   constexpr int numPoints = 101;
+   constexpr double numSigma = 5;
+
    // Loop through all hits and
    auto event = GetFairRootInfo<AtEvent>();
    for (auto &hit : event->GetHits()) {
@@ -196,14 +201,24 @@ void AtTabPad::DrawHit(const AtPad &pad, TF1Vec &vec)
 
       LOG(debug) << "Drawing hit with charge " << hit->GetCharge();
       LOG(debug) << hit->GetPosition().Z() << " " << hit->GetPositionSigma().Z();
-      auto func = AtTools::GetHitFunctionTB(*hit);
-      if (func != nullptr)
-         vec.push_back(std::move(func));
+      auto kernel = AtTools::GetHitKernelTB(*hit);
+      if (!kernel.IsValid())
+         continue;
+
+      auto graph = std::make_unique<TGraph>(numPoints);
+      auto step = 2 * numSigma * kernel.fSigma / (numPoints - 1);
+      for (int i = 0; i < numPoints; ++i) {
+         auto tb = kernel.fMean - numSigma * kernel.fSigma + i * step;
+         graph->SetPoint(i, tb, kernel.Eval(tb));
+      }
+      graph->SetLineColor(kRed);
+      graph->SetLineWidth(2);
+      vec.push_back(std::move(graph));
    }
 
-   for (auto &func : vec) {
+   for (auto &graph : vec) {
       LOG(debug) << "Drawing hit function";
-      func->Draw("SAME");
+      graph->Draw("L");
    }
 }
 std::string AtTabPad::GetName(int pos, PadDrawType type)
@@ -226,7 +241,7 @@ void AtTabPad::SetDraw(Int_t pos, PadDrawType type)
 
 void AtTabPad::DrawHits(int row, int col)
 {
-   fDrawHits[row * fCols + col] = TF1Vec();
+   fDrawHits[row * fCols + col] = GraphVec();
 }
 void AtTabPad::DrawADC(int row, int col)
 {
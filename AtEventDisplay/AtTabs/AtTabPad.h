@@ -18,7 +18,7 @@ class TEveWindowSlot;
 class TBuffer;
 class TClass;
 class TMemberInspector;
-class TF1;
+class TGraph;
 class AtPad;
 class TH1D;
 
@@ -33,7 +33,7 @@ class AtSubject;
 class AtTabPad : public AtTabCanvas, public DataHandling::AtObserver {
 protected:
    enum class PadDrawType { kADC, kRawADC, kArrAug, kAuxPad, kFPN };
-   using TF1Vec = std::vector<std::unique_ptr<TF1>>;
+   using GraphVec = std::vector<std::unique_ptr<TGraph>>;
 
    /// <location, <type, histo>
    /// location is row * nCols + col
@@ -41,7 +41,7 @@ protected:
    std::unordered_map<Int_t, std::string> fAugNames;                   //< Augment and Aux pad names
    DataHandling::AtPadNum *fPadNum;
 
-   std::unordered_map<Int_t, TF1Vec> fDrawHits; //< Draw representation of hits on trace in these TPads
+   std::unordered_map<Int_t, GraphVec> fDrawHits; //< Draw representation of hits on trace in these TPads
 
 public:
    AtTabPad(int nRow = 1, int nCol = 1, TString name = "AtPad");
@@ -72,7 +72,7 @@ private:
    void DrawFPN(TH1D *hist, const AtPad &pad);
    void DrawRawAdc(TH1D *hist, const AtPad &pad);
    void DrawArrayAug(TH1D *hist, const AtPad &pad, TString augName);
-   void DrawHit(const AtPad &pad, TF1Vec &funcs);
+   void DrawHit(const AtPad &pad, GraphVec &graphs);
    // void DrawHit(TPad *canv, const AtHit &hit);
 
    void UpdateCvsPad();
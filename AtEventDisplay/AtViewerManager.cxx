@@ -4,6 +4,7 @@
 #include "AtRawEvent.h"
 #include "AtSidebarFrames.h"
 #include "AtTabBase.h" // for AtTabBase
+#include "AtViewerPrefetcher.h"
 
 #include <FairLogger.h>      // for Logger, LOG
 #include <FairRootManager.h> // for FairRootManager
@@ -114,6 +115,12 @@ void AtViewerManager::Init()
       LOG(fatal) << "Cannot find RootManager!";
    }
 
+   if (fCheckGood && fNumPrefetch > 0) {
+      fPrefetcher = std::make_unique<AtViewerPrefetcher>(fCheckEvt->GetBranch().GetBranchName(), fNumPrefetch);
+      if (!fPrefetcher->IsValid())
+         fPrefetcher.reset();
+   }
+
    GotoEvent(0);
    std::cout << "End of AtViewerManager" << std::endl;
 }
@@ -168,28 +175,38 @@ void AtViewerManager::GotoEventImpl()
 void AtViewerManager::Update(DataHandling::AtSubject *subject)
 {
    if (subject == &fEntry) {
+      if (fPrefetcher)
+         fPrefetcher->SetCenter(fEntry.Get());
       GotoEventImpl();
    }
 }
 
 void AtViewerManager::NextEvent()
 {
-   while (true) {
-      GotoEvent(fEntry.Get() + 1);
-      if (fCheckGood == false) {
-         return;
-      } else if (fCheckEvt->GetInfo()->IsGood())
-         return;
-   }
+   MoveEvent(1);
 }
 
 void AtViewerManager::PrevEvent()
 {
+   MoveEvent(-1);
+}
+
+/**
+ * Go to the next good event in the direction dir. Entries the prefetcher already knows are bad are
+ * skipped without being loaded.
+ */
+void AtViewerManager::MoveEvent(int dir)
+{
+   long entry = fEntry.Get();
    while (true) {
-      GotoEvent(fEntry.Get() - 1);
+      entry = fPrefetcher ? fPrefetcher->NextCandidate(entry, dir) : entry + dir;
+      if (entry < 0)
+         return;
+
+      GotoEvent(entry);
       if (fCheckGood == false) {
          return;
-      } else if (fCheckEvt->GetInfo()->IsGood())
+      } else if (fCheckEvt->GetInfo() && fCheckEvt->GetInfo()->IsGood())
          return;
    }
 }
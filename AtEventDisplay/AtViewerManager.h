@@ -16,6 +16,7 @@
 class AtEventSidebar;
 class AtMap;            // lines 29-29
 class AtTabBase;        // lines 31-31
+class AtViewerPrefetcher;
 class FairTask;         // lines 19-19
 class TBuffer;          // lines 20-20
 class TClass;           // lines 23-23
@@ -50,6 +51,8 @@ private:
 
    bool fCheckGood{false}; //< Check if the event is good and skip if not when using next and prev
    std::unique_ptr<AtTabInfoFairRoot<AtRawEvent>> fCheckEvt{nullptr};
+   Int_t fNumPrefetch{0};                          //< Number of entries around the current one to check in background
+   std::unique_ptr<AtViewerPrefetcher> fPrefetcher; //!
 
    static AtViewerManager *fInstance;
 
@@ -79,6 +82,12 @@ public:
       fCheckGood = true;
       fCheckEvt = std::make_unique<AtTabInfoFairRoot<AtRawEvent>>(branch);
    }
+   /**
+    * Check if the numEntries events before and after the current one are good on a background thread
+    * so NextEvent and PrevEvent can jump directly to the next good event. Requires the check branch
+    * to be in the input file. Must be called before Init().
+    */
+   void SetPrefetch(Int_t numEntries) { fNumPrefetch = numEntries; }
 
    /**
     * Main function for navigating to an event. Everything that changes event number should end up
@@ -93,6 +102,7 @@ public:
 private:
    void GenerateBranchLists();
    void GotoEventImpl();
+   void MoveEvent(int dir);
 
    ClassDef(AtViewerManager, 1);
 };
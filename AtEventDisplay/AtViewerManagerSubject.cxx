@@ -5,12 +5,17 @@
 
 #include <Rtypes.h>
 #include <TString.h>
+
+#include <chrono>
 namespace DataHandling {
 
 void AtTreeEntry::Set(long entry)
 {
    fEntry = entry;
+   auto start = std::chrono::high_resolution_clock::now();
    FairRunAna::Instance()->Run((Long64_t)fEntry);
+   auto stop = std::chrono::high_resolution_clock::now();
+   fLoadTime = std::chrono::duration<double, std::milli>(stop - start).count();
    Notify();
 }
 
@@ -17,11 +17,14 @@ namespace DataHandling {
 class AtTreeEntry : public AtSubject {
 protected:
    long fEntry;
+   double fLoadTime{0}; //< Time to run the last entry (ms)
 
 public:
    AtTreeEntry(long data) { fEntry = data; }
    long Get() const { return fEntry; }
    void Set(long entry);
+   /// Time (ms) it took to read and run the tasks on the current entry
+   double GetLoadTime() const { return fLoadTime; }
 };
 
 /**
@@ -0,0 +1,115 @@
+#include "AtViewerPrefetcher.h"
+
+#include "AtBaseEvent.h" // for AtBaseEvent
+
+#include <FairLogger.h>      // for LOG, Logger
+#include <FairRootManager.h> // for FairRootManager
+
+#include <TChain.h>
+#include <TChainElement.h>
+#include <TClonesArray.h>
+#include <TCollection.h> // for TIter
+#include <TObjArray.h>
+#include <TROOT.h> // for EnableThreadSafety
+
+AtViewerPrefetcher::AtViewerPrefetcher(TString branchName, Int_t numEntries) : fNumEntries(numEntries)
+{
+   auto inChain = FairRootManager::Instance()->GetInChain();
+   if (inChain == nullptr || inChain->GetBranch(branchName) == nullptr) {
+      LOG(error) << "Cannot find " << branchName << " in the input files. Good events will not be prefetched.";
+      return;
+   }
+
+   ROOT::EnableThreadSafety();
+   fChain = std::make_unique<TChain>(inChain->GetName());
+   TIter next(inChain->GetListOfFiles());
+   while (auto element = dynamic_cast<TChainElement *>(next()))
+      fChain->Add(element->GetTitle());
+
+   // Only read the branch we need
+   fChain->SetBranchStatus("*", false);
+   fChain->SetBranchStatus(branchName + "*", true);
+   fChain->SetBranchAddress(branchName, &fArray);
+   fChain->GetEntry(0);
+   if (fArray == nullptr) {
+      LOG(error) << "Failed to read " << branchName << ". Good events will not be prefetched.";
+      return;
+   }
+
+   fStatus.assign(fChain->GetEntries(), Status::kUnknown);
+   fThread = std::thread(&AtViewerPrefetcher::Run, this);
+}
+
+AtViewerPrefetcher::~AtViewerPrefetcher()
+{
+   {
+      std::lock_guard<std::mutex> lk(fMutex);
+      fStop = true;
+   }
+   fCV.notify_all();
+   if (fThread.joinable())
+      fThread.join();
+   if (fChain)
+      fChain->ResetBranchAddresses();
+   delete fArray;
+}
+
+void AtViewerPrefetcher::SetCenter(long entry)
+{
+   {
+      std::lock_guard<std::mutex> lk(fMutex);
+      fCenter = entry;
+   }
+   fCV.notify_all();
+}
+
+AtViewerPrefetcher::Status AtViewerPrefetcher::GetStatus(long entry)
+{
+   std::lock_guard<std::mutex> lk(fMutex);
+   if (entry < 0 || entry >= fStatus.size())
+      return Status::kUnknown;
+   return fStatus[entry];
+}
+
+long AtViewerPrefetcher::NextCandidate(long entry, int dir)
+{
+   std::lock_guard<std::mutex> lk(fMutex);
+   for (entry += dir; entry >= 0 && entry < fStatus.size(); entry += dir)
+      if (fStatus[entry] != Status::kBad)
+         return entry;
+   return -1;
+}
+
+/**
+ * Get the closest entry to fCenter (checking forward first) that has not been checked yet.
+ * Returns -1 if every entry in the window is known. Expects fMutex to be locked.
+ */
+long AtViewerPrefetcher::NextToCheck()
+{
+   for (long i = 1; i <= fNumEntries; ++i)
+      for (auto entry : {fCenter + i, fCenter - i})
+         if (entry >= 0 && entry < fStatus.size() && fStatus[entry] == Status::kUnknown)
+            return entry;
+   return -1;
+}
+
+void AtViewerPrefetcher::Run()
+{
+   std::unique_lock<std::mutex> lk(fMutex);
+   while (!fStop) {
+      auto entry = NextToCheck();
+      if (entry < 0) {
+         fCV.wait(lk);
+         continue;
+      }
+
+      // Read the entry without holding the lock so navigation is never blocked on I/O
+      lk.unlock();
+      fChain->GetEntry(entry);
+      auto event = fArray->GetEntries() > 0 ? dynamic_cast<AtBaseEvent *>(fArray->At(0)) : nullptr;
+      auto status = (event != nullptr && event->IsGood()) ? Status::kGood : Status::kBad;
+      lk.lock();
+
+      fStatus[entry] = status;
+   }
+}
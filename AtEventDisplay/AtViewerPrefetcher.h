@@ -0,0 +1,67 @@
+#ifndef ATVIEWERPREFETCHER_H
+#define ATVIEWERPREFETCHER_H
+
+#include <Rtypes.h>  // for Char_t
+#include <TString.h> // for TString
+
+#include <condition_variable>
+#include <memory> // for unique_ptr
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class TChain;
+class TClonesArray;
+
+/**
+ * @brief Evaluates the good event flag of entries around the current entry on a background thread.
+ *
+ * The check branch is read through a separate TChain over the input files so it does not interfere
+ * with FairRootManager. Used by AtViewerManager to jump straight to the next or previous good event
+ * instead of running every entry in between.
+ */
+class AtViewerPrefetcher {
+public:
+   enum class Status : Char_t { kUnknown, kBad, kGood };
+
+private:
+   std::unique_ptr<TChain> fChain;
+   TClonesArray *fArray{nullptr};
+   Int_t fNumEntries; //< Number of entries before and after the current one to check
+
+   std::vector<Status> fStatus; //< Status of every entry in the chain
+   long fCenter{0};             //< Entry to check around
+   bool fStop{false};
+
+   std::mutex fMutex;
+   std::condition_variable fCV;
+   std::thread fThread;
+
+public:
+   /**
+    * @param[in] branchName Branch in the input file (derived from AtBaseEvent) to check IsGood on.
+    * @param[in] numEntries Number of entries before and after the current one to check.
+    */
+   AtViewerPrefetcher(TString branchName, Int_t numEntries);
+   ~AtViewerPrefetcher();
+
+   /// Returns false if the branch could not be found in the input files.
+   bool IsValid() const { return fArray != nullptr; }
+
+   /// Move the window of entries being checked to be centered on entry.
+   void SetCenter(long entry);
+
+   /**
+    * Get the next entry from entry in the direction dir (+1 or -1) that is not known to be bad.
+    * Returns -1 if there are no such entries in the run.
+    */
+   long NextCandidate(long entry, int dir);
+
+   Status GetStatus(long entry);
+
+private:
+   void Run();
+   long NextToCheck();
+};
+
+#endif
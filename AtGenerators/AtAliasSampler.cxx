@@ -0,0 +1,164 @@
+#include "AtAliasSampler.h"
+
+#include <FairLogger.h>
+
+#include <TAxis.h>
+#include <TH2.h>
+#include <TRandom.h>
+
+#include <cmath>   // for sqrt, abs
+#include <numeric> // for accumulate
+#include <utility> // for move
+
+AtAliasSampler::AtAliasSampler(const TH2 &hist, bool interpolate) : fInterpolate(interpolate)
+{
+   SetTable(hist);
+}
+
+void AtAliasSampler::SetTable(const TH2 &hist)
+{
+   auto getEdges = [](const TAxis *axis) {
+      std::vector<double> edges;
+      for (int i = 1; i <= axis->GetNbins() + 1; ++i)
+         edges.push_back(axis->GetBinLowEdge(i));
+      return edges;
+   };
+
+   int nx = hist.GetNbinsX();
+   int ny = hist.GetNbinsY();
+   std::vector<double> weights(nx * ny);
+   for (int iy = 0; iy < ny; ++iy)
+      for (int ix = 0; ix < nx; ++ix)
+         weights[ix + iy * nx] = hist.GetBinContent(ix + 1, iy + 1);
+
+   SetTable(std::move(weights), getEdges(hist.GetXaxis()), getEdges(hist.GetYaxis()));
+}
+
+void AtAliasSampler::SetTable(std::vector<double> weights, std::vector<double> xEdges, std::vector<double> yEdges)
+{
+   fProb.clear();
+   fAlias.clear();
+   fWeights = std::move(weights);
+   fXEdges = std::move(xEdges);
+   fYEdges = std::move(yEdges);
+
+   if (fXEdges.size() < 2 || fYEdges.size() < 2 || fWeights.size() != GetNumBinsX() * GetNumBinsY()) {
+      LOG(error) << "Table size does not match the number of bins, cannot sample from it!";
+      return;
+   }
+   for (auto &w : fWeights) {
+      if (w < 0) {
+         LOG(warn) << "Negative weight " << w << " in table set to zero.";
+         w = 0;
+      }
+   }
+
+   BuildAliasTable();
+}
+
+/// Vose's method for building the alias table.
+void AtAliasSampler::BuildAliasTable()
+{
+   auto n = fWeights.size();
+   auto total = std::accumulate(fWeights.begin(), fWeights.end(), 0.);
+   if (total <= 0) {
+      LOG(error) << "Table is empty, cannot sample from it!";
+      return;
+   }
+
+   fProb.resize(n);
+   fAlias.resize(n);
+   std::vector<int> small;
+   std::vector<int> large;
+   for (int i = 0; i < n; ++i) {
+      fProb[i] = fWeights[i] * n / total;
+      fAlias[i] = i;
+      if (fProb[i] < 1)
+         small.push_back(i);
+      else
+         large.push_back(i);
+   }
+
+   while (!small.empty() && !large.empty()) {
+      auto s = small.back();
+      auto l = large.back();
+      small.pop_back();
+
+      fAlias[s] = l;
+      fProb[l] -= 1 - fProb[s];
+      if (fProb[l] < 1) {
+         large.pop_back();
+         small.push_back(l);
+      }
+   }
+
+   // Whatever is left is 1 up to rounding
+   for (auto i : small)
+      fProb[i] = 1;
+   for (auto i : large)
+      fProb[i] = 1;
+}
+
+int AtAliasSampler::SampleBin(TRandom *rand) const
+{
+   if (!IsValid())
+      return -1;
+   if (rand == nullptr)
+      rand = gRandom;
+
+   auto u = rand->Rndm() * fProb.size();
+   int bin = u;
+   if (bin >= fProb.size())
+      bin = fProb.size() - 1;
+   return (u - bin < fProb[bin]) ? bin : fAlias[bin];
+}
+
+std::pair<double, double> AtAliasSampler::Sample(TRandom *rand) const
+{
+   if (!IsValid())
+      return {0, 0};
+   if (rand == nullptr)
+      rand = gRandom;
+
+   auto bin = SampleBin(rand);
+   int ix = bin % GetNumBinsX();
+   int iy = bin / GetNumBinsX();
+
+   double u = rand->Rndm();
+   double v = rand->Rndm();
+   if (fInterpolate) {
+      u = SampleLinear(EdgeWeight(ix, iy, -1, 0), EdgeWeight(ix, iy, 1, 0), u);
+      v = SampleLinear(EdgeWeight(ix, iy, 0, -1), EdgeWeight(ix, iy, 0, 1), v);
+   }
+
+   return {fXEdges[ix] + u * (fXEdges[ix + 1] - fXEdges[ix]), fYEdges[iy] + v * (fYEdges[iy + 1] - fYEdges[iy])};
+}
+
+/// Value of the table at the edge of bin (ix, iy) shared with bin (ix + dx, iy + dy).
+double AtAliasSampler::EdgeWeight(int ix, int iy, int dx, int dy) const
+{
+   int nx = ix + dx;
+   int ny = iy + dy;
+   if (nx < 0 || nx >= GetNumBinsX() || ny < 0 || ny >= GetNumBinsY())
+      return Weight(ix, iy);
+   return (Weight(ix, iy) + Weight(nx, ny)) / 2.;
+}
+
+/**
+ * Sample u in [0, 1) from the density that is lowWeight at 0 and highWeight at 1, given a uniform
+ * random number r, by inverting its CDF.
+ */
+double AtAliasSampler::SampleLinear(double lowWeight, double highWeight, double r)
+{
+   auto sum = lowWeight + highWeight;
+   if (sum <= 0)
+      return r;
+
+   double a = lowWeight / sum;
+   double b = highWeight / sum;
+   if (std::abs(b - a) < 1e-9)
+      return r;
+
+   // CDF(u) = 2 * a * u + (b - a) * u^2
+   return (-a + std::sqrt(a * a + (b - a) * r)) / (b - a);
+}
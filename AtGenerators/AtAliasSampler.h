@@ -0,0 +1,62 @@
+#ifndef ATALIASSAMPLER_H
+#define ATALIASSAMPLER_H
+
+#include <Rtypes.h>
+
+#include <utility>
+#include <vector>
+
+class TH2;
+class TRandom;
+
+/**
+ * Samples (x, y) from a 2D table (e.g. a cross section in energy and angle) in constant time.
+ *
+ * The table is turned into a Walker alias table once, so picking a bin costs one random number
+ * and one comparison instead of the binary search over the integral done by TH2::GetRandom2.
+ * Inside the bin the point is drawn from a density that varies linearly between the bin edges,
+ * where the value at an edge is the average of the two bins sharing it. This keeps the probability
+ * of every bin equal to the table while removing the steps of sampling uniformly within a bin.
+ *
+ * Sampling is const and takes the random stream to use, so one sampler can be shared between
+ * generators (and threads) that each own their stream.
+ */
+class AtAliasSampler {
+private:
+   std::vector<double> fXEdges;
+   std::vector<double> fYEdges;
+   std::vector<double> fWeights; //< Table, index is ix + iy * nx
+   std::vector<double> fProb;    //< Probability of keeping the chosen bin
+   std::vector<int> fAlias;      //< Bin to use instead if the chosen bin is not kept
+   bool fInterpolate{true};
+
+public:
+   AtAliasSampler() = default;
+   /// Create a sampler from the content of hist (under and overflow are ignored)
+   AtAliasSampler(const TH2 &hist, bool interpolate = true);
+
+   /**
+    * Set the table to sample from. weights is indexed by ix + iy * nx and must have nx * ny
+    * non-negative entries, where nx and ny are the number of bins defined by the edges.
+    */
+   void SetTable(std::vector<double> weights, std::vector<double> xEdges, std::vector<double> yEdges);
+   void SetTable(const TH2 &hist);
+   void SetInterpolate(bool val) { fInterpolate = val; }
+
+   bool IsValid() const { return !fProb.empty(); }
+   int GetNumBinsX() const { return fXEdges.size() - 1; }
+   int GetNumBinsY() const { return fYEdges.size() - 1; }
+
+   /// Sample the index (ix + iy * nx) of a bin, or -1 if the table is not valid. Uses gRandom if rand is nullptr.
+   int SampleBin(TRandom *rand = nullptr) const;
+   /// Sample a point (x, y). Uses gRandom if rand is nullptr.
+   std::pair<double, double> Sample(TRandom *rand = nullptr) const;
+
+private:
+   void BuildAliasTable();
+   double Weight(int ix, int iy) const { return fWeights[ix + iy * GetNumBinsX()]; }
+   double EdgeWeight(int ix, int iy, int dx, int dy) const;
+   static double SampleLinear(double lowWeight, double highWeight, double r);
+};
+
+#endif //#ifndef ATALIASSAMPLER_H
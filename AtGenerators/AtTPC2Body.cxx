@@ -164,8 +164,9 @@ Bool_t AtTPC2Body::ReadEvent(FairPrimaryGenerator *primGen)
    Double_t costhetamax = TMath::Cos(fThetaCmsMax * TMath::DegToRad());
    // Double_t thetacmsInput = fThetaCmsMin + ((fThetaCmsMax-fThetaCmsMin)*gRandom->Uniform());
    ////uniform thetacm distribution between thetamin and thetamax
+   auto random = AtVertexPropagator::Instance()->GetRandom();
    Double_t thetacmsInput =
-      TMath::ACos((costhetamax - costhetamin) * gRandom->Uniform() + costhetamin) * TMath::RadToDeg();
+      TMath::ACos((costhetamax - costhetamin) * random->Uniform() + costhetamin) * TMath::RadToDeg();
 
    std::cout << cBLUE << " -I- AtTPC2Body : Random CMS Theta angle in degrees : " << thetacmsInput << cNORMAL
              << std::endl;
@@ -318,7 +319,7 @@ Bool_t AtTPC2Body::ReadEvent(FairPrimaryGenerator *primGen)
 
          Double_t phiBeam1 = 0., phiBeam2 = 0.;
 
-         phiBeam1 = 2 * TMath::Pi() * gRandom->Uniform(); // flat probability in phi
+         phiBeam1 = 2 * TMath::Pi() * random->Uniform(); // flat probability in phi
          phiBeam2 = phiBeam1 + TMath::Pi();
 
          // std::cout<<" Propagated Entrance Position 2 - X : "<<AtVertexPropagator::Instance()->GetVx()<<" - Y :
@@ -33,7 +33,7 @@ public:
               std::vector<Double_t> *mass, std::vector<Double_t> *Ex, Double_t ResEner, Double_t MinCMSAng,
               Double_t MaxCMSAng);
 
-   AtTPC2Body(const AtTPC2Body &);
+   AtTPC2Body(const AtTPC2Body &) = default;
 
    AtTPC2Body &operator=(const AtTPC2Body &) { return *this; }
 
@@ -45,6 +45,9 @@ public:
 
    virtual Bool_t ReadEvent(FairPrimaryGenerator *primGen);
 
+   /// Copy for a Geant4 worker thread. The ions and particles are shared, they are only read.
+   virtual FairGenerator *CloneGenerator() const override { return new AtTPC2Body(*this); }
+
    /** Destructor **/
    virtual ~AtTPC2Body() = default;
 
@@ -28,10 +28,15 @@
 #include <iostream>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <utility>
 
 constexpr float amu = 931.494;
 
+namespace {
+std::mutex fGRandomMutex; // TGenPhaseSpace draws from gRandom, which is shared by all threads
+} // namespace
+
 Int_t AtTPCIonDecay::fgNIon = 0;
 
 constexpr auto cRED = "\033[1;31m";
@@ -87,30 +92,30 @@ AtTPCIonDecay::AtTPCIonDecay(std::vector<std::vector<Int_t>> *z, std::vector<std
    for (Int_t k = 0; k < fNbCases; k++) {
       for (Int_t i = 0; i < fMult.at(k); i++) {
 
-         std::unique_ptr<FairIon> IonBuff = nullptr;
-         std::unique_ptr<FairParticle> ParticleBuff = nullptr;
+         std::shared_ptr<FairIon> IonBuff = nullptr;
+         std::shared_ptr<FairParticle> ParticleBuff = nullptr;
          sprintf(buffer, "Product_Ion_dec%d_%d", k, i);
          if (a->at(k).at(i) != 1) {
-            IonBuff = std::make_unique<FairIon>(buffer, z->at(k).at(i), a->at(k).at(i), q->at(k).at(i), 0.0,
+            IonBuff = std::make_shared<FairIon>(buffer, z->at(k).at(i), a->at(k).at(i), q->at(k).at(i), 0.0,
                                                 mass->at(k).at(i) * amu / 1000.0);
-            ParticleBuff = std::make_unique<FairParticle>("dummyPart", 1, 1, 1.0, 0, 0.0, 0.0);
+            ParticleBuff = std::make_shared<FairParticle>("dummyPart", 1, 1, 1.0, 0, 0.0, 0.0);
             fPType.at(k).push_back("Ion");
             run->AddNewIon(IonBuff.get());
 
          } else if (a->at(k).at(i) == 1 && z->at(k).at(i) == 1) {
-            IonBuff = std::make_unique<FairIon>(buffer, z->at(k).at(i), a->at(k).at(i), q->at(k).at(i), 0.0,
+            IonBuff = std::make_shared<FairIon>(buffer, z->at(k).at(i), a->at(k).at(i), q->at(k).at(i), 0.0,
                                                 mass->at(k).at(i) * amu / 1000.0);
             auto *kProton = new TParticle(); // NOLINT
             kProton->SetPdgCode(2212);
-            ParticleBuff = std::make_unique<FairParticle>(2212, kProton);
+            ParticleBuff = std::make_shared<FairParticle>(2212, kProton);
             fPType.at(k).push_back("Proton");
 
          } else if (a->at(k).at(i) == 1 && z->at(k).at(i) == 0) {
-            IonBuff = std::make_unique<FairIon>(buffer, z->at(k).at(i), a->at(k).at(i), q->at(k).at(i), 0.0,
+            IonBuff = std::make_shared<FairIon>(buffer, z->at(k).at(i), a->at(k).at(i), q->at(k).at(i), 0.0,
                                                 mass->at(k).at(i) * amu / 1000.0);
             auto *kNeutron = new TParticle(); // NOLINT
             kNeutron->SetPdgCode(2112);
-            ParticleBuff = std::make_unique<FairParticle>(2112, kNeutron);
+            ParticleBuff = std::make_shared<FairParticle>(2112, kNeutron);
             fPType.at(k).push_back("Neutron");
          }
          fIon.at(k).push_back(std::move(IonBuff));
@@ -169,7 +174,7 @@ Bool_t AtTPCIonDecay::ReadEvent(FairPrimaryGenerator *primGen)
       }
    }
    if (IsGoodCase) {
-      int RandVar = (int)(GoodCases.size()) * gRandom->Uniform();
+      int RandVar = (int)(GoodCases.size()) * AtVertexPropagator::Instance()->GetRandom()->Uniform();
       auto it = GoodCases.begin();
       std::advance(it, RandVar);
       Int_t Case = *it;
@@ -259,7 +264,14 @@ Bool_t AtTPCIonDecay::ReadEvent(FairPrimaryGenerator *primGen)
          // if(ExEject*1000.0>fSepEne){
          fIsDecay = kTRUE;
          event1.SetDecay(fEnergyImpulsionLab_Total, fMult.at(Case), mass_1);
-         event1.Generate(); // to generate the random final state
+         {
+            // Generate from the random stream of this thread's context while no other thread can use gRandom
+            std::lock_guard<std::mutex> lk(fGRandomMutex);
+            auto *globalRandom = gRandom;
+            gRandom = AtVertexPropagator::Instance()->GetRandom();
+            event1.Generate(); // to generate the random final state
+            gRandom = globalRandom;
+         }
          std::vector<Double_t> KineticEnergy;
          std::vector<Double_t> ThetaLab;
 
@@ -43,25 +43,28 @@ public:
                  std::vector<std::vector<Int_t>> *q, std::vector<std::vector<Double_t>> *mass, Int_t ZB, Int_t AB,
                  Double_t BMass, Double_t TMass, Double_t ExEnergy, std::vector<Double_t> *SepEne);
 
-   AtTPCIonDecay(const AtTPCIonDecay &);
+   AtTPCIonDecay(const AtTPCIonDecay &) = default;
 
    AtTPCIonDecay &operator=(const AtTPCIonDecay &) { return *this; }
 
    virtual Bool_t ReadEvent(FairPrimaryGenerator *primGen);
    void SetSequentialDecay(Bool_t var) { fIsSequentialDecay = var; }
 
+   /// Copy for a Geant4 worker thread. The ions and particles are shared, they are only read.
+   virtual FairGenerator *CloneGenerator() const override { return new AtTPCIonDecay(*this); }
+
    /** Destructor **/
    virtual ~AtTPCIonDecay() = default;
 
 private:
-   static Int_t fgNIon;                                     //! Number of the instance of this class
-   std::vector<Int_t> fMult;                                // Multiplicity per decay channel
-   Int_t fNbCases;                                          // Number of decay channel
-   std::vector<Double_t> fPx, fPy, fPz;                     // Momentum components [GeV] per nucleon
-   std::vector<std::vector<Double_t>> fMasses;              // Masses of the N products
-   Double_t fVx, fVy, fVz;                                  // Vertex coordinates [cm]
-   std::vector<std::vector<std::unique_ptr<FairIon>>> fIon; // Pointer to the FairIon to be generated
-   std::vector<std::vector<std::unique_ptr<FairParticle>>> fParticle;
+   static Int_t fgNIon;                                               //! Number of the instance of this class
+   std::vector<Int_t> fMult;                                          // Multiplicity per decay channel
+   Int_t fNbCases;                                                    // Number of decay channel
+   std::vector<Double_t> fPx, fPy, fPz;                               // Momentum components [GeV] per nucleon
+   std::vector<std::vector<Double_t>> fMasses;                        // Masses of the N products
+   Double_t fVx, fVy, fVz;                                            // Vertex coordinates [cm]
+   std::vector<std::vector<std::shared_ptr<FairIon>>> fIon;           //! Pointer to the FairIon to be generated
+   std::vector<std::vector<std::shared_ptr<FairParticle>>> fParticle; //!
    std::vector<std::vector<TString>> fPType;
    std::vector<Int_t> fQ; // Electric charge [e]
    // std::vector<Int_t> fA;
@@ -80,7 +83,7 @@ private:
    std::vector<Double_t> fSepEne;
    Bool_t fIsSequentialDecay{}; //<! True if the decay generator is to be used after a reaction generator.
 
-   ClassDef(AtTPCIonDecay, 3)
+   ClassDef(AtTPCIonDecay, 4)
 };
 
 #endif
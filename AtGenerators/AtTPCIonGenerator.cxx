@@ -126,10 +126,24 @@ void AtTPCIonGenerator::SetSpotRadius(Double32_t r, Double32_t z, Double32_t off
    fOffsetY = offy;
 }
 
+void AtTPCIonGenerator::SetBeamInContext() const
+{
+   AtVertexPropagator::Instance()->SetBeamMass(fIon->GetMass());
+   AtVertexPropagator::Instance()->SetBeamNomE(fNomEner);
+}
+
+FairGenerator *AtTPCIonGenerator::CloneGenerator() const
+{
+   // Clones are created on the worker thread, so its context also needs the beam
+   SetBeamInContext();
+   return new AtTPCIonGenerator(*this);
+}
+
 void AtTPCIonGenerator::SetVertexCoordinates()
 {
-   auto Phi = gRandom->Uniform(0, 360) * TMath::DegToRad();
-   auto SpotR = gRandom->Uniform(0, fR);
+   auto random = AtVertexPropagator::Instance()->GetRandom();
+   auto Phi = random->Uniform(0, 360) * TMath::DegToRad();
+   auto SpotR = random->Uniform(0, fR);
 
    fVx = fOffsetX + SpotR * cos(Phi); // gRandom->Uniform(-fx,fx);
    fVy = fOffsetY + SpotR * sin(Phi); // gRandom->Uniform(-fy,fy);
@@ -157,7 +171,7 @@ Bool_t AtTPCIonGenerator::ReadEvent(FairPrimaryGenerator *primGen)
 
    if (AtVertexPropagator::Instance()->GetBeamEvtCnt() % 2 != 0) {
       if (fDoReact) {
-         Double_t Er = gRandom->Uniform(0., fMaxEnLoss);
+         Double_t Er = AtVertexPropagator::Instance()->GetRandom()->Uniform(0., fMaxEnLoss);
          AtVertexPropagator::Instance()->SetRndELoss(Er);
          // std::cout << cGREEN << " Random Energy AtTPCIonGenerator : " << Er << cNORMAL << std::endl;
       } else
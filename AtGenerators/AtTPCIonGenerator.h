@@ -30,13 +30,15 @@ protected:
 
    FairIon *fIon; //< Pointer to the FairIon to be generated
    Int_t fQ;      //< Electric charge [e]
-   Int_t fNomEner{};
+   Double_t fNomEner{};
    Double_t fMaxEnLoss{}; //< Max energy loss before reation happens
 
    Bool_t fDoReact{true};
 
    /// Sets fVx, fVy, fVz depending on the type of ion generator.
    virtual void SetVertexCoordinates();
+   /// Set the beam in the AtVertexPropagator context of the calling thread.
+   void SetBeamInContext() const;
 
 public:
    /** Default constructor **/
@@ -88,7 +90,10 @@ public:
    **/
    virtual Bool_t ReadEvent(FairPrimaryGenerator *primGen);
 
-   ClassDef(AtTPCIonGenerator, 2)
+   /// Copy for a Geant4 worker thread. The ion is shared, it is only read.
+   virtual FairGenerator *CloneGenerator() const override;
+
+   ClassDef(AtTPCIonGenerator, 3)
 };
 
 #endif
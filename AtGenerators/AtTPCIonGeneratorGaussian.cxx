@@ -1,5 +1,7 @@
 #include "AtTPCIonGeneratorGaussian.h"
 
+#include "AtVertexPropagator.h"
+
 #include <TRandom.h>
 
 #include <algorithm> // for clamp
@@ -23,13 +25,14 @@ void AtTPCIonGeneratorGaussian::SetBeamOrigin(Double32_t x, Double32_t y)
 void AtTPCIonGeneratorGaussian::SetVertexCoordinates()
 {
    double pi = 2 * asin(1.0);
+   auto random = AtVertexPropagator::Instance()->GetRandom();
 
-   Double_t radius = std::clamp(gRandom->Gaus(0, fR / 3), 0.0, fR);
-   Double_t phi_R = gRandom->Uniform(0, 2 * pi);
+   Double_t radius = std::clamp(random->Gaus(0, fR / 3), 0.0, fR);
+   Double_t phi_R = random->Uniform(0, 2 * pi);
    fVx = radius * cos(phi_R) + fX;
    fVy = radius * sin(phi_R) + fY;
 
-   Double_t theta = gRandom->Uniform(0, fTheta);
+   Double_t theta = random->Uniform(0, fTheta);
    Double_t pr = fPz * sin(theta);
    fPz *= cos(theta);
    fPx = pr * cos(phi_R);
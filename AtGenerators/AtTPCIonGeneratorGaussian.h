@@ -29,6 +29,12 @@ public:
 
    void SetBeamOrigin(Double32_t x = 0, Double32_t y = 0);
 
+   virtual FairGenerator *CloneGenerator() const override
+   {
+      SetBeamInContext();
+      return new AtTPCIonGeneratorGaussian(*this);
+   }
+
    ClassDefOverride(AtTPCIonGeneratorGaussian, 1);
 };
 
@@ -52,6 +52,12 @@ void AtTPCIonGeneratorS800::SetBeamEmittance(Double32_t val1, Double32_t val2, D
    fBeamOy = val9;
 }
 
+FairGenerator *AtTPCIonGeneratorS800::CloneGenerator() const
+{
+   LOG(fatal) << "AtTPCIonGeneratorS800 cannot be used in a multithreaded simulation!";
+   return nullptr;
+}
+
 void AtTPCIonGeneratorS800::SetVertexCoordinates()
 {
    // TStopwatch timer;
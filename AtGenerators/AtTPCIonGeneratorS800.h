@@ -43,6 +43,9 @@ public:
    void SetBeamEmittance(Double32_t val1 = 0, Double32_t val2 = 0, Double32_t val3 = 0, Double32_t val4 = 0,
                          Double_t val5 = 0, Double_t val6 = 0, Double_t val7 = 0, Double_t val8 = 0, Double_t val9 = 0);
 
+   /// Not supported: this generator reseeds gRandom every event, so it can only run sequentially.
+   virtual FairGenerator *CloneGenerator() const override;
+
    ClassDefOverride(AtTPCIonGeneratorS800, 1);
 };
 
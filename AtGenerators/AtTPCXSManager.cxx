@@ -1,5 +1,7 @@
 #include "AtTPCXSManager.h"
 
+#include "AtAliasSampler.h"
+
 #include <TH2.h>
 
 #include <fstream> // IWYU pragma: keep
@@ -25,6 +27,7 @@ AtTPCXSManager *AtTPCXSManager::Instance()
 Bool_t AtTPCXSManager::SetExcitationFunction(std::string filename)
 {
    fExFunctionFile = filename;
+   fExSampler = nullptr;
    std::ifstream file;
    file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
 
@@ -95,4 +98,11 @@ Bool_t AtTPCXSManager::SetExcitationFunction(std::string filename)
    return false;
 }
 
+std::shared_ptr<AtAliasSampler> AtTPCXSManager::GetExcitationSampler()
+{
+   if (fExSampler == nullptr && fExFunction != nullptr)
+      fExSampler = std::make_shared<AtAliasSampler>(*fExFunction);
+   return fExSampler;
+}
+
 ClassImp(AtTPCXSManager)
@@ -12,6 +12,7 @@
 #include <memory>
 #include <string>
 
+class AtAliasSampler;
 class TBuffer;
 class TClass;
 class TH2F;
@@ -23,6 +24,7 @@ private:
 
    std::string fExFunctionFile;
    std::shared_ptr<TH2F> fExFunction;
+   std::shared_ptr<AtAliasSampler> fExSampler; //!
    Bool_t kIsExFunction = true;
 
 protected:
@@ -35,6 +37,8 @@ public:
    bool SetExcitationFunction(std::string filename);
 
    inline std::shared_ptr<TH2F> GetExcitationFunction() { return fExFunction; }
+   /// Sampler of the excitation function, faster than GetExcitationFunction()->GetRandom2()
+   std::shared_ptr<AtAliasSampler> GetExcitationSampler();
 
    ClassDef(AtTPCXSManager, 1)
 };
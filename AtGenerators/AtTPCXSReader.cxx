@@ -25,6 +25,8 @@
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <tuple> // for tie
 
 using std::cout;
 using std::endl;
@@ -80,6 +82,7 @@ AtTPCXSReader::AtTPCXSReader(const char *name, std::vector<Int_t> *z, std::vecto
          fh_pdf->SetBinContent(energies + 1, xsvalues + 1, xs[energies][xsvalues]);
       }
    }
+   fSampler = std::make_shared<const AtAliasSampler>(*fh_pdf);
    // fh_pdf->Write();
 
    auto *kProton = new TParticle(); // NOLINT Probably actually a problem though
@@ -171,7 +174,7 @@ Bool_t AtTPCXSReader::ReadEvent(FairPrimaryGenerator *primGen)
    if (AtVertexPropagator::Instance()->GetEnergy() > 0 && AtVertexPropagator::Instance()->GetDecayEvtCnt() % 2 != 0) {
       // proton parameters come from the XS PDF
       Double_t energyFromPDF, thetaFromPDF;
-      fh_pdf->GetRandom2(energyFromPDF, thetaFromPDF);
+      std::tie(energyFromPDF, thetaFromPDF) = fSampler->Sample(AtVertexPropagator::Instance()->GetRandom());
 
       Ang.push_back(thetaFromPDF * TMath::Pi() / 180); // set angle PROTON (in rad)
       Ene.push_back(energyFromPDF);                    // set energy PROTON
@@ -221,7 +224,7 @@ Bool_t AtTPCXSReader::ReadEvent(FairPrimaryGenerator *primGen)
       fPz.at(1) = 0.0;
 
       Double_t phi1 = 0., phi2 = 0.;
-      phi1 = 2 * TMath::Pi() * gRandom->Uniform(); // flat probability in phi
+      phi1 = 2 * TMath::Pi() * AtVertexPropagator::Instance()->GetRandom()->Uniform(); // flat probability in phi
       phi2 = phi1 + TMath::Pi();
 
       // To MeV for Euler Transformation
@@ -6,11 +6,14 @@
 #ifndef AtTPCXSREADER_H
 #define AtTPCXSREADER_H
 
+#include "AtAliasSampler.h"
+
 #include <FairGenerator.h>
 
 #include <Rtypes.h>
 #include <TString.h>
 
+#include <memory>
 #include <vector>
 
 class FairPrimaryGenerator;
@@ -34,6 +37,8 @@ public:
                  std::vector<Double_t> *px, std::vector<Double_t> *py, std::vector<Double_t> *pz,
                  std::vector<Double_t> *mass);
 
+   AtTPCXSReader(const AtTPCXSReader &) = default;
+
    AtTPCXSReader &operator=(const AtTPCXSReader &) { return *this; }
 
    /** Destructor **/
@@ -45,6 +50,9 @@ public:
     **/
    virtual Bool_t ReadEvent(FairPrimaryGenerator *primGen);
 
+   /// Copy for a Geant4 worker thread. The ions, particles and cross section are shared, they are only read.
+   virtual FairGenerator *CloneGenerator() const override { return new AtTPCXSReader(*this); }
+
    /** Modifiers **/
    void SetXSFileName(TString name = "xs_22Mgp_fusionEvaporation.txt") { fXSFileName = name; }
 
@@ -68,8 +76,9 @@ private:
    std::vector<Double_t> fWm; // Total mass
 
    TH2F *fh_pdf{};
+   std::shared_ptr<const AtAliasSampler> fSampler; //! Samples fh_pdf
 
-   ClassDef(AtTPCXSReader, 1)
+   ClassDef(AtTPCXSReader, 2)
 };
 
 #endif
@@ -30,6 +30,7 @@
 #pragma link C++ class AtTPCFissionGeneratorV3 + ;
 #pragma link C++ class AtTPCXSReader + ;
 #pragma link C++ class AtTPCXSManager + ;
+#pragma link C++ class AtAliasSampler - !;
 #pragma link C++ class AtTPCGammaDummyGenerator + ;
 #pragma link C++ class AtTPC20MgDecay + ;
 #pragma link C++ class AtTPC20MgDecay_pag + ;
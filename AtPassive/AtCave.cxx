@@ -45,3 +45,8 @@ AtCave::AtCave(const char *name, const char *Title) : FairModule(name, Title)
    world[1] = 0;
    world[2] = 0;
 }
+
+FairModule *AtCave::CloneModule() const
+{
+   return new AtCave(*this);
+}
@@ -28,6 +28,8 @@ public:
    AtCave();
    virtual ~AtCave();
    virtual void ConstructGeometry();
+   /// Copy for a Geant4 worker thread
+   virtual FairModule *CloneModule() const override;
 
 private:
    Double_t world[3]{0, 0, 0};
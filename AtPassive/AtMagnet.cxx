@@ -84,4 +84,9 @@ void AtMagnet::ConstructGeometry()
      top->AddNode(magnet1, 2, m6);*/
 }
 
+FairModule *AtMagnet::CloneModule() const
+{
+   return new AtMagnet(*this);
+}
+
 ClassImp(AtMagnet)
@@ -28,6 +28,8 @@ public:
    AtMagnet();
    virtual ~AtMagnet();
    void ConstructGeometry();
+   /// Copy for a Geant4 worker thread
+   virtual FairModule *CloneModule() const override;
    ClassDef(AtMagnet, 1)
 };
 
@@ -69,4 +69,9 @@ void AtPipe::ConstructGeometry()
 }
 // ----------------------------------------------------------------------------
 
+FairModule *AtPipe::CloneModule() const
+{
+   return new AtPipe(*this);
+}
+
 ClassImp(AtPipe)
@@ -29,6 +29,8 @@ public:
 
    virtual ~AtPipe();
    virtual void ConstructGeometry();
+   /// Copy for a Geant4 worker thread
+   virtual FairModule *CloneModule() const override;
 
    ClassDef(AtPipe, 1) // AtPIPE
 };
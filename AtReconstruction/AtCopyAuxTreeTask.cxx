@@ -1,6 +1,7 @@
 #include "AtCopyAuxTreeTask.h"
 
 #include "AtBaseEvent.h"
+#include "AtEntryListSource.h"
 
 #include <FairLogger.h>
 #include <FairRootManager.h>
@@ -72,7 +73,7 @@ InitStatus AtCopyAuxTreeTask::Init()
 
 void AtCopyAuxTreeTask::Exec(Option_t *opt)
 {
-   fInputTree->GetEntry(FairRootManager::Instance()->GetEntryNr());
+   fInputTree->GetEntry(AtEntryListSource::GetCurrentTreeEntry());
 
    auto fEvent = dynamic_cast<AtBaseEvent *>(fCheckEventArray->At(0));
 
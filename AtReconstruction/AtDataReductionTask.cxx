@@ -1,6 +1,7 @@
 #include "AtDataReductionTask.h"
 
 #include "AtBaseEvent.h"
+#include "AtEntryListSource.h"
 
 #include <FairLogger.h>
 #include <FairRootManager.h>
@@ -45,10 +46,10 @@ void AtDataReductionTask::Exec(Option_t *opt)
 
    // If we should skip this event mark bad and don't fill tree
    if (fReductionFunc())
-      LOG(info) << "Keeping event " << fEvent->GetEventID() << " at " << FairRootManager::Instance()->GetEntryNr();
+      LOG(info) << "Keeping event " << fEvent->GetEventID() << " at " << AtEntryListSource::GetCurrentTreeEntry();
    else {
 
-      LOG(info) << "Skipping event " << fEvent->GetEventID() << " at " << FairRootManager::Instance()->GetEntryNr();
+      LOG(info) << "Skipping event " << fEvent->GetEventID() << " at " << AtEntryListSource::GetCurrentTreeEntry();
 
       FairRootManager *ioMan = FairRootManager::Instance();
       for (auto name : fOutputBranchs) {
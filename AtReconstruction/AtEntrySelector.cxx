@@ -0,0 +1,83 @@
+#include "AtEntrySelector.h"
+
+#include <FairLogger.h>
+
+#include <TChain.h>
+#include <TEntryList.h>
+#include <TFile.h>
+
+#include <algorithm> // for find
+#include <chrono>
+
+AtEntrySelector::AtEntrySelector(TString fileName, TString treeName) : fChain(std::make_unique<TChain>(treeName))
+{
+   AddFile(fileName);
+}
+
+AtEntrySelector::~AtEntrySelector()
+{
+   fChain->ResetBranchAddresses();
+   for (auto array : fArrays)
+      delete array;
+}
+
+void AtEntrySelector::AddFile(TString fileName)
+{
+   fChain->Add(fileName);
+}
+
+size_t AtEntrySelector::AddBranch(TString branchName)
+{
+   auto it = std::find(fBranchNames.begin(), fBranchNames.end(), branchName);
+   if (it != fBranchNames.end())
+      return std::distance(fBranchNames.begin(), it);
+
+   fBranchNames.push_back(branchName);
+   return fBranchNames.size() - 1;
+}
+
+TEntryList *AtEntrySelector::Select()
+{
+   auto start = std::chrono::high_resolution_clock::now();
+
+   // Only read the branches a predicate depends on
+   fChain->SetBranchStatus("*", false);
+   fArrays.assign(fBranchNames.size(), nullptr);
+   for (size_t i = 0; i < fBranchNames.size(); ++i) {
+      if (fChain->GetBranch(fBranchNames[i]) == nullptr) {
+         LOG(error) << "Cannot find branch " << fBranchNames[i] << ", its selections will reject every entry!";
+         continue;
+      }
+      fChain->SetBranchStatus(fBranchNames[i] + "*", true);
+      fChain->SetBranchAddress(fBranchNames[i], &fArrays[i]);
+   }
+
+   fEntryList = std::make_unique<TEntryList>("AtSelectedEntries", "Entries passing AtEntrySelector");
+   auto numEntries = fChain->GetEntries();
+   for (Long64_t entry = 0; entry < numEntries; ++entry) {
+      if (!fBranchNames.empty())
+         fChain->GetEntry(entry);
+
+      bool keep = true;
+      for (auto &func : fSelections)
+         if (!(keep = func(entry)))
+            break;
+      if (keep)
+         fEntryList->Enter(entry);
+   }
+
+   auto stop = std::chrono::high_resolution_clock::now();
+   LOG(info) << "Selected " << fEntryList->GetN() << " of " << numEntries << " entries in "
+             << std::chrono::duration_cast<std::chrono::milliseconds>(stop - start).count() << " ms.";
+   return fEntryList.get();
+}
+
+void AtEntrySelector::Write(TString fileName, TString listName)
+{
+   if (fEntryList == nullptr)
+      Select();
+
+   TFile file(fileName, "RECREATE");
+   fEntryList->Write(listName);
+   file.Close();
+}
@@ -0,0 +1,71 @@
+#ifndef ATENTRYSELECTOR_H
+#define ATENTRYSELECTOR_H
+
+#include <Rtypes.h>
+#include <TClonesArray.h>
+#include <TString.h>
+
+#include <functional> // for function
+#include <memory>     // for unique_ptr
+#include <utility>    // for move
+#include <vector>     // for vector
+
+class TChain;
+class TEntryList;
+
+/**
+ * Selection pre-pass over a FairRoot output file. Evaluates cheap predicates on small branches
+ * (aux pads, timestamps, event flags, or external trees indexed by entry number) without reading
+ * any of the other branches, and builds a TEntryList of the entries that pass every predicate.
+ *
+ * The list can be written to a file and passed to AtEntryListSource so later runs only read the
+ * selected entries.
+ */
+class AtEntrySelector {
+private:
+   using EntryFunction = std::function<bool(Long64_t)>;
+
+   std::unique_ptr<TChain> fChain;
+   std::vector<TString> fBranchNames;
+   std::vector<TClonesArray *> fArrays; //< Branch objects, same order as fBranchNames
+   std::vector<EntryFunction> fSelections;
+   std::unique_ptr<TEntryList> fEntryList;
+
+public:
+   AtEntrySelector(TString fileName, TString treeName = "cbmsim");
+   ~AtEntrySelector();
+
+   void AddFile(TString fileName);
+
+   /// Add a predicate on the entry number (e.g. an AtCutHEIST reading a tree in sync with this one).
+   void AddSelection(EntryFunction func) { fSelections.push_back(std::move(func)); }
+
+   /**
+    * Add a predicate on the first object stored in branchName, cast to T. Only the branches used by
+    * predicates are read. Entries where the branch is empty are rejected.
+    */
+   template <class T>
+   void AddSelection(TString branchName, std::function<bool(T *)> func)
+   {
+      auto idx = AddBranch(branchName);
+      fSelections.push_back([this, idx, func](Long64_t) {
+         auto array = fArrays[idx];
+         if (array == nullptr || array->GetEntriesFast() == 0)
+            return false;
+         auto obj = dynamic_cast<T *>(array->At(0));
+         return obj != nullptr && func(obj);
+      });
+   }
+
+   /// Run the pre-pass. The returned list is owned by this class.
+   TEntryList *Select();
+   TEntryList *GetEntryList() { return fEntryList.get(); }
+
+   /// Write the selected entries to fileName as a TEntryList called listName.
+   void Write(TString fileName, TString listName = "AtSelectedEntries");
+
+private:
+   size_t AddBranch(TString branchName);
+};
+
+#endif //#ifndef ATENTRYSELECTOR_H
@@ -8,3 +8,9 @@ AtRawEvent *AtFilter::ConstructOutputEvent(TClonesArray *fOutputEventArray, AtRa
 {
    return new ((*fOutputEventArray)[0]) AtRawEvent(*inputEvent); // NOLINT (ROOT owns memory)
 }
+
+void AtFilter::FilterPads(const std::vector<AtPad *> &pads)
+{
+   for (auto pad : pads)
+      Filter(pad);
+}
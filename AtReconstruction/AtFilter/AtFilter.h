@@ -1,6 +1,9 @@
 #ifndef ATFILTER_H
 #define ATFILTER_H
 
+#include <memory>
+#include <vector>
+
 class TClonesArray;
 class AtRawEvent;
 class AtPad;
@@ -44,8 +47,34 @@ public:
     */
    virtual void Filter(AtPad *pad, AtPadReference *padReference = nullptr) = 0;
 
+   /**
+    * @brief Called to filter all pads in the pad list of an event.
+    *
+    * By default calls Filter(AtPad*) on each pad. Only needs to be overriden if the filter
+    * can do better by processing every pad at once (ex. AtFilterFFT).
+    *
+    * @param[in] pads Pads to filter.
+    */
+   virtual void FilterPads(const std::vector<AtPad *> &pads);
+
    /// Called at the end of an event. Returns if filtering was successful.
    virtual bool IsGoodEvent() = 0;
+
+   /**
+    * @brief If Filter() can be called on different pads by multiple threads at once.
+    *
+    * Only true if the filter keeps no state that is modified while filtering a pad. Used by
+    * AtFilterTask to decide if the same filter can be shared between threads.
+    */
+   virtual bool IsThreadSafe() { return false; }
+
+   /**
+    * @brief Create a copy of this filter to be used by a different thread.
+    *
+    * The copy is initialized by the caller (Init() is called on it). Returns nullptr if the
+    * filter cannot be copied, in which case AtFilterTask will only run it on a single thread.
+    */
+   virtual std::unique_ptr<AtFilter> Clone() { return nullptr; }
 };
 
 #endif //#ifndef ATFILTER_H
@@ -11,6 +11,7 @@
 #include <TComplex.h> // IWYU pragma: keep
 #include <TVirtualFFT.h>
 
+#include <algorithm>
 #include <iostream>
 #include <utility>
 struct AtPadReference;
@@ -18,14 +19,13 @@ struct AtPadReference;
 void AtFilterFFT::SetLowPass(int order, int cutoff)
 {
    fFreqRanges.clear();
-   for (int i = 0; i < 512 / 2 + 1; ++i)
+   for (int i = 0; i < fNumFreq; ++i)
       AddFreqRange({i, getFilterKernel(i, order, cutoff), i, getFilterKernel(i, order, cutoff)});
 }
 
 /**
  * @param[in] freq The frequency compnent
  * @return The kernel of the low pass filter as set at that frequency
- * @todo: Precompute once and save with the transformed response function
  */
 double AtFilterFFT::getFilterKernel(int freq, int fFilterOrder, int fCutoffFreq)
 {
@@ -64,6 +64,34 @@ void AtFilterFFT::Init()
    // Create a FFT object that we own ("K"), that will optimize the transform ("M"),
    // and is a backwards transform from complex to Reak ("C2R")
    fFFTbackward = std::unique_ptr<TVirtualFFT>(TVirtualFFT::FFT(1, dimSize.data(), "C2R M K"));
+
+   fillFactorArray();
+}
+
+/**
+ * Fill the array of factors for every frequency from the added frequency ranges. Frequencies not
+ * covered by any range are left unchanged (factor of 1).
+ */
+void AtFilterFFT::fillFactorArray()
+{
+   fFactorArray.fill(1);
+   for (const auto &[freq, factor] : fFactors)
+      if (freq >= 0 && freq < fNumFreq)
+         fFactorArray[freq] = factor;
+}
+
+/**
+ * The copy has the same frequency factors and options, but its own FFT plans and buffers
+ * (created when Init() is called on it).
+ */
+std::unique_ptr<AtFilter> AtFilterFFT::Clone()
+{
+   auto ret = std::make_unique<AtFilterFFT>();
+   ret->fFreqRanges = fFreqRanges;
+   ret->fFactors = fFactors;
+   ret->fSaveTransform = fSaveTransform;
+   ret->fSubtractBackground = fSubtractBackground;
+   return ret;
 }
 
 void AtFilterFFT::InitEvent(AtRawEvent *inputEvent)
@@ -104,17 +132,117 @@ void AtFilterFFT::Filter(AtPad *pad, AtPadReference *padReference)
 
    fFFTbackward->Transform();
 
+   AtPad::trace adc;
+   fFFTbackward->GetPoints(adc.data());
+
    double baseline = 0;
    if (fSubtractBackground) {
       for (int i = 0; i < 20; ++i)
-         baseline += fFFTbackward->GetPointReal(i);
+         baseline += adc[i];
       baseline /= 20;
    }
 
-   for (int i = 0; i < pad->GetADC().size(); ++i)
-      pad->SetADC(i, fFFTbackward->GetPointReal(i) - baseline);
+   for (auto &val : adc)
+      val -= baseline;
+   pad->SetADC(adc);
+}
+
+/**
+ * Filter every pad in the event at once. The traces are packed into a contiguous (nPads x 512)
+ * matrix and transformed row by row re-using the same FFT plans. The frequency factors are then
+ * applied to the entire (nPads x 257) spectrum matrix in one pass, before transforming back and
+ * writing the filtered traces to the pads in bulk.
+ *
+ * The transforms are only copied into AtPadFFT augments if fSaveTransform is set.
+ */
+void AtFilterFFT::FilterPads(const std::vector<AtPad *> &inputPads)
+{
+   std::vector<AtPad *> pads;
+   pads.reserve(inputPads.size());
+   for (auto pad : inputPads) {
+      if (pad->IsPedestalSubtracted())
+         pads.push_back(pad);
+      else
+         LOG(error) << "Skipping FFT on pad " << pad->GetPadNum() << " at " << pad
+                    << " because not pedestal subtracted.";
+   }
+
+   const auto nPads = pads.size();
+   fBatchTrace.resize(nPads * fTransformSize);
+   fBatchRe.resize(nPads * fNumFreq);
+   fBatchIm.resize(nPads * fNumFreq);
+
+   // Pack and transform to frequency space
+   for (int i = 0; i < nPads; ++i) {
+      auto trace = fBatchTrace.data() + i * fTransformSize;
+      std::copy(pads[i]->GetADC().begin(), pads[i]->GetADC().end(), trace);
+
+      fFFT->SetPoints(trace);
+      fFFT->Transform();
+      fFFT->GetPointsComplex(fBatchRe.data() + i * fNumFreq, fBatchIm.data() + i * fNumFreq);
+   }
 
-   // If we are saving the transform, add the
+   if (fSaveTransform)
+      for (int i = 0; i < nPads; ++i)
+         saveTransform(pads[i], fBatchRe.data() + i * fNumFreq, fBatchIm.data() + i * fNumFreq, true);
+
+   // Apply the frequency cuts to every pad
+   for (int i = 0; i < nPads; ++i) {
+      auto re = fBatchRe.data() + i * fNumFreq;
+      auto im = fBatchIm.data() + i * fNumFreq;
+      for (int freq = 0; freq < fNumFreq; ++freq) {
+         re[freq] *= fFactorArray[freq];
+         im[freq] *= fFactorArray[freq];
+      }
+   }
+
+   if (fSaveTransform)
+      for (int i = 0; i < nPads; ++i)
+         saveTransform(pads[i], fBatchRe.data() + i * fNumFreq, fBatchIm.data() + i * fNumFreq, false);
+
+   // Transform back to the time domain. The normalization of the inverse transform is applied when
+   // writing the traces back to the pads.
+   for (int i = 0; i < nPads; ++i) {
+      fFFTbackward->SetPointsComplex(fBatchRe.data() + i * fNumFreq, fBatchIm.data() + i * fNumFreq);
+      fFFTbackward->Transform();
+      fFFTbackward->GetPoints(fBatchTrace.data() + i * fTransformSize);
+   }
+
+   const double norm = 1. / fTransformSize;
+   AtPad::trace adc;
+   for (int i = 0; i < nPads; ++i) {
+      auto trace = fBatchTrace.data() + i * fTransformSize;
+
+      double baseline = 0;
+      if (fSubtractBackground) {
+         for (int tb = 0; tb < 20; ++tb)
+            baseline += trace[tb];
+         baseline /= 20;
+      }
+
+      for (int tb = 0; tb < fTransformSize; ++tb)
+         adc[tb] = (trace[tb] - baseline) * norm;
+      pads[i]->SetADC(adc);
+   }
+}
+
+/**
+ * Add the passed transform as an AtPadFFT augment. If isInput is true the augment is added to the
+ * matching pad in the input event, otherwise to the passed (output) pad.
+ */
+void AtFilterFFT::saveTransform(AtPad *pad, const Double_t *re, const Double_t *im, bool isInput)
+{
+   AtPadFFT::TraceTrans reArr, imArr;
+   std::copy(re, re + fNumFreq, reArr.begin());
+   std::copy(im, im + fNumFreq, imArr.begin());
+
+   auto fft = std::make_unique<AtPadFFT>();
+   fft->SetData(std::move(reArr), std::move(imArr));
+
+   if (isInput)
+      fInputEvent->GetPad(pad->GetPadNum())->AddAugment("fft", std::move(fft));
+   else
+      pad->AddAugment("fft", std::move(fft));
 }
 
 bool AtFilterFFT::isValidFreqRange(const AtFreqRange &range)
@@ -156,18 +284,22 @@ bool AtFilterFFT::doesFreqRangeOverlap(const AtFreqRange &newRange)
  */
 std::unique_ptr<AtPadFFT> AtFilterFFT::applyFrequencyCutsAndSetInverseFFT()
 {
+   AtPadFFT::TraceTrans re, im;
+   fFFT->GetPointsComplex(re.data(), im.data());
+
+   for (int i = 0; i < fNumFreq; ++i) {
+      re[i] *= fFactorArray[i];
+      im[i] *= fFactorArray[i];
+   }
+
    auto ret = std::make_unique<AtPadFFT>();
-   for (int i = 0; i < 512 / 2 + 1; ++i) {
+   ret->SetData(re, im);
 
-      Double_t re, im;
-      fFFT->GetPointComplex(i, re, im);
-      if (fFactors.find(i) != fFactors.end()) {
-         re *= fFactors[i];
-         im *= fFactors[i];
-      }
-      ret->SetPoint(i, {re, im});
-      fFFTbackward->SetPoint(i, re / fFFT->GetN()[0], im / fFFT->GetN()[0]);
+   for (int i = 0; i < fNumFreq; ++i) {
+      re[i] /= fTransformSize;
+      im[i] /= fTransformSize;
    }
+   fFFTbackward->SetPointsComplex(re.data(), im.data());
    return ret;
 }
 
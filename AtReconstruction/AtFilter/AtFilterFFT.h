@@ -6,6 +6,7 @@
 #include <Rtypes.h>
 #include <TVirtualFFT.h> // Annoyingly required for ROOT to generate a dictionary (even without IO)
 
+#include <array>
 #include <map>
 #include <memory>
 #include <vector>
@@ -27,6 +28,12 @@ struct AtPadReference;
  *  If you wish to save the unfiltered data with the fourier-space represetation, the set the flag
  *  fSaveTransform and the input branch will be modified to contain AtPadFFTs.
  *
+ *  When run through AtFilterTask all pads of an event are filtered together by FilterPads(). The
+ *  traces are packed into a contiguous matrix, transformed, multiplied by the precomputed factor
+ *  for each frequency in a single pass, and written back in bulk. The batched path does not call
+ *  applyFrequencyCutsAndSetInverseFFT(), so a derived class overriding it should also override
+ *  FilterPads().
+ *
  *  Adam Anthony 4/20/22
  * @ingroup RawFilters
  */
@@ -45,8 +52,12 @@ public:
    using FreqRanges = std::vector<AtFreqRange>;
 
 protected:
+   static constexpr Int_t fTransformSize = 512;
+   static constexpr Int_t fNumFreq = fTransformSize / 2 + 1;
+
    FreqRanges fFreqRanges;
    std::map<Int_t, Double_t> fFactors;
+   std::array<Double_t, fNumFreq> fFactorArray{}; //< Factor for every frequency (filled in Init())
 
    std::unique_ptr<TVirtualFFT> fFFT{nullptr};
    std::unique_ptr<TVirtualFFT> fFFTbackward{nullptr};
@@ -56,7 +67,11 @@ protected:
 
    AtRawEvent *fInputEvent{nullptr};
    // AtRawEvent *fFilteredEvent{nullptr};
-   static constexpr Int_t fTransformSize = 512;
+
+   // Buffers for batched filtering (row i is the ith pad)
+   std::vector<Double_t> fBatchTrace; //< nPads x fTransformSize
+   std::vector<Double_t> fBatchRe;    //< nPads x fNumFreq
+   std::vector<Double_t> fBatchIm;    //< nPads x fNumFreq
 
 public:
    AtFilterFFT() = default;
@@ -75,7 +90,9 @@ public:
    void Init() override;
    void InitEvent(AtRawEvent *event = nullptr) override;
    void Filter(AtPad *pad, AtPadReference *padReference) override;
+   void FilterPads(const std::vector<AtPad *> &pads) override;
    bool IsGoodEvent() override { return true; }
+   std::unique_ptr<AtFilter> Clone() override;
    void SetLowPass(int order, int cuttoff);
 
 protected:
@@ -85,6 +102,8 @@ private:
    bool isValidFreqRange(const AtFreqRange &range);
    bool doesFreqRangeOverlap(const AtFreqRange &range);
    double getFilterKernel(int freq, int fFilterOrder, int fCutoffFreq);
+   void fillFactorArray();
+   void saveTransform(AtPad *pad, const Double_t *re, const Double_t *im, bool isInput);
 };
 
 #endif //#ifndef ATFFTFILTER_H
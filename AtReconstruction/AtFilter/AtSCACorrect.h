@@ -54,6 +54,7 @@ public:
    virtual void Init() override {}
    virtual void InitEvent(AtRawEvent *) override {}
    virtual bool IsGoodEvent() override { return true; }
+   virtual bool IsThreadSafe() override { return true; }
 
    virtual void Filter(AtPad *pad, AtPadReference *padReference) override;
 
@@ -5,6 +5,7 @@
 
 #include <Rtypes.h>
 
+#include <memory>
 #include <vector>
 
 class AtPad;
@@ -45,6 +46,7 @@ public:
    virtual void InitEvent(AtRawEvent *event) override {}
    virtual void Filter(AtPad *pad, AtPadReference *padReference) override;
    virtual bool IsGoodEvent() override { return true; }
+   virtual std::unique_ptr<AtFilter> Clone() override { return std::make_unique<AtTrapezoidFilter>(*this); }
 };
 
 #endif //#ifndef ATTRAPEZOIDFILTER_H
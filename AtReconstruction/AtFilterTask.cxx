@@ -13,9 +13,11 @@
 #include <TClonesArray.h>
 #include <TObject.h>
 
+#include <algorithm>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <thread>
 #include <unordered_map> // for _Node_iterator, operator!=, unordered_map
 #include <utility>
 #include <vector>
@@ -49,10 +51,69 @@ InitStatus AtFilterTask::Init()
    ioManager->Register(fOutputBranchName, "AtTPC", fOutputEventArray, fIsPersistent);
 
    fFilter->Init();
+   setupThreadFilters();
 
    return kSUCCESS;
 }
 
+/**
+ * Fill fThFilter with the filter each thread should use. If the filter is not thread safe, the
+ * copies are created and initialized here so they persist for the entire run.
+ */
+void AtFilterTask::setupThreadFilters()
+{
+   fThFilter.clear();
+   fFilterCopies.clear();
+   fThFilter.push_back(fFilter);
+
+   if (fNumThreads > 1 && !fFilter->IsThreadSafe()) {
+      for (int i = 1; i < fNumThreads; ++i) {
+         auto copy = fFilter->Clone();
+         if (copy == nullptr) {
+            LOG(warn) << "AtFilterTask: Filter is not thread safe and cannot be cloned, running on a single thread.";
+            fFilterCopies.clear();
+            fNumThreads = 1;
+            break;
+         }
+         copy->Init();
+         fFilterCopies.push_back(std::move(copy));
+      }
+   }
+
+   for (int i = 1; i < fNumThreads; ++i)
+      fThFilter.push_back(fFilterCopies.empty() ? fFilter : fFilterCopies[i - 1].get());
+
+   LOG(info) << "AtFilterTask: Filtering on " << fThFilter.size() << " thread(s).";
+}
+
+/**
+ * Split the items [0, numItems) into contiguous blocks and call func(filter, begin, end) for each
+ * block on its own thread, using the filter assigned to that thread.
+ */
+void AtFilterTask::runOnThreads(std::size_t numItems,
+                                const std::function<void(AtFilter *, std::size_t, std::size_t)> &func)
+{
+   auto numThreads = std::min<std::size_t>(fThFilter.size(), numItems);
+   if (numThreads <= 1) {
+      func(fFilter, 0, numItems);
+      return;
+   }
+
+   auto itemsPerTh = numItems / numThreads;
+   auto remainder = numItems % numThreads;
+
+   std::vector<std::thread> threads;
+   std::size_t begin = 0;
+   for (std::size_t i = 0; i < numThreads; ++i) {
+      auto end = begin + itemsPerTh + (i < remainder ? 1 : 0);
+      threads.emplace_back(func, fThFilter[i], begin, end);
+      begin = end;
+   }
+
+   for (auto &th : threads)
+      th.join();
+}
+
 void AtFilterTask::Exec(Option_t *opt)
 {
    fOutputEventArray->Delete();
@@ -62,28 +123,50 @@ void AtFilterTask::Exec(Option_t *opt)
 
    auto rawEvent = dynamic_cast<AtRawEvent *>(fInputEventArray->At(0));
    fFilter->InitEvent(rawEvent); // Can modify rawEvent if necessary (shouldn't touch traces)
+   for (auto &filter : fFilterCopies)
+      filter->InitEvent(rawEvent);
    auto filteredEvent = fFilter->ConstructOutputEvent(fOutputEventArray, rawEvent);
 
    if (!rawEvent->IsGood())
       return;
 
-   if (fFilterAux)
-      for (auto &padIt : filteredEvent->fAuxPadMap) {
-         AtPad *pad = &(padIt.second);
-         fFilter->Filter(pad);
-      }
+   if (fFilterAux) {
+      std::vector<AtPad *> pads;
+      for (auto &padIt : filteredEvent->fAuxPadMap)
+         pads.push_back(&(padIt.second));
 
-   if (fFilterFPN)
-      for (auto &[ref, pad] : filteredEvent->fFpnMap) {
-         LOG(debug) << "Filtering " << ref;
-         AtPadReference padRef = ref;
-         fFilter->Filter(&pad, &padRef);
-      }
+      runOnThreads(pads.size(), [&pads](AtFilter *filter, std::size_t begin, std::size_t end) {
+         for (auto i = begin; i < end; ++i)
+            filter->Filter(pads[i]);
+      });
+   }
+
+   if (fFilterFPN) {
+      std::vector<std::pair<AtPadReference, AtPad *>> pads;
+      for (auto &[ref, pad] : filteredEvent->fFpnMap)
+         pads.emplace_back(ref, &pad);
+
+      runOnThreads(pads.size(), [&pads](AtFilter *filter, std::size_t begin, std::size_t end) {
+         for (auto i = begin; i < end; ++i) {
+            LOG(debug) << "Filtering " << pads[i].first;
+            filter->Filter(pads[i].second, &pads[i].first);
+         }
+      });
+   }
 
-   if (fFilterPads)
+   if (fFilterPads) {
+      std::vector<AtPad *> pads;
+      pads.reserve(filteredEvent->fPadList.size());
       for (auto &pad : filteredEvent->fPadList)
-         fFilter->Filter(pad.get());
+         pads.push_back(pad.get());
+
+      runOnThreads(pads.size(), [&pads](AtFilter *filter, std::size_t begin, std::size_t end) {
+         filter->FilterPads(std::vector<AtPad *>(pads.begin() + begin, pads.begin() + end));
+      });
+   }
 
    auto isGood = filteredEvent->IsGood() && fFilter->IsGoodEvent();
+   for (auto &filter : fFilterCopies)
+      isGood &= filter->IsGoodEvent();
    filteredEvent->SetIsGood(isGood);
 }
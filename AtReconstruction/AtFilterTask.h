@@ -6,12 +6,26 @@
 #include <Rtypes.h>
 #include <TString.h>
 
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
 class AtFilter;
 class TClonesArray;
 class TBuffer;
 class TClass;
 class TMemberInspector;
 
+/**
+ * @brief Task to apply an AtFilter to the pads of every event.
+ *
+ * If the number of threads is larger than one, the pads (and FPN channels and aux pads) of each
+ * event are split between threads. Filters that report IsThreadSafe() are shared between threads,
+ * otherwise each thread uses its own copy of the filter created with AtFilter::Clone(). If the filter
+ * can do neither it is run on a single thread. InitEvent() and IsGoodEvent() are always called
+ * serially.
+ */
 class AtFilterTask : public FairTask {
 
 private:
@@ -23,6 +37,10 @@ private:
    Bool_t fFilterAux{false};
    Bool_t fFilterFPN{false};
    Bool_t fFilterPads{true};
+   Int_t fNumThreads{1};
+
+   std::vector<AtFilter *> fThFilter;                   //! Filter used by each thread
+   std::vector<std::unique_ptr<AtFilter>> fFilterCopies; //! Owned copies of fFilter used by threads
 
    TString fInputBranchName{"AtRawEvent"};
    TString fOutputBranchName{"AtRawEventFiltered"};
@@ -37,9 +55,14 @@ public:
    void SetFilterFPN(Bool_t value) { fFilterFPN = value; }
    void SetInputBranch(TString name) { fInputBranchName = name; }
    void SetOutputBranch(TString name) { fOutputBranchName = name; }
+   void SetNumThreads(Int_t numThreads) { fNumThreads = numThreads; }
    virtual InitStatus Init() override;
    virtual void Exec(Option_t *opt) override;
 
+private:
+   void setupThreadFilters();
+   void runOnThreads(std::size_t numItems, const std::function<void(AtFilter *, std::size_t, std::size_t)> &func);
+
    ClassDefOverride(AtFilterTask, 1)
 };
 #endif //#ifndef ATFILTERTASK_H
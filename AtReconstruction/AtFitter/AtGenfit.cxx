@@ -14,6 +14,7 @@
 #include <TGeoMaterial.h>
 #include <TGeoMaterialInterface.h>
 #include <TGeoMedium.h>
+#include <TGeoNavigator.h>
 #include <TGeoVolume.h>
 #include <TMath.h>
 #include <TMatrixDSymfwd.h>
@@ -40,26 +41,123 @@
 #include <MeasurementProducer.h>
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <iostream>
+#include <thread>
 #include <tuple>
 #include <utility>
 
 using XYZPoint = ROOT::Math::XYZPoint;
 
+namespace {
+constexpr double cMaxXtrLength = 199;  // cm, as far back as the fixed step search went
+constexpr double cFirstXtrStep = 0.5;  // cm
+constexpr double cMaxXtrStep = 4;      // cm, must be less than half a turn of the track
+constexpr double cXtrTolerance = 1e-3; // cm
+
+/// Rate at which the distance to the beam axis grows along the track, times that distance
+double approachRate(const genfit::MeasuredStateOnPlane &state)
+{
+   auto pos = state.getPos();
+   auto mom = state.getMom();
+   return (pos.X() * mom.X() + pos.Y() * mom.Y()) / mom.Mag();
+}
+
+/**
+ * Extrapolate state backwards (against its momentum) to the first point of closest approach to the beam
+ * (z) axis, at most cMaxXtrLength away. The minimum is bracketed by stepping back with growing steps
+ * until approachRate changes sign, and then refined as the root of approachRate. Each evaluation
+ * propagates from the previous one, so the cost is a handful of short propagations.
+ * Returns the (negative) length extrapolated in cm, and adds the number of propagations to numExtrap.
+ */
+double extrapolateToBeamPOCA(genfit::AbsTrackRep *rep, genfit::MeasuredStateOnPlane &state, int &numExtrap)
+{
+   double s = 0;
+   double g = approachRate(state);
+   if (g <= 0)
+      return s;
+
+   // Bracket the minimum, where g goes from positive to negative, stepping backwards
+   double sHigh = 0;
+   double gHigh = g;
+   double step = cFirstXtrStep;
+   while (g > 0) {
+      if (s <= -cMaxXtrLength)
+         return s;
+      double next = std::max(s - step, -cMaxXtrLength);
+      rep->extrapolateBy(state, next - s);
+      ++numExtrap;
+      s = next;
+      g = approachRate(state);
+      if (g > 0) {
+         sHigh = s;
+         gHigh = g;
+      }
+      step = std::min(2 * step, cMaxXtrStep);
+   }
+   double sLow = s;
+   double gLow = g;
+
+   // Illinois variant of regula falsi for the root of g
+   int lastSide = 0;
+   for (int i = 0; i < 50; ++i) {
+      double next = (sLow * gHigh - sHigh * gLow) / (gHigh - gLow);
+      bool done = std::abs(next - s) < cXtrTolerance;
+      rep->extrapolateBy(state, next - s);
+      ++numExtrap;
+      s = next;
+      if (done)
+         break;
+      g = approachRate(state);
+      if (g > 0) {
+         sHigh = s;
+         gHigh = g;
+         if (lastSide == 1)
+            gLow /= 2;
+         lastSide = 1;
+      } else {
+         sLow = s;
+         gLow = g;
+         if (lastSide == -1)
+            gHigh /= 2;
+         lastSide = -1;
+      }
+   }
+   return s;
+}
+} // namespace
+
+AtFITTER::AtGenfit::FitContext::FitContext(Int_t detID)
+   : fKalmanFitter(std::make_unique<genfit::KalmanFitterRefTrack>()),
+     fGenfitTrackArray(std::make_unique<TClonesArray>("genfit::Track")),
+     fHitClusterArray(std::make_unique<TClonesArray>("AtHitCluster")),
+     fMeasurementFactory(std::make_unique<genfit::MeasurementFactory<genfit::AbsMeasurement>>())
+{
+   fMeasurementFactory->addProducer(
+      detID, new genfit::MeasurementProducer<AtHitCluster, genfit::AtSpacepointMeasurement>(fHitClusterArray.get()));
+}
+
+// Tracks reference the measurement factory, so they are cleared first
+AtFITTER::AtGenfit::FitContext::~FitContext()
+{
+   Clear();
+}
+
+void AtFITTER::AtGenfit::FitContext::Clear()
+{
+   fHitClusterArray->Delete();
+   fGenfitTrackArray->Delete();
+}
+
 AtFITTER::AtGenfit::AtGenfit(Float_t magfield, Float_t minbrho, Float_t maxbrho, std::string eLossFile,
                              Float_t gasMediumDensity, Int_t pdg, Int_t minit, Int_t maxit, Bool_t noMatEffects)
-   : fEnergyLossFile(std::move(eLossFile)),
-     fMeasurementProducer(
-        new genfit::MeasurementProducer<AtHitCluster, genfit::AtSpacepointMeasurement>(fHitClusterArray)),
-     fMeasurementFactory(new genfit::MeasurementFactory<genfit::AbsMeasurement>()), fMinIterations(minit),
-     fMaxIterations(maxit), fMinBrho(minbrho), fMaxBrho(maxbrho), fMagneticField(10.0 * magfield), fPDGCode(pdg),
-     fGenfitTrackArray(new TClonesArray("genfit::Track")), fHitClusterArray(new TClonesArray("AtHitCluster"))
+   : fEnergyLossFile(std::move(eLossFile)), fMinIterations(minit), fMaxIterations(maxit), fMinBrho(minbrho),
+     fMaxBrho(maxbrho), fMagneticField(10.0 * magfield), fPDGCode(pdg), fNoMaterialEffects(noMatEffects)
 {
-   fKalmanFitter = std::make_shared<genfit::KalmanFitterRefTrack>();
-   fKalmanFitter->setMinIterations(fMinIterations);
-   fKalmanFitter->setMaxIterations(fMaxIterations);
-   // fKalmanFitter->setDebugLvl();
-   fMeasurementFactory->addProducer(fTPCDetID, fMeasurementProducer);
+   fContexts.push_back(std::make_unique<FitContext>(fTPCDetID));
+   fContexts[0]->fKalmanFitter->setMinIterations(fMinIterations);
+   fContexts[0]->fKalmanFitter->setMaxIterations(fMaxIterations);
 
    genfit::FieldManager::getInstance()->init(new genfit::ConstField(0., 0., fMagneticField)); // NOLINT TODO kGauss
    genfit::MaterialEffects *materialEffects = genfit::MaterialEffects::getInstance();
@@ -127,14 +225,25 @@ AtFITTER::AtGenfit::AtGenfit(Float_t magfield, Float_t minbrho, Float_t maxbrho,
 
 AtFITTER::AtGenfit::~AtGenfit()
 {
-   // delete fKalmanFitter;
-   delete fGenfitTrackArray;
-   delete fHitClusterArray;
-   delete fMeasurementProducer;
-   delete fMeasurementFactory;
    delete fPDGCandidateArray;
 }
 
+void AtFITTER::AtGenfit::SetNumThreads(Int_t numThreads)
+{
+   if (numThreads > 1)
+      ROOT::EnableThreadSafety();
+   fNumThreads = std::max(numThreads, 1);
+}
+
+/// Serializes the GENFIT calls of concurrent fits when they go through the material effects singleton.
+std::unique_lock<std::mutex> AtFITTER::AtGenfit::LockGenfit() const
+{
+   static std::mutex genfitMutex;
+   if (fNumThreads > 1 && !fNoMaterialEffects)
+      return std::unique_lock<std::mutex>(genfitMutex);
+   return {};
+}
+
 void AtFITTER::AtGenfit::Init()
 {
    LOG(debug) << cGREEN << " AtFITTER::AtGenfit::Init() " << cNORMAL << "\n";
@@ -152,13 +261,13 @@ void AtFITTER::AtGenfit::Init()
    LOG(debug) << " Energy loss file     : " << fEnergyLossFile << "\n";
    LOG(debug) << " --------------------------------------------- " << cNORMAL << "\n";
 
-   fHitClusterArray->Delete();
-   fGenfitTrackArray->Delete();
+   for (auto &context : fContexts)
+      context->Clear();
 }
 
 TClonesArray *AtFITTER::AtGenfit::GetGenfitTrackArray()
 {
-   return fGenfitTrackArray;
+   return fContexts[0]->fGenfitTrackArray.get();
 }
 
 std::vector<std::unique_ptr<AtFittedTrack>> AtFITTER::AtGenfit::ProcessTracks(std::vector<AtTrack> &tracks)
@@ -171,25 +280,6 @@ std::vector<std::unique_ptr<AtFittedTrack>> AtFITTER::AtGenfit::ProcessTracks(st
    Float_t xiniPRA = -100;
    Float_t yiniPRA = -100;
    Float_t ziniPRA = -1000;
-   Float_t EPRA = 0;
-   Float_t APRA = 0;
-   Float_t PhiPRA = 0;
-   std::string PDG = "2212";
-   Float_t xiniFit = -100;
-   Float_t yiniFit = -100;
-   Float_t ziniFit = -1000;
-   Float_t xiniFitXtr = -100;
-   Float_t yiniFitXtr = -100;
-   Float_t ziniFitXtr = -1000;
-   Float_t pVal = 0;
-   Float_t trackLength = -1000.0;
-   Float_t POCAXtr = -1000.0;
-   Int_t particleQ = -10;
-   Float_t EFit = 0;
-   Float_t EFitXtr = 0;
-   Float_t AFit = 0;
-   Float_t PhiFit = 0;
-   Float_t distXtr = -1000.0;
    //////////////////////////////
 
    // TODO
@@ -356,364 +446,392 @@ std::vector<std::unique_ptr<AtFittedTrack>> AtFITTER::AtGenfit::ProcessTracks(st
 
    eventMultiplicity = mergedTrackPool.size();
 
-   // Fitting track candidates
-   for (auto track : mergedTrackPool) {
+   // Fitting track candidates. Each thread takes the next unfitted track and uses its own context,
+   // the results are kept in the order of the track pool.
+   std::vector<std::unique_ptr<AtFittedTrack>> results(mergedTrackPool.size());
+   std::atomic<std::size_t> nextTrack{0};
+   auto fitTracks = [&](FitContext &context) {
+      for (auto i = nextTrack++; i < mergedTrackPool.size(); i = nextTrack++)
+         results[i] = FitMergedTrack(mergedTrackPool[i], trackID, context);
+   };
+
+   auto numThreads = std::min<std::size_t>(fNumThreads, mergedTrackPool.size());
+   if (numThreads <= 1) {
+      fitTracks(*fContexts[0]);
+   } else {
+      // Each thread needs its own navigator for the material lookups
+      if (gGeoManager && !gGeoManager->IsMultiThread())
+         gGeoManager->SetMaxThreads(fNumThreads);
+      while (fContexts.size() < numThreads)
+         fContexts.push_back(std::make_unique<FitContext>(fTPCDetID));
+      for (auto &context : fContexts) {
+         context->fKalmanFitter->setMinIterations(fMinIterations);
+         context->fKalmanFitter->setMaxIterations(fMaxIterations);
+      }
 
-      if (fEnableReclustering) {
-         track.ResetHitClusterArray();
-         fTrackTransformer->ClusterizeSmooth3D(track, fClusterRadius,
-                                               fClusterSize); // NB: Just for analysis benchmarking
+      std::vector<std::thread> threads;
+      for (std::size_t th = 0; th < numThreads; ++th) {
+         threads.emplace_back([&fitTracks, context = fContexts[th].get()]() {
+            TGeoNavigator *navigator = nullptr;
+            if (gGeoManager && gGeoManager->GetCurrentNavigator() == nullptr)
+               navigator = gGeoManager->AddNavigator();
+            fitTracks(*context);
+            if (navigator)
+               gGeoManager->RemoveNavigator(navigator);
+         });
       }
+      for (auto &th : threads)
+         th.join();
+   }
 
-      Double_t theta = track.GetGeoTheta();
-      Double_t radius = track.GetGeoRadius() / 1000.0; // mm to m
-      Double_t phi = track.GetGeoPhi();
-      Double_t brho = (fMagneticField / 10.0) * radius / TMath::Sin(theta); // Tm
-      Double_t points = track.GetHitArray().size();
+   for (auto &fittedTrack : results)
+      if (fittedTrack)
+         fittedTracks.push_back(std::move(fittedTrack));
 
-      std::cout << "      Merged track - Theta : " << theta * TMath::RadToDeg() << " Phi : " << phi * TMath::RadToDeg()
-                << "\n";
+   // std::cout<<" Fitted tracks "<<fittedTracks.size()<<"\n";
+   return std::move(fittedTracks);
+}
 
-      auto hitClusterArray = track.GetHitClusterArray();
-      AtHitCluster iniCluster;
-      Double_t zIniCal = 0;
-      ROOT::Math::XYZPoint iniPos;
+/**
+ * Fit a single track from the merged track pool using the arrays and fitter of context.
+ * Returns nullptr if the fit failed.
+ */
+std::unique_ptr<AtFittedTrack> AtFITTER::AtGenfit::FitMergedTrack(AtTrack track, Int_t trackID, FitContext &context)
+{
+   Float_t xiniPRA = -100;
+   Float_t yiniPRA = -100;
+   Float_t ziniPRA = -1000;
+   Float_t EPRA = 0;
+   Float_t APRA = 0;
+   Float_t PhiPRA = 0;
+   std::string PDG = "2212";
+   Float_t xiniFit = -100;
+   Float_t yiniFit = -100;
+   Float_t ziniFit = -1000;
+   Float_t xiniFitXtr = -100;
+   Float_t yiniFitXtr = -100;
+   Float_t ziniFitXtr = -1000;
+   Float_t pVal = 0;
+   Float_t trackLength = -1000.0;
+   Float_t POCAXtr = -1000.0;
+   Int_t particleQ = -10;
+   Float_t EFit = 0;
+   Float_t EFitXtr = 0;
+   Float_t AFit = 0;
+   Float_t PhiFit = 0;
+   Float_t distXtr = -1000.0;
 
-      // for(auto hitCluster : *hitClusterArray)
-      // std::cout<<" Cluster hit "<<hitCluster.GetHitID()<<" - "<<hitCluster.GetPosition().X()<<" -
-      // "<<hitCluster.GetPosition().Y()<<" - "<<1000.0-hitCluster.GetPosition().Z()<<"\n";
+   if (fEnableReclustering) {
+      track.ResetHitClusterArray();
+      fTrackTransformer->ClusterizeSmooth3D(track, fClusterRadius, fClusterSize); // NB: Just for analysis benchmarking
+   }
 
-      // Variable for convention (simulation comes reversed)
-      Double_t thetaConv;
-      if (fSimulationConv) {
-         thetaConv = 180.0 - theta * TMath::RadToDeg();
-      } else {
-         thetaConv = theta * TMath::RadToDeg();
-      }
+   Double_t theta = track.GetGeoTheta();
+   Double_t radius = track.GetGeoRadius() / 1000.0; // mm to m
+   Double_t phi = track.GetGeoPhi();
+   Double_t brho = (fMagneticField / 10.0) * radius / TMath::Sin(theta); // Tm
+   Double_t points = track.GetHitArray().size();
 
-      if (thetaConv < 90.0) {
-         iniCluster =
-            hitClusterArray->back(); // NB: Use back because We do not reverse the cluster vector like in AtGenfit!
-         iniPos = iniCluster.GetPosition();
-         zIniCal = 1000.0 - iniPos.Z();
-      } else if (thetaConv > 90.0) {
-         iniCluster = hitClusterArray->front();
-         iniPos = iniCluster.GetPosition();
-         zIniCal = iniPos.Z();
-      }
+   LOG(debug) << "      Merged track - Theta : " << theta * TMath::RadToDeg() << " Phi : " << phi * TMath::RadToDeg()
+              << "\n";
 
-      xiniPRA = iniPos.X();
-      yiniPRA = iniPos.Y();
-      ziniPRA = zIniCal;
+   auto hitClusterArray = track.GetHitClusterArray();
+   AtHitCluster iniCluster;
+   Double_t zIniCal = 0;
+   ROOT::Math::XYZPoint iniPos;
 
-      // This is just to select distances
-      // std::cout << cGREEN << "      Merged track - Initial position : " << xiniPRA << " - " << yiniPRA << " - "
-      //         << ziniPRA << cNORMAL << "\n";
+   // for(auto hitCluster : *hitClusterArray)
+   // std::cout<<" Cluster hit "<<hitCluster.GetHitID()<<" - "<<hitCluster.GetPosition().X()<<" -
+   // "<<hitCluster.GetPosition().Y()<<" - "<<1000.0-hitCluster.GetPosition().Z()<<"\n";
 
-      // Skip border angles
-      //    if (theta * TMath::RadToDeg() < 5 || theta * TMath::RadToDeg() > 175)
-      // continue;
-      // Skip tracks that are far from Z (to be checked against number of iterations for extrapolation)
-      Double_t dist = TMath::Sqrt(iniPos.X() * iniPos.X() + iniPos.Y() * iniPos.Y());
+   // Variable for convention (simulation comes reversed)
+   Double_t thetaConv;
+   if (fSimulationConv) {
+      thetaConv = 180.0 - theta * TMath::RadToDeg();
+   } else {
+      thetaConv = theta * TMath::RadToDeg();
+   }
 
-      std::cout << KRED << "       Merged track - Distance to Z (Candidate Track Pool) " << dist << cNORMAL << "\n";
+   if (thetaConv < 90.0) {
+      iniCluster =
+         hitClusterArray->back(); // NB: Use back because We do not reverse the cluster vector like in AtGenfit!
+      iniPos = iniCluster.GetPosition();
+      zIniCal = 1000.0 - iniPos.Z();
+   } else if (thetaConv > 90.0) {
+      iniCluster = hitClusterArray->front();
+      iniPos = iniCluster.GetPosition();
+      zIniCal = iniPos.Z();
+   }
 
-      Init();
+   xiniPRA = iniPos.X();
+   yiniPRA = iniPos.Y();
+   ziniPRA = zIniCal;
 
-      std::vector<Int_t> pdgCandFit;
-      if (thetaConv > 90) {
+   // This is just to select distances
+   // std::cout << cGREEN << "      Merged track - Initial position : " << xiniPRA << " - " << yiniPRA << " - "
+   //         << ziniPRA << cNORMAL << "\n";
 
-         switch (fExpNum) {
-         case e20020: pdgCandFit.push_back(1000010020); break;
-         case e20009: pdgCandFit.push_back(2212); break;
-         case a1975: pdgCandFit.push_back(1000010020); break;
-         default: pdgCandFit.push_back(2212);
-         }
+   // Skip border angles
+   //    if (theta * TMath::RadToDeg() < 5 || theta * TMath::RadToDeg() > 175)
+   // continue;
+   // Skip tracks that are far from Z (to be checked against number of iterations for extrapolation)
+   Double_t dist = TMath::Sqrt(iniPos.X() * iniPos.X() + iniPos.Y() * iniPos.Y());
 
-      } else if (thetaConv < 90 && thetaConv > 10) {
-
-         switch (fExpNum) {
-         case e20020: pdgCandFit.push_back(1000020040); break;
-         case e20009: pdgCandFit.push_back(1000010020); break;
-         case a1954: pdgCandFit.push_back(2212); break;
-         case a1954b: pdgCandFit.push_back(2212); break;
-         // case a1954b: pdgCandFit.push_back(1000010020); break;
-         // case a1975: pdgCandFit.push_back(2212); break;
-         case a1975: pdgCandFit.push_back(1000010020); break;
-         default: pdgCandFit.push_back(2212);
-         }
+   LOG(debug) << KRED << "       Merged track - Distance to Z (Candidate Track Pool) " << dist << cNORMAL << "\n";
 
-      } else if (thetaConv < 10) {
+   context.Clear();
 
-         switch (fExpNum) {
-         case e20009:
-            pdgCandFit.push_back(1000040100);
-            break;
-            // pdgCandFit.push_back(1000040110);
-         default: pdgCandFit.push_back(2212);
-         }
+   std::vector<Int_t> pdgCandFit;
+   if (thetaConv > 90) {
+
+      switch (fExpNum) {
+      case e20020: pdgCandFit.push_back(1000010020); break;
+      case e20009: pdgCandFit.push_back(2212); break;
+      case a1975: pdgCandFit.push_back(1000010020); break;
+      default: pdgCandFit.push_back(2212);
       }
 
-      try {
+   } else if (thetaConv < 90 && thetaConv > 10) {
+
+      switch (fExpNum) {
+      case e20020: pdgCandFit.push_back(1000020040); break;
+      case e20009: pdgCandFit.push_back(1000010020); break;
+      case a1954: pdgCandFit.push_back(2212); break;
+      case a1954b: pdgCandFit.push_back(2212); break;
+      // case a1954b: pdgCandFit.push_back(1000010020); break;
+      // case a1975: pdgCandFit.push_back(2212); break;
+      case a1975: pdgCandFit.push_back(1000010020); break;
+      default: pdgCandFit.push_back(2212);
+      }
 
-         genfit::Track *fitTrack = FitTracks(&track);
-
-         Int_t atomicNumber = fAtomicNumber;
-         Double_t mass = fMass;
-         Double_t M_Ener = mass * 931.49401 / 1000.0;
-
-         // PDG needs to be defined
-         Int_t pdg = pdgCandFit.at(0);
-
-         /*auto fIl =
-            std::find_if(ionList->begin(), ionList->end(), [&pdg](AtTools::IonFitInfo ion) { return ion._PDG == pdg; });
-         if (fIl != ionList->end()) {
-
-            int index = std::distance(ionList->begin(), fIl);
-            std::cout << cBLUE << "  -  Ion info for : " << pdg << " found in " << index << cNORMAL << "\n";
-            atomicNumber = ionList->at(index)._atomicNumber;
-            mass = ionList->at(index)._mass;
-            M_Ener = mass * 931.49401 / 1000.0;
-         }*/
-
-         // Kinematics from PRA
-
-         std::tuple<Double_t, Double_t> mom_ener = fKinematics->GetMomFromBrho(mass, atomicNumber, brho);
-         EPRA = std::get<1>(mom_ener) * 1000.0;
-         APRA = theta * TMath::RadToDeg();
-         PhiPRA = phi * TMath::RadToDeg();
-
-         // Extract info from Fit track
-
-         PDG = std::to_string(pdg);
-
-         TVector3 pos_res;
-         TVector3 mom_res;
-         TMatrixDSym cov_res;
-
-         Double_t bChi2 = 0, fChi2 = 0, bNdf = 0, fNdf = 0;
-         Double_t distance = -100;
-         Double_t POCA = 1E6;
-         TVector3 mom_ext;
-         TVector3 pos_ext;
-         TVector3 mom_ext_buff;
-         TVector3 pos_ext_buff;
-         Int_t nSteps = 0;
-
-         // First orbit
-         Double_t POCAOrbZ = 1E6;
-         Double_t firstOrbZ = 0.0;
-         Double_t phiOrbZ = 0.0;
-         Double_t lengthOrbZ = 0.0;
-         Double_t eLossOrbZ = 0.0;
-
-         // Fit convergence
-         Int_t fitConverged = 0;
-
-         // Reset variables assigned in fitting
-         pVal = -1;
-         trackLength = 0;
-         xiniFitXtr = -1000.0;
-         yiniFitXtr = -1000.0;
-         ziniFitXtr = -1E4;
-         xiniFit = -1000.0;
-         yiniFit = -1000.0;
-         ziniFit = -1E4;
-         POCAXtr = -1000.0;
-         EFit = -10.0;
-         EFitXtr = -10.0;
-         AFit = 0.0;
-         PhiFit = 0.0;
-         particleQ = -10.0;
-
-         // PID
-         Double_t len = 0;
-         Double_t eloss = 0;
-         Double_t dedx = 0;
-
-         // Energy loss from ADC
-         auto hitClusterArray = track.GetHitClusterArray();
-         std::size_t cnt = 0;
-
-         if (thetaConv < 90) {
-
-            auto it = hitClusterArray->rbegin();
-            while (it != hitClusterArray->rend()) {
-
-               if (((Float_t)cnt / (Float_t)hitClusterArray->size()) > 0.8)
-                  break;
-               auto dir = (*it).GetPosition() - (*std::next(it, 1)).GetPosition();
-               eloss += (*it).GetCharge();
-               len = std::sqrt(dir.Mag2());
-               dedx += (*it).GetCharge();
-               // std::cout<<(*it).GetCharge()<<"\n";
-               it++;
-               ++cnt;
-            }
-         } else if (thetaConv > 90) {
+   } else if (thetaConv < 10) {
 
-            eloss += hitClusterArray->at(0).GetCharge();
+      switch (fExpNum) {
+      case e20009:
+         pdgCandFit.push_back(1000040100);
+         break;
+         // pdgCandFit.push_back(1000040110);
+      default: pdgCandFit.push_back(2212);
+      }
+   }
 
-            cnt = 1;
-            for (auto iHitClus = 1; iHitClus < hitClusterArray->size(); ++iHitClus) {
+   try {
 
-               if (((Float_t)cnt / (Float_t)hitClusterArray->size()) > 0.8)
-                  break;
-               auto dir = hitClusterArray->at(iHitClus).GetPosition() - hitClusterArray->at(iHitClus - 1).GetPosition();
-               len = std::sqrt(dir.Mag2());
-               eloss += hitClusterArray->at(iHitClus).GetCharge();
-               dedx += hitClusterArray->at(iHitClus).GetCharge();
-               // std::cout<<len<<" - "<<eloss<<" - "<<hitClusterArray->at(iHitClus).GetCharge()<<"\n";
-               ++cnt;
-            }
+      genfit::Track *fitTrack = FitTracks(&track, context);
+
+      Int_t atomicNumber = fAtomicNumber;
+      Double_t mass = fMass;
+      Double_t M_Ener = mass * 931.49401 / 1000.0;
+
+      // PDG needs to be defined
+      Int_t pdg = pdgCandFit.at(0);
+
+      /*auto fIl =
+         std::find_if(ionList->begin(), ionList->end(), [&pdg](AtTools::IonFitInfo ion) { return ion._PDG == pdg; });
+      if (fIl != ionList->end()) {
+
+         int index = std::distance(ionList->begin(), fIl);
+         LOG(debug) << cBLUE << "  -  Ion info for : " << pdg << " found in " << index << cNORMAL << "\n";
+         atomicNumber = ionList->at(index)._atomicNumber;
+         mass = ionList->at(index)._mass;
+         M_Ener = mass * 931.49401 / 1000.0;
+      }*/
+
+      // Kinematics from PRA
+
+      std::tuple<Double_t, Double_t> mom_ener = fKinematics->GetMomFromBrho(mass, atomicNumber, brho);
+      EPRA = std::get<1>(mom_ener) * 1000.0;
+      APRA = theta * TMath::RadToDeg();
+      PhiPRA = phi * TMath::RadToDeg();
+
+      // Extract info from Fit track
+
+      PDG = std::to_string(pdg);
+
+      TVector3 pos_res;
+      TVector3 mom_res;
+      TMatrixDSym cov_res;
+
+      Double_t bChi2 = 0, fChi2 = 0, bNdf = 0, fNdf = 0;
+      Double_t distance = -100;
+      Double_t POCA = 1E6;
+      TVector3 mom_ext;
+      TVector3 pos_ext;
+
+      // First orbit
+      Double_t POCAOrbZ = 1E6;
+      Double_t firstOrbZ = 0.0;
+      Double_t phiOrbZ = 0.0;
+      Double_t lengthOrbZ = 0.0;
+      Double_t eLossOrbZ = 0.0;
+
+      // Fit convergence
+      Int_t fitConverged = 0;
+
+      // Reset variables assigned in fitting
+      pVal = -1;
+      trackLength = 0;
+      xiniFitXtr = -1000.0;
+      yiniFitXtr = -1000.0;
+      ziniFitXtr = -1E4;
+      xiniFit = -1000.0;
+      yiniFit = -1000.0;
+      ziniFit = -1E4;
+      POCAXtr = -1000.0;
+      EFit = -10.0;
+      EFitXtr = -10.0;
+      AFit = 0.0;
+      PhiFit = 0.0;
+      particleQ = -10.0;
+
+      // PID
+      Double_t len = 0;
+      Double_t eloss = 0;
+      Double_t dedx = 0;
+
+      // Energy loss from ADC
+      auto hitClusterArray = track.GetHitClusterArray();
+      std::size_t cnt = 0;
+
+      if (thetaConv < 90) {
+
+         auto it = hitClusterArray->rbegin();
+         while (it != hitClusterArray->rend()) {
+
+            if (((Float_t)cnt / (Float_t)hitClusterArray->size()) > 0.8)
+               break;
+            auto dir = (*it).GetPosition() - (*std::next(it, 1)).GetPosition();
+            eloss += (*it).GetCharge();
+            len = std::sqrt(dir.Mag2());
+            dedx += (*it).GetCharge();
+            // std::cout<<(*it).GetCharge()<<"\n";
+            it++;
+            ++cnt;
          }
+      } else if (thetaConv > 90) {
 
-         eloss /= cnt;
-         // dedx /= len;
-
-         if (fitTrack == nullptr)
-            continue;
-
-         try {
+         eloss += hitClusterArray->at(0).GetCharge();
 
-            if (fitTrack && fitTrack->hasKalmanFitStatus()) {
+         cnt = 1;
+         for (auto iHitClus = 1; iHitClus < hitClusterArray->size(); ++iHitClus) {
 
-               auto KalmanFitStatus = fitTrack->getKalmanFitStatus();
-               auto trackRep = fitTrack->getTrackRep(0); // Only one representation is sved for the moment.
-               fitConverged = KalmanFitStatus->isFitConverged(false);
-
-               if (KalmanFitStatus->isFitConverged(false)) {
-                  // KalmanFitStatus->Print();
-                  genfit::MeasuredStateOnPlane fitState = fitTrack->getFittedState();
-                  particleQ = fitState.getCharge();
+            if (((Float_t)cnt / (Float_t)hitClusterArray->size()) > 0.8)
+               break;
+            auto dir = hitClusterArray->at(iHitClus).GetPosition() - hitClusterArray->at(iHitClus - 1).GetPosition();
+            len = std::sqrt(dir.Mag2());
+            eloss += hitClusterArray->at(iHitClus).GetCharge();
+            dedx += hitClusterArray->at(iHitClus).GetCharge();
+            // std::cout<<len<<" - "<<eloss<<" - "<<hitClusterArray->at(iHitClus).GetCharge()<<"\n";
+            ++cnt;
+         }
+      }
 
-                  fChi2 = KalmanFitStatus->getForwardChi2();
-                  bChi2 = KalmanFitStatus->getBackwardChi2();
-                  fNdf = KalmanFitStatus->getForwardNdf();
-                  bNdf = KalmanFitStatus->getBackwardNdf();
-                  // fitState.Print();
-                  fitState.getPosMomCov(pos_res, mom_res, cov_res);
-                  trackLength = KalmanFitStatus->getTrackLen();
-                  pVal = KalmanFitStatus->getPVal();
+      eloss /= cnt;
+      // dedx /= len;
 
-                  // fKalmanFitter -> getChiSquNdf(gfTrack, trackRep, bChi2, fChi2, bNdf, fNdf);
-                  Float_t stepXtr = -0.01;
-                  Int_t minCnt = 0;
-                  Int_t minCntExt = 0;
+      if (fitTrack == nullptr)
+         return nullptr;
 
-                  TVector3 pos_ini_buff = pos_res;
-                  Double_t length = 0.0;
+      try {
+         // The extrapolation to the beam goes through the material effects
+         auto lock = LockGenfit();
+
+         if (fitTrack && fitTrack->hasKalmanFitStatus()) {
+
+            auto KalmanFitStatus = fitTrack->getKalmanFitStatus();
+            auto trackRep = fitTrack->getTrackRep(0); // Only one representation is sved for the moment.
+            fitConverged = KalmanFitStatus->isFitConverged(false);
+
+            if (KalmanFitStatus->isFitConverged(false)) {
+               // KalmanFitStatus->Print();
+               genfit::MeasuredStateOnPlane fitState = fitTrack->getFittedState();
+               particleQ = fitState.getCharge();
+
+               fChi2 = KalmanFitStatus->getForwardChi2();
+               bChi2 = KalmanFitStatus->getBackwardChi2();
+               fNdf = KalmanFitStatus->getForwardNdf();
+               bNdf = KalmanFitStatus->getBackwardNdf();
+               // fitState.Print();
+               fitState.getPosMomCov(pos_res, mom_res, cov_res);
+               trackLength = KalmanFitStatus->getTrackLen();
+               pVal = KalmanFitStatus->getPVal();
+
+               // fKalmanFitter -> getChiSquNdf(gfTrack, trackRep, bChi2, fChi2, bNdf, fNdf);
+               mom_ext = fitState.getMom();
+               pos_ext = fitState.getPos();
+
+               // Backward extrapolation
+               Int_t numExtrap = 0;
+               try {
+                  distXtr = extrapolateToBeamPOCA(trackRep, fitState, numExtrap);
                   mom_ext = fitState.getMom();
                   pos_ext = fitState.getPos();
-
-                  // Backward extrapolation
-                  try {
-
-                     for (auto iStep = 0; iStep < 200; ++iStep) {
-
-                        trackRep->extrapolateBy(fitState, stepXtr * iStep);
-                        mom_ext_buff = fitState.getMom();
-                        pos_ext_buff = fitState.getPos();
-
-                        length += (pos_ext_buff - pos_ini_buff).Mag();
-                        pos_ini_buff = pos_ext_buff;
-
-                        double distPOCA =
-                           TMath::Sqrt(pos_ext_buff.X() * pos_ext_buff.X() + pos_ext_buff.Y() * pos_ext_buff.Y());
-                        // if (fVerbosityLevel > 2){
-                        // std::cout << cYELLOW << " Extrapolation: Total Momentum : " << mom_ext_buff.Mag()
-                        //        << " - Position : " << pos_ext_buff.X() << "  " << pos_ext_buff.Y() << "  "
-                        //      << pos_ext_buff.Z() << " - distance of approach : " << distance <<" - length :
-                        //  "<<length<< cNORMAL << "\n";
-                        //}
-
-                        // if(pos_ext_buff.Z()<0)
-                        // break;
-
-                        if (distPOCA < POCA) {
-                           POCA = distPOCA;
-                           POCAXtr = distPOCA;
-                           mom_ext = mom_ext_buff;
-                           pos_ext = pos_ext_buff;
-                           distXtr = iStep * stepXtr;
-                           ++minCnt;
-                           minCntExt = 0;
-                           nSteps = iStep;
-                        } else {
-
-                           break;
-                        }
-
-                        ++minCntExt;
-                     } // Extrapolation loop
-
-                  } catch (genfit::Exception &e) {
-                     mom_ext.SetXYZ(0, 0, 0);
-                     pos_ext.SetXYZ(0, 0, 0);
-                  } // try
-
-                  // mom_res = mom_ext;
-                  // pos_res = pos_ext;
-                  xiniFitXtr = pos_ext.X();
-                  yiniFitXtr = pos_ext.Y();
-                  ziniFitXtr = pos_ext.Z();
-
-                  // std::cout << cYELLOW << " Extrapolation: Total Momentum : " << mom_ext.Mag()
-                  // << " - Position : " << pos_ext.X() << "  " << pos_ext.Y() << "  " << pos_ext.Z()
-                  // << " - POCA : " << POCA << " - Steps : " << nSteps << cNORMAL << "\n";
-
-                  Double_t thetaA = 0.0;
-                  if (thetaConv > 90.0) {
-                     thetaA = 180.0 * TMath::DegToRad() - mom_res.Theta();
-
-                  } else {
-                     thetaA = mom_res.Theta();
-                  }
-
-                  Double_t E = TMath::Sqrt(TMath::Power(mom_res.Mag(), 2) + TMath::Power(M_Ener, 2)) - M_Ener;
-                  EFit = E * 1000.0;
-                  EFitXtr = 1000.0 * (TMath::Sqrt(TMath::Power(mom_ext.Mag(), 2) + TMath::Power(M_Ener, 2)) - M_Ener);
-                  std::cout << " Energy : " << E * 1000.0 << " - Energy Xtr : " << EFitXtr << "\n";
-                  AFit = thetaA * TMath::RadToDeg();
-                  PhiFit = mom_res.Phi();
-                  xiniFit = pos_res.X();
-                  yiniFit = pos_res.Y();
-                  ziniFit = pos_res.Z();
-
-               } // Kalman fit
-
-            } // Kalman status
-
-         } catch (std::exception &e) {
-            std::cout << " " << e.what() << "\n";
-            continue;
-         }
-
-         ROOT::Math::XYZVector iniFitVec(xiniFit, yiniFit, ziniFit);
-         ROOT::Math::XYZVector iniFitXtrVec(xiniPRA, yiniPRA, ziniPRA);
-         ROOT::Math::XYZVector iniPRAVec(xiniPRA, yiniPRA, ziniPRA);
-
-         // NB: Here need the data block
-         std::unique_ptr<AtFittedTrack> fittedTrack = std::make_unique<AtFittedTrack>();
-         fittedTrack->SetTrackID(trackID);
-         fittedTrack->SetEnergyAngles(EFit, EFitXtr, AFit, PhiFit, EPRA, APRA, PhiPRA);
-         fittedTrack->SetVertexPosition(iniFitVec, iniPRAVec, iniFitXtrVec);
-         fittedTrack->SetStats(pVal, fChi2, bChi2, fNdf, bNdf, fitConverged);
-         fittedTrack->SetTrackProperties(particleQ, brho, eloss, dedx, std::to_string(pdg), points);
-         // fittedTrack->SetIonChamber(Float_t icenergy, Int_t ictime);
-         // fittedTrack->SetExcitationEnergy(Float_t exenergy, Float_t exenergyxtr);
-         fittedTrack->SetDistances(distXtr, trackLength, POCA);
-         fittedTracks.push_back(std::move(fittedTrack));
+                  POCA = TMath::Sqrt(pos_ext.X() * pos_ext.X() + pos_ext.Y() * pos_ext.Y());
+                  POCAXtr = POCA;
+                  LOG(debug) << "Extrapolated " << distXtr << " cm to POCA " << POCA << " cm with " << numExtrap
+                             << " propagations";
+               } catch (genfit::Exception &e) {
+                  mom_ext.SetXYZ(0, 0, 0);
+                  pos_ext.SetXYZ(0, 0, 0);
+               } // try
+
+               // mom_res = mom_ext;
+               // pos_res = pos_ext;
+               xiniFitXtr = pos_ext.X();
+               yiniFitXtr = pos_ext.Y();
+               ziniFitXtr = pos_ext.Z();
+
+               // std::cout << cYELLOW << " Extrapolation: Total Momentum : " << mom_ext.Mag()
+               // << " - Position : " << pos_ext.X() << "  " << pos_ext.Y() << "  " << pos_ext.Z()
+               // << " - POCA : " << POCA << " - Steps : " << numExtrap << cNORMAL << "\n";
+
+               Double_t thetaA = 0.0;
+               if (thetaConv > 90.0) {
+                  thetaA = 180.0 * TMath::DegToRad() - mom_res.Theta();
+
+               } else {
+                  thetaA = mom_res.Theta();
+               }
+
+               Double_t E = TMath::Sqrt(TMath::Power(mom_res.Mag(), 2) + TMath::Power(M_Ener, 2)) - M_Ener;
+               EFit = E * 1000.0;
+               EFitXtr = 1000.0 * (TMath::Sqrt(TMath::Power(mom_ext.Mag(), 2) + TMath::Power(M_Ener, 2)) - M_Ener);
+               LOG(debug) << " Energy : " << E * 1000.0 << " - Energy Xtr : " << EFitXtr << "\n";
+               AFit = thetaA * TMath::RadToDeg();
+               PhiFit = mom_res.Phi();
+               xiniFit = pos_res.X();
+               yiniFit = pos_res.Y();
+               ziniFit = pos_res.Z();
+
+            } // Kalman fit
+
+         } // Kalman status
 
       } catch (std::exception &e) {
-         std::cout << " Exception fitting track !" << e.what() << "\n";
-         continue;
+         LOG(error) << " " << e.what() << "\n";
+         return nullptr;
       }
 
-   } // Merged track loop
-
-   // std::cout<<" Fitted tracks "<<fittedTracks.size()<<"\n";
-   return std::move(fittedTracks);
+      ROOT::Math::XYZVector iniFitVec(xiniFit, yiniFit, ziniFit);
+      ROOT::Math::XYZVector iniFitXtrVec(xiniPRA, yiniPRA, ziniPRA);
+      ROOT::Math::XYZVector iniPRAVec(xiniPRA, yiniPRA, ziniPRA);
+
+      // NB: Here need the data block
+      std::unique_ptr<AtFittedTrack> fittedTrack = std::make_unique<AtFittedTrack>();
+      fittedTrack->SetTrackID(trackID);
+      fittedTrack->SetEnergyAngles(EFit, EFitXtr, AFit, PhiFit, EPRA, APRA, PhiPRA);
+      fittedTrack->SetVertexPosition(iniFitVec, iniPRAVec, iniFitXtrVec);
+      fittedTrack->SetStats(pVal, fChi2, bChi2, fNdf, bNdf, fitConverged);
+      fittedTrack->SetTrackProperties(particleQ, brho, eloss, dedx, std::to_string(pdg), points);
+      // fittedTrack->SetIonChamber(Float_t icenergy, Int_t ictime);
+      // fittedTrack->SetExcitationEnergy(Float_t exenergy, Float_t exenergyxtr);
+      fittedTrack->SetDistances(distXtr, trackLength, POCA);
+      return fittedTrack;
+
+   } catch (std::exception &e) {
+      LOG(error) << " Exception fitting track !" << e.what() << "\n";
+      return nullptr;
+   }
 }
 
 /**
@@ -721,6 +839,11 @@ std::vector<std::unique_ptr<AtFittedTrack>> AtFITTER::AtGenfit::ProcessTracks(st
  * Radius from track is used to construct the magnitude of the initial momentum of the track.
  */
 genfit::Track *AtFITTER::AtGenfit::FitTracks(AtTrack *track)
+{
+   return FitTracks(track, *fContexts[0]);
+}
+
+genfit::Track *AtFITTER::AtGenfit::FitTracks(AtTrack *track, FitContext &context)
 {
 
    // std::vector<genfit::Track> genfitTrackArray;
@@ -731,7 +854,7 @@ genfit::Track *AtFITTER::AtGenfit::FitTracks(AtTrack *track)
    //<< cNORMAL << "\n";
 
    // for (auto track : patternTrackCand) {
-   fHitClusterArray->Delete();
+   context.fHitClusterArray->Delete();
    genfit::TrackCand trackCand;
 
    auto hitClusterArray = track->GetHitClusterArray();
@@ -740,17 +863,17 @@ genfit::Track *AtFITTER::AtGenfit::FitTracks(AtTrack *track)
    TVector3 mom_res;
    TMatrixDSym cov_res;
 
-   std::cout << cYELLOW << " Track " << track->GetTrackID() << " with " << hitClusterArray->size() << " clusters "
-             << cNORMAL << "\n";
+   LOG(debug) << cYELLOW << " Track " << track->GetTrackID() << " with " << hitClusterArray->size() << " clusters "
+              << cNORMAL << "\n";
 
    if (hitClusterArray->size() < 3) //&& patternTrackCand.size()<5) { // TODO Check minimum number of clusters
       return nullptr;
 
    if (fVerbosity > 0) {
-      std::cout << " Initial angles from PRA "
-                << "\n";
-      std::cout << " Theta : " << TMath::RadToDeg() * track->GetGeoTheta()
-                << " - Phi : " << TMath::RadToDeg() * track->GetGeoPhi() << "\n";
+      LOG(debug) << " Initial angles from PRA "
+                 << "\n";
+      LOG(debug) << " Theta : " << TMath::RadToDeg() * track->GetGeoTheta()
+                 << " - Phi : " << TMath::RadToDeg() * track->GetGeoPhi() << "\n";
    }
 
    // New angle convention
@@ -788,7 +911,7 @@ genfit::Track *AtFITTER::AtGenfit::FitTracks(AtTrack *track)
          phi = -track->GetGeoPhi();
       }
    } else {
-      std::cout << cRED << " AtGenfit::FitTracks - Warning! Undefined theta angle. Skipping event..." << cNORMAL
+      LOG(warn) << cRED << " AtGenfit::FitTracks - Warning! Undefined theta angle. Skipping event..." << cNORMAL
                 << "\n";
       return nullptr;
    }
@@ -821,13 +944,13 @@ genfit::Track *AtFITTER::AtGenfit::FitTracks(AtTrack *track)
       auto clusterClone(cluster);
 
       if (iCluster == 0) {
-         std::cout << cYELLOW << "    First cluster : " << pos.X() << " - " << pos.Y() << " - " << pos.Z() << cNORMAL
-                   << "\n";
+         LOG(debug) << cYELLOW << "    First cluster : " << pos.X() << " - " << pos.Y() << " - " << pos.Z() << cNORMAL
+                    << "\n";
 
       } else if (iCluster == (hitClusterArray->size() - 1)) {
 
-         std::cout << cYELLOW << "    Last cluster : " << pos.X() << " - " << pos.Y() << " - " << pos.Z() << cNORMAL
-                   << "\n";
+         LOG(debug) << cYELLOW << "    Last cluster : " << pos.X() << " - " << pos.Y() << " - " << pos.Z() << cNORMAL
+                    << "\n";
       }
 
       if (IsForwardTrack(thetaConv)) { // Experiment forward
@@ -842,8 +965,8 @@ genfit::Track *AtFITTER::AtGenfit::FitTracks(AtTrack *track)
             clusterClone.SetPosition({-pos.X(), pos.Y(), pos.Z()});
       }
 
-      Int_t idx = fHitClusterArray->GetEntriesFast();
-      new ((*fHitClusterArray)[idx]) AtHitCluster(clusterClone);
+      Int_t idx = context.fHitClusterArray->GetEntriesFast();
+      new ((*context.fHitClusterArray)[idx]) AtHitCluster(clusterClone);
       trackCand.addHit(fTPCDetID, idx);
       // std::cout<<" Adding  cluster "<<idx<<"\n";
       // std::cout<<pos.X()<<"     "<<pos.Y()<<"   "<<pos.Z()<<"\n";
@@ -886,7 +1009,7 @@ genfit::Track *AtFITTER::AtGenfit::FitTracks(AtTrack *track)
          xIniCal = -iniPos.X();
 
    } else {
-      std::cout << cRED << " AtGenfit::FitTracks - Warning! Undefined theta angle. Skipping event..." << cNORMAL
+      LOG(warn) << cRED << " AtGenfit::FitTracks - Warning! Undefined theta angle. Skipping event..." << cNORMAL
                 << "\n";
    }
 
@@ -897,7 +1020,7 @@ genfit::Track *AtFITTER::AtGenfit::FitTracks(AtTrack *track)
    //   return nullptr;
 
    // if(fVerbosity>1)
-   std::cout << "    Initial position : " << xIniCal << " - " << iniPos.Y() << " - " << zIniCal << "\n";
+   LOG(debug) << "    Initial position : " << xIniCal << " - " << iniPos.Y() << " - " << zIniCal << "\n";
 
    TVector3 posSeed(xIniCal / 10.0, iniPos.Y() / 10.0, zIniCal / 10.0);
    posSeed.SetMag(posSeed.Mag());
@@ -924,8 +1047,8 @@ genfit::Track *AtFITTER::AtGenfit::FitTracks(AtTrack *track)
    pz = std::get<0>(mom_ener) * mom_dir.Z();
 
    if (fVerbosity > 0)
-      std::cout << cYELLOW << "    Momentum from PRA- px : " << px << " - py : " << py << " - pz : " << pz << cNORMAL
-                << "\n";
+      LOG(debug) << cYELLOW << "    Momentum from PRA- px : " << px << " - py : " << py << " - pz : " << pz << cNORMAL
+                 << "\n";
 
    // Double_t momSeedMag = std::get<0>(mom_ener);
    //  TVector3 momSeed(0., 0., momSeedMag); //
@@ -940,17 +1063,20 @@ genfit::Track *AtFITTER::AtGenfit::FitTracks(AtTrack *track)
    if (brho > fMaxBrho && brho < fMinBrho)
       return nullptr;
 
-   auto *gfTrack = new ((*fGenfitTrackArray)[fGenfitTrackArray->GetEntriesFast()]) // NOLINT
-      genfit::Track(trackCand, *fMeasurementFactory);
+   auto &trackArray = *context.fGenfitTrackArray;
+   auto *gfTrack = new (trackArray[trackArray.GetEntriesFast()]) // NOLINT
+      genfit::Track(trackCand, *context.fMeasurementFactory);
    gfTrack->addTrackRep(new genfit::RKTrackRep(fPDGCode)); // NOLINT
 
    auto *trackRep = dynamic_cast<genfit::RKTrackRep *>(gfTrack->getTrackRep(0));
    // trackRep->setPropDir(-1);
 
+   // Held until the end of the fit, the propagation in the Kalman fitter is not thread safe
+   auto lock = LockGenfit();
    try {
-      fKalmanFitter->processTrackWithRep(gfTrack, trackRep, false);
+      context.fKalmanFitter->processTrackWithRep(gfTrack, trackRep, false);
    } catch (genfit::Exception &e) {
-      std::cout << " AtGenfit -  Exception caught from Kalman Fitter : " << e.what() << "\n";
+      LOG(error) << " AtGenfit -  Exception caught from Kalman Fitter : " << e.what() << "\n";
       return nullptr;
    }
 
@@ -979,8 +1105,8 @@ genfit::Track *AtFITTER::AtGenfit::FitTracks(AtTrack *track)
       // Fit result
       fitState.getPosMomCov(pos_res, mom_res, cov_res);
       if (fVerbosity > 0)
-         std::cout << cYELLOW << "    Total Momentum : " << mom_res.Mag() << " - Position : " << pos_res.X() << "  "
-                   << pos_res.Y() << "  " << pos_res.Z() << cNORMAL << "\n";
+         LOG(debug) << cYELLOW << "    Total Momentum : " << mom_res.Mag() << " - Position : " << pos_res.X() << "  "
+                    << pos_res.Y() << "  " << pos_res.Z() << cNORMAL << "\n";
       // firstPoint = gfTrack->getPointWithMeasurement(0);
       // lastPoint  = gfTrack->getPointWithMeasurement(gfTrack->getNumPoints()-1);
       // firstPoint->Print();
@@ -991,10 +1117,10 @@ genfit::Track *AtFITTER::AtGenfit::FitTracks(AtTrack *track)
       return nullptr;
    }
 
-   std::cout << " End of GENFIT "
-             << "\n";
-   std::cout << "               "
-             << "\n";
+   LOG(debug) << " End of GENFIT "
+              << "\n";
+   LOG(debug) << "               "
+              << "\n";
 
    return gfTrack;
 }
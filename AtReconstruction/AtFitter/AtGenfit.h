@@ -32,6 +32,7 @@
 #include "MeasurementProducer.h"
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -57,9 +58,20 @@ namespace AtFITTER {
 
 class AtGenfit : public AtFitter {
 private:
-   std::shared_ptr<genfit::AbsKalmanFitter> fKalmanFitter;
-   TClonesArray *fGenfitTrackArray;
-   TClonesArray *fHitClusterArray;
+   /// Everything a fit writes to, so tracks can be fit concurrently with one context per thread.
+   struct FitContext {
+      std::unique_ptr<genfit::AbsKalmanFitter> fKalmanFitter;
+      std::unique_ptr<TClonesArray> fGenfitTrackArray;
+      std::unique_ptr<TClonesArray> fHitClusterArray;
+      std::unique_ptr<genfit::MeasurementFactory<genfit::AbsMeasurement>> fMeasurementFactory; // Owns the producer
+
+      FitContext(Int_t detID);
+      ~FitContext();
+      void Clear();
+   };
+
+   std::vector<std::unique_ptr<FitContext>> fContexts; //! One per thread, the first is used when not threaded
+   Int_t fNumThreads{1};
    Int_t fPDGCode{2212}; //<! Particle PGD code
    Int_t fTPCDetID{0};
    Int_t fFitDirection{0};
@@ -77,7 +89,7 @@ private:
    Float_t fGasMediumDensity{};   //<! Medium density in mg/cm3
    Double_t fPhiOrientation{0};   //<! Phi angle orientation for fit
    std::string fIonName;          //<! Name of ion to fit
-   Bool_t fNoMaterialEffects;     //<! Disable material effects in GENFIT
+   Bool_t fNoMaterialEffects{false}; //<! Disable material effects in GENFIT
    Bool_t fEnableMerging{0};
    Bool_t fEnableSingleVertexTrack{0};
    Bool_t fEnableReclustering{0};
@@ -88,9 +100,6 @@ private:
    std::unique_ptr<AtTools::AtTrackTransformer> fTrackTransformer;
    std::shared_ptr<AtTools::AtKinematics> fKinematics;
 
-   genfit::MeasurementProducer<AtHitCluster, genfit::AtSpacepointMeasurement> *fMeasurementProducer;
-   genfit::MeasurementFactory<genfit::AbsMeasurement> *fMeasurementFactory;
-
    std::vector<Int_t> *fPDGCandidateArray{};
 
    std::vector<AtTrack *> FindSingleTracks(std::vector<AtTrack *> &tracks);
@@ -98,6 +107,10 @@ private:
    Bool_t CompareTracks(AtTrack *trA, AtTrack *trB);
    Bool_t CheckOverlap(AtTrack *trA, AtTrack *trB);
 
+   genfit::Track *FitTracks(AtTrack *track, FitContext &context);
+   std::unique_ptr<AtFittedTrack> FitMergedTrack(AtTrack track, Int_t trackID, FitContext &context);
+   std::unique_lock<std::mutex> LockGenfit() const;
+
 public:
    AtGenfit(Float_t magfield, Float_t minbrho, Float_t maxbrho, std::string eLossFile, Float_t gasMediumDensity,
             Int_t pdg = 2212, Int_t minit = 5, Int_t maxit = 20, Bool_t noMatEffects = kFALSE);
@@ -134,16 +147,26 @@ public:
       fClusterSize = clusterSize;
    }
 
+   /**
+    * Fit the tracks of an event on numThreads threads, each with its own Kalman fitter, measurement
+    * factory and output arrays. The results are returned in the same order as when fitting serially.
+    *
+    * The magnetic field is only read, but GENFIT's MaterialEffects is a process-wide singleton that
+    * keeps state between steps. Unless material effects are disabled, the GENFIT calls are therefore
+    * serialized and only the preparation of the tracks runs concurrently.
+    */
+   void SetNumThreads(Int_t numThreads);
    inline void SetExpNum(Exp exp) { fExpNum = exp; }
    inline void SetFitDirection(Int_t direction) { fFitDirection = direction; }
 
+   /// GENFIT tracks of the last fit done on the first (or only) thread
    TClonesArray *GetGenfitTrackArray();
    Int_t GetPDGCode() { return fPDGCode; }
    std::string &GetIonName() { return fIonName; }
 
 protected:
    inline bool IsForwardTrack(double theta) { return theta < 90.0 * TMath::DegToRad(); }
-   ClassDefOverride(AtGenfit, 1);
+   ClassDefOverride(AtGenfit, 2);
 };
 
 } // namespace AtFITTER
@@ -13,18 +13,26 @@
 #include "AtSimpleSimulation.h" // for AtSimpleSimulation
 #include "AtSimulatedPoint.h"   // IWYU pragma: keep
 #include "AtSpaceChargeModel.h"
+#include "AtUniformDistribution.h"
 
 #include <FairLogger.h>    // for LOG, Logger
 #include <FairParSet.h>    // for FairParSet
 #include <FairRunAna.h>    // for FairRunAna
 #include <FairRuntimeDb.h> // for FairRuntimeDb
 
+#include <TFile.h>
 #include <TROOT.h>
+#include <TTree.h>
 
-#include <algorithm> // for max
+#include <algorithm> // for max, push_heap, pop_heap, partial_sort
 #include <chrono>
+#include <cmath>
+#include <limits>
 #include <mutex>
+#include <string>
 #include <thread>
+#include <tuple> // for tie
+#include <unordered_map>
 using std::move;
 namespace MCFitter {
 
@@ -34,6 +42,8 @@ AtMCFitter::AtMCFitter(SimPtr sim, ClusterPtr cluster, PulsePtr pulse)
 {
 }
 
+AtMCFitter::~AtMCFitter() = default;
+
 AtMCFitter::ParamPtr AtMCFitter::GetParameter(const std::string &name) const
 {
    if (fParameters.find(name) != fParameters.end()) {
@@ -64,34 +74,54 @@ void AtMCFitter::Init()
    if (fSim->GetSpaceChargeModel())
       fSim->GetSpaceChargeModel()->LoadParameters(fPar);
 
-   fThPulse.resize(fNumThreads);
-   for (int i = 0; i < fNumThreads; ++i)
-      fThPulse[i] = fPulse->Clone();
+   CreatePipelines();
 }
 
-void AtMCFitter::RunIterRange(int startIter, int numIter, AtPulse *pulse)
+/// Give each thread its own copy of the (configured) simulation and digitization
+void AtMCFitter::CreatePipelines()
 {
-   // Here we should copy each thread their own version of the clusterize, pulse, and simulation
-   // objects (only if the number of threads is greater than 1). Needs to be deep copies
+   fPipelines.clear();
+   fPipelines.resize(fNumThreads);
+   for (auto &pipeline : fPipelines) {
+      pipeline.fSim = fSim->Clone();
+      pipeline.fPulse = fPulse->Clone();
+      pipeline.fClusterize = fClusterize->Clone();
+      if (fPSA)
+         pipeline.fPSA = fPSA->Clone();
+   }
+}
 
-   for (int i = 0; i < numIter; ++i) {
+/**
+ * Run iterations on a thread until there are none left. Iterations are taken one at a time from
+ * nextIter, since how long one takes depends on the sampled parameters.
+ */
+void AtMCFitter::RunIterations(int thread, std::atomic<int> &nextIter)
+{
+   auto &pipeline = fPipelines[thread];
+   for (int idx = nextIter++; idx < fNumIter; idx = nextIter++) {
+      auto start = std::chrono::steady_clock::now();
 
-      int idx = startIter + i;
+      int eventIdx = fKeepBestEventsOnly ? thread : idx;
       auto result = DefineEvent();
-      auto mcPoints = SimulateEvent(result);
+      auto mcPoints = SimulateEvent(result, *pipeline.fSim);
 
-      DigitizeEvent(mcPoints, idx, pulse);
-      double obj = ObjectiveFunction(*fCurrentEvent, idx, result);
+      DigitizeEvent(mcPoints, eventIdx, pipeline);
+      double obj = ObjectiveFunction(*fCurrentEvent, eventIdx, result);
 
-      result.fIterNum = idx;
+      // Iteration numbers are unique across rounds only when the events are not stored by iteration
+      result.fIterNum = fKeepBestEventsOnly ? fRound * fNumIter + idx : idx;
       result.fObjective = obj;
       // result.Print();
-      {
-         std::lock_guard<std::mutex> lk(fResultMutex);
-         fResults.insert(result);
-      }
+      if (fKeepBestEventsOnly)
+         SaveIfBest(pipeline.fBestEvents, result.fObjective, result.fIterNum, fRawEventArray[eventIdx],
+                    fEventArray[eventIdx]);
+      pipeline.fResults.push_back(std::move(result));
+
+      ++pipeline.fNumIter;
+      pipeline.fBusyTime +=
+         std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
    }
-   LOG(debug) << "Done with run iter range";
+   LOG(debug) << "Done with iterations on thread " << thread;
 }
 
 void AtMCFitter::Exec(const AtPatternEvent &event)
@@ -99,6 +129,7 @@ void AtMCFitter::Exec(const AtPatternEvent &event)
    fRawEventArray.clear();
    fEventArray.clear();
    fResults.clear();
+   fBestEvents.clear();
 
    SetParamDistributions(event);
 
@@ -106,66 +137,94 @@ void AtMCFitter::Exec(const AtPatternEvent &event)
    fCurrentEvent = &event;
 
    // Make sure the event arrays are large enough so no resizing will happen
-   fRawEventArray.resize(fNumIter);
-   fEventArray.resize(fNumIter);
+   int numEvents = fKeepBestEventsOnly ? fNumThreads : fNumIter;
+   fRawEventArray.resize(numEvents);
+   fEventArray.resize(numEvents);
+
+   if (fLibraryTree)
+      RunLibraryStage();
 
-   for (int i = 0; i < fNumRounds; ++i) {
+   for (fRound = 0; fRound < fNumRounds; ++fRound) {
       RunRound();
       RecenterParamDistributions();
    }
 }
+
+/**
+ * Move rawEvent and event into the max-heap bestEvents if they are one of the best fNumEventsToSave
+ * events in it.
+ */
+void AtMCFitter::SaveIfBest(std::vector<SavedEvent> &bestEvents, double objective, int iterNum,
+                            AtRawEvent &rawEvent, AtEvent &event)
+{
+   auto comp = [](const SavedEvent &a, const SavedEvent &b) { return a.fObjective < b.fObjective; };
+   if (static_cast<int>(bestEvents.size()) >= fNumEventsToSave) {
+      if (fNumEventsToSave <= 0 || objective >= bestEvents.front().fObjective)
+         return;
+      std::pop_heap(bestEvents.begin(), bestEvents.end(), comp);
+      bestEvents.pop_back();
+   }
+
+   bestEvents.push_back({objective, iterNum, std::move(rawEvent), std::move(event)});
+   std::push_heap(bestEvents.begin(), bestEvents.end(), comp);
+}
+
 void AtMCFitter::RunRound()
 {
    // Begining of round
    auto start = std::chrono::high_resolution_clock::now();
 
-   // Get what iterations to do on what thread.
-   std::vector<std::pair<int, int>> threadParam;
-   int iterPerTh = fNumIter / fNumThreads;
-   for (int i = 0; i < fNumThreads; ++i)
-      threadParam.emplace_back(0, iterPerTh);
-   for (int i = 0; i < fNumIter % fNumThreads; ++i)
-      threadParam[i].second++;
-   for (int i = 1; i < fNumThreads; ++i)
-      threadParam[i].first = threadParam[i - 1].first + threadParam[i - 1].second;
-
-   for (int i = 0; i < threadParam.size(); ++i) {
-      LOG(info) << i << ": " << threadParam[i].first << " " << threadParam[i].second;
+   if (fPipelines.size() != fNumThreads)
+      CreatePipelines();
+   for (auto &pipeline : fPipelines) {
+      pipeline.fNumIter = 0;
+      pipeline.fBusyTime = 0;
    }
 
+   std::atomic<int> nextIter{0};
    std::vector<std::thread> threads;
    for (int i = 0; i < fNumThreads; ++i) {
-      LOG(debug) << "Creating thread " << i << " with " << threadParam[i].first << " " << threadParam[i].second
-                 << " and " << fPulse.get();
-
-      // Spawn a thread to call RunIterRange.
-      threads.emplace_back(
-         [this](std::pair<int, int> param, AtPulse *pulse) { this->RunIterRange(param.first, param.second, pulse); },
-         threadParam[i], fThPulse[i].get());
+      LOG(debug) << "Creating thread " << i;
+      threads.emplace_back([this, i, &nextIter]() { this->RunIterations(i, nextIter); });
    }
 
    // Wait for all threads to finish
    for (auto &th : threads)
       th.join();
 
+   // Merge the results of the threads
+   for (auto &pipeline : fPipelines) {
+      for (auto &result : pipeline.fResults)
+         fResults.insert(std::move(result));
+      for (auto &saved : pipeline.fBestEvents)
+         SaveIfBest(fBestEvents, saved.fObjective, saved.fIterNum, saved.fRawEvent, saved.fEvent);
+      pipeline.fResults.clear();
+      pipeline.fBestEvents.clear();
+   }
+
    auto stop = std::chrono::high_resolution_clock::now();
 
-   if (fTimeEvent)
-      LOG(info) << "Simulation of " << fNumIter << " events took "
-                << std::chrono::duration_cast<std::chrono::milliseconds>(stop - start).count() << " ms.";
+   if (fTimeEvent) {
+      auto roundTime = std::chrono::duration<double, std::milli>(stop - start).count();
+      LOG(info) << "Simulation of " << fNumIter << " events took " << static_cast<long>(roundTime) << " ms.";
+      for (int i = 0; i < fPipelines.size(); ++i)
+         LOG(info) << "Thread " << i << " ran " << fPipelines[i].fNumIter << " iterations and was busy "
+                   << static_cast<long>(fPipelines[i].fBusyTime) << " ms ("
+                   << static_cast<int>(100 * fPipelines[i].fBusyTime / roundTime) << "% of the round).";
+   }
 }
 
-int AtMCFitter::DigitizeEvent(const TClonesArray &points, int idx, AtPulse *pulse)
+int AtMCFitter::DigitizeEvent(const TClonesArray &points, int idx, ThreadPipeline &pipeline)
 {
    // Event has been simulated and is sitting in the fSim
-   auto vec = fClusterize->ProcessEvent(points);
+   auto vec = pipeline.fClusterize->ProcessEvent(points);
    LOG(debug) << "Digitizing event at " << idx;
 
-   fRawEventArray[idx] = pulse->GenerateEvent(vec);
+   fRawEventArray[idx] = pipeline.fPulse->GenerateEvent(vec);
 
-   if (fPSA) {
+   if (pipeline.fPSA) {
       LOG(debug) << "Running PSA at " << idx;
-      fEventArray[idx] = fPSA->Analyze(fRawEventArray[idx]);
+      fEventArray[idx] = pipeline.fPSA->Analyze(fRawEventArray[idx]);
    }
    LOG(debug) << "Done digitizing event at " << idx;
    return idx;
@@ -180,6 +239,11 @@ void AtMCFitter::FillResultArrays(TClonesArray &resultArray, TClonesArray &simEv
    simEvent.Delete();
    simRawEvent.Delete();
 
+   // Map from iteration number to saved event when only the best events were kept
+   std::unordered_map<int, SavedEvent *> bestEvents;
+   for (auto &saved : fBestEvents)
+      bestEvents[saved.fIterNum] = &saved;
+
    for (auto &res : fResults) {
 
       int clonesIdx = resultArray.GetEntries();
@@ -187,14 +251,203 @@ void AtMCFitter::FillResultArrays(TClonesArray &resultArray, TClonesArray &simEv
       LOG(debug) << "Filling iteration " << eventIdx << " at index " << resultArray.GetEntries();
 
       new (resultArray[clonesIdx]) AtMCResult(std::move(res));
-      if (clonesIdx < fNumEventsToSave) {
+      if (clonesIdx >= fNumEventsToSave)
+         continue;
+
+      if (!fKeepBestEventsOnly) {
          new (simEvent[clonesIdx]) AtEvent(std::move(fEventArray[eventIdx]));
          new (simRawEvent[clonesIdx]) AtRawEvent(std::move(fRawEventArray[eventIdx]));
+      } else if (bestEvents.find(eventIdx) != bestEvents.end()) {
+         new (simEvent[clonesIdx]) AtEvent(std::move(bestEvents[eventIdx]->fEvent));
+         new (simRawEvent[clonesIdx]) AtRawEvent(std::move(bestEvents[eventIdx]->fRawEvent));
       }
    }
 
    fEventArray.clear();
    fRawEventArray.clear();
+   fBestEvents.clear();
+}
+
+void AtMCFitter::CreateLibrary(const std::string &fileName, int numEvents)
+{
+   for (auto &[name, distro] : fParameters) {
+      if (fLibraryPriors.find(name) == fLibraryPriors.end()) {
+         LOG(error) << "No library range set for parameter " << name << ", not creating library " << fileName;
+         return;
+      }
+   }
+
+   // Sample from the priors instead of the distributions (which are set per event). DefineEvent
+   // samples fParameters, so they are swapped for the duration of the library.
+   auto parameters = fParameters;
+   for (auto &[name, distro] : fParameters) {
+      auto [min, max] = fLibraryPriors[name];
+      distro = std::make_shared<AtUniformDistribution>((min + max) / 2, (max - min) / 2);
+   }
+
+   TFile file(fileName.c_str(), "RECREATE");
+   TTree tree("library", "Pre-simulated events for AtMCFitter");
+   AtMCResult result;
+   AtEvent event;
+   auto resultPtr = &result;
+   auto eventPtr = &event;
+   tree.Branch("AtMCResult", &resultPtr);
+   tree.Branch("AtEvent", &eventPtr);
+
+   fRawEventArray.resize(fNumThreads);
+   fEventArray.resize(fNumThreads);
+
+   if (fPipelines.size() != fNumThreads)
+      CreatePipelines();
+
+   auto start = std::chrono::high_resolution_clock::now();
+   std::atomic<int> nextEvent{0};
+   std::vector<std::thread> threads;
+   for (int th = 0; th < fNumThreads; ++th) {
+      threads.emplace_back([this, th, numEvents, &nextEvent, &tree, &result, &event]() {
+         for (int i = nextEvent++; i < numEvents; i = nextEvent++) {
+            auto res = DefineEvent();
+            auto mcPoints = SimulateEvent(res, *fPipelines[th].fSim);
+            DigitizeEvent(mcPoints, th, fPipelines[th]);
+
+            std::lock_guard<std::mutex> lk(fResultMutex);
+            result = std::move(res);
+            event = std::move(fEventArray[th]);
+            tree.Fill();
+         }
+      });
+   }
+   for (auto &th : threads)
+      th.join();
+   fParameters = std::move(parameters);
+
+   // Save the ranges so a library can be used without knowing how it was made
+   TTree priorTree("priors", "Range of the parameters in the library");
+   std::string priorName;
+   double priorMin = 0;
+   double priorMax = 0;
+   priorTree.Branch("name", &priorName);
+   priorTree.Branch("min", &priorMin);
+   priorTree.Branch("max", &priorMax);
+   for (auto &[name, distro] : fParameters) {
+      priorName = name;
+      std::tie(priorMin, priorMax) = fLibraryPriors[name];
+      priorTree.Fill();
+   }
+
+   tree.Write();
+   priorTree.Write();
+   file.Close();
+   fRawEventArray.clear();
+   fEventArray.clear();
+
+   auto stop = std::chrono::high_resolution_clock::now();
+   LOG(info) << "Created library of " << numEvents << " events in " << fileName << " in "
+             << std::chrono::duration_cast<std::chrono::milliseconds>(stop - start).count() << " ms.";
+}
+
+void AtMCFitter::SetLibrary(const std::string &fileName, int numNeighbours)
+{
+   fLibraryParams.clear();
+   fLibraryWidths.clear();
+   fLibraryTree = nullptr;
+   fLibraryFile = std::make_unique<TFile>(fileName.c_str(), "READ");
+   TTree *priorTree = nullptr;
+   if (!fLibraryFile->IsZombie()) {
+      fLibraryTree = dynamic_cast<TTree *>(fLibraryFile->Get("library"));
+      priorTree = dynamic_cast<TTree *>(fLibraryFile->Get("priors"));
+   }
+   if (fLibraryTree == nullptr || priorTree == nullptr) {
+      LOG(error) << "Could not open library in " << fileName << ", not using a library!";
+      fLibraryTree = nullptr;
+      fLibraryFile.reset();
+      return;
+   }
+
+   std::string *priorName = nullptr;
+   double priorMin = 0;
+   double priorMax = 0;
+   priorTree->SetBranchAddress("name", &priorName);
+   priorTree->SetBranchAddress("min", &priorMin);
+   priorTree->SetBranchAddress("max", &priorMax);
+   for (Long64_t i = 0; i < priorTree->GetEntries(); ++i) {
+      priorTree->GetEntry(i);
+      fLibraryWidths[*priorName] = priorMax - priorMin;
+   }
+   priorTree->ResetBranchAddresses();
+   delete priorName;
+
+   // Only the parameters are kept in memory, events are read from disk when needed
+   fNumLibraryNeighbours = numNeighbours;
+
+   AtMCResult *result = nullptr;
+   fLibraryTree->SetBranchAddress("AtMCResult", &result);
+   auto branch = fLibraryTree->GetBranch("AtMCResult");
+   fLibraryParams.reserve(fLibraryTree->GetEntries());
+   for (Long64_t i = 0; i < fLibraryTree->GetEntries(); ++i) {
+      branch->GetEntry(i);
+      fLibraryParams.push_back(*result);
+   }
+   fLibraryTree->ResetBranchAddresses();
+   delete result;
+   LOG(info) << "Loaded library of " << fLibraryParams.size() << " events from " << fileName;
+}
+
+/**
+ * Evaluate the objective function against the library events closest to the current parameter
+ * distributions and center the distributions on the best one. Runs on the calling thread.
+ */
+void AtMCFitter::RunLibraryStage()
+{
+   // Distance is measured in units of the width of the library range of each parameter, so it does
+   // not depend on the event. Parameters fixed in the library do not contribute.
+   std::vector<std::pair<double, int>> dist;
+   dist.reserve(fLibraryParams.size());
+   for (int i = 0; i < fLibraryParams.size(); ++i) {
+      double d2 = 0;
+      for (auto &[name, distro] : fParameters) {
+         auto width = fLibraryWidths.find(name);
+         if (width == fLibraryWidths.end() || width->second <= 0)
+            continue;
+         auto it = fLibraryParams[i].fParameters.find(name);
+         if (it == fLibraryParams[i].fParameters.end())
+            continue;
+         double diff = (it->second - distro->GetMean()) / width->second;
+         d2 += diff * diff;
+      }
+      dist.emplace_back(d2, i);
+   }
+
+   int numNeighbours = std::min<int>(fNumLibraryNeighbours, dist.size());
+   std::partial_sort(dist.begin(), dist.begin() + numNeighbours, dist.end());
+
+   AtEvent *event = nullptr;
+   fLibraryTree->SetBranchAddress("AtEvent", &event);
+   auto branch = fLibraryTree->GetBranch("AtEvent");
+
+   double bestObj = std::numeric_limits<double>::max();
+   AtMCResult best;
+   for (int i = 0; i < numNeighbours; ++i) {
+      branch->GetEntry(dist[i].second);
+      fEventArray[0] = *event;
+
+      auto result = fLibraryParams[dist[i].second];
+      double obj = ObjectiveFunction(*fCurrentEvent, 0, result);
+      if (obj < bestObj) {
+         bestObj = obj;
+         best = result;
+      }
+   }
+   fLibraryTree->ResetBranchAddresses();
+   delete event;
+
+   if (bestObj == std::numeric_limits<double>::max())
+      return;
+
+   LOG(debug) << "Best library event has objective " << bestObj;
+   for (auto &[name, distro] : fParameters)
+      if (best.fParameters.find(name) != best.fParameters.end())
+         distro->SetMean(best.fParameters[name]);
 }
 
 AtMCResult AtMCFitter::DefineEvent()
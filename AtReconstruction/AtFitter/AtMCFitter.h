@@ -7,6 +7,7 @@
 
 #include <TClonesArray.h> // for TClonesArray
 
+#include <atomic>     // for atomic
 #include <functional> // for function
 #include <map>        // for map
 #include <memory>     // for shared_ptr
@@ -24,6 +25,8 @@ class AtPulse;            // lines 16-16
 class AtSimpleSimulation; // lines 14-14
 class AtDigiPar;
 class AtPSA;
+class TFile;
+class TTree;
 
 namespace MCFitter {
 class AtParameterDistribution;
@@ -56,22 +59,60 @@ protected:
    // Things used by threads excecuting that are either expensive to create and delete
    // or unaccessable due to FairRoot design choices
    const AtPatternEvent *fCurrentEvent{nullptr};
-   std::vector<PulsePtr> fThPulse; //< Cached because it is expensive to create and delete.
    const AtDigiPar *fPar{nullptr}; //<Tracked sepretly because FairRun::Instance is thread local.
 
    // These are not locked by the mutex since we ensure no realloc of the vector is happening and
    // each thread is accessing a discrete subset of the elements of these vectors
+   // If fKeepBestEventsOnly is set these have one entry per thread and are used as scratch space.
    std::vector<AtRawEvent> fRawEventArray;
    std::vector<AtEvent> fEventArray;
 
-   /** Things below here need to be written to by threads and will be locked using a shared mutex ***/
-   /// Store the iteration number sorted by lowest objective funtion
+   /// Simulated event that is currently one of the best fNumEventsToSave
+   struct SavedEvent {
+      double fObjective;
+      int fIterNum;
+      AtRawEvent fRawEvent;
+      AtEvent fEvent;
+   };
+   bool fKeepBestEventsOnly{false};
+   int fRound{0};
+
+   /**
+    * Copy of the simulation and digitization for a thread, created once in Init() because they are
+    * expensive to create and delete, and the results of the thread in the current round. Only the thread owning
+    * it writes to it while a round runs, and its results are merged after the threads are joined.
+    */
+   struct alignas(64) ThreadPipeline {
+      SimPtr fSim;
+      PulsePtr fPulse;
+      ClusterPtr fClusterize;
+      PsaPtr fPSA;
+      std::vector<AtMCResult> fResults;    //< Results of this round
+      std::vector<SavedEvent> fBestEvents; //< Max-heap of the best events of this round (if fKeepBestEventsOnly)
+      int fNumIter{0};                     //< Iterations run this round
+      double fBusyTime{0};                 //< Time (ms) spent running iterations this round
+   };
+   std::vector<ThreadPipeline> fPipelines;
+
+   // Pre-simulated library used to pick the starting point of the fit
+   std::map<std::string, std::pair<double, double>> fLibraryPriors; //< Range [min, max] of each parameter to simulate
+   std::unique_ptr<TFile> fLibraryFile;
+   TTree *fLibraryTree{nullptr};
+   std::vector<AtMCResult> fLibraryParams;
+   std::map<std::string, double> fLibraryWidths; //< Width of the range of each parameter in the loaded library
+   int fNumLibraryNeighbours{0};
+
+   /// Locks the library tree while it is filled by threads
    std::mutex fResultMutex;
+
+   /** Things below here are filled from fPipelines after the threads of a round finish ***/
+   /// Store the iteration number sorted by lowest objective funtion
    std::set<AtMCResult, std::function<bool(AtMCResult, AtMCResult)>> fResults;
+   std::vector<SavedEvent> fBestEvents; //< Max-heap (by objective) of the best simulated events
 
 public:
    AtMCFitter(SimPtr sim, ClusterPtr cluster, PulsePtr pulse);
-   virtual ~AtMCFitter() = default;
+   virtual ~AtMCFitter();
 
    void Init();
    void SetPSA(PsaPtr psa) { fPSA = psa; }
@@ -87,9 +128,42 @@ public:
    void SetNumEventsToSave(int num) { fNumEventsToSave = num; }
    void SetNumThreads(int num);
 
+   /**
+    * If true, only the simulated events that are currently in the best fNumEventsToSave are kept in
+    * memory instead of every simulated event. Memory use is then independent of fNumIter.
+    */
+   void SetKeepBestEventsOnly(bool val) { fKeepBestEventsOnly = val; }
+
+   /**
+    * Set the range [min, max] to sample the parameter name from when creating a library. The
+    * parameter distributions are only set from an event in Exec(), so every parameter needs a range
+    * for the library to cover the parameter space. Use min == max to fix a parameter.
+    */
+   void SetLibraryPrior(const std::string &name, double min, double max) { fLibraryPriors[name] = {min, max}; }
+
+   /**
+    * Simulate numEvents events with every parameter sampled uniformly from the range set with
+    * SetLibraryPrior, and save their parameters, their AtEvent and the ranges to a library in
+    * fileName. Nothing is created if a parameter has no range. Must be called after Init().
+    */
+   void CreateLibrary(const std::string &fileName, int numEvents);
+
+   /**
+    * Use a library created with CreateLibrary. Before the first round of each event, the objective
+    * function is evaluated against the numNeighbours library events whose parameters are closest
+    * to the mean of the parameter distributions, and the distributions are re-centered on the best one.
+    * The distance to a library event is measured in units of the width of the range of each parameter.
+    * Only the AtEvent is stored in the library so the objective function can not depend on the AtRawEvent.
+    */
+   void SetLibrary(const std::string &fileName, int numNeighbours);
+
 protected:
+   void CreatePipelines();
    void RunRound();
-   void RunIterRange(int startIter, int numIter, AtPulse *pulse);
+   void RunIterations(int thread, std::atomic<int> &nextIter);
+   void SaveIfBest(std::vector<SavedEvent> &bestEvents, double objective, int iterNum, AtRawEvent &rawEvent,
+                   AtEvent &event);
+   void RunLibraryStage();
 
    /**
     *@brief Create the parameter distributions to use for the fit.
@@ -107,10 +181,10 @@ protected:
    virtual double ObjectiveFunction(const AtBaseEvent &expEvent, int SimEventID, AtMCResult &definition) = 0;
 
    /**
-    * Simulate an event using the parameters in the passed AtMCResult class and return an array of
-    * the AtMCPoints to then digitize.
+    * Simulate an event with sim using the parameters in the passed AtMCResult class and return an
+    * array of the AtMCPoints to then digitize. sim is the copy of fSim owned by the calling thread.
     */
-   virtual TClonesArray SimulateEvent(AtMCResult &definition) = 0;
+   virtual TClonesArray SimulateEvent(AtMCResult &definition, AtSimpleSimulation &sim) = 0;
 
    /**
     * Sample parameter distributions and constrain the system to simulate an event.
@@ -128,7 +202,7 @@ protected:
     * Create the AtRawEvent and AtEvent from fSim
     * returns the index of the event in the TClonesArray
     */
-   int DigitizeEvent(const TClonesArray &points, int idx, AtPulse *pulse);
+   int DigitizeEvent(const TClonesArray &points, int idx, ThreadPipeline &pipeline);
 };
 
 } // namespace MCFitter
@@ -0,0 +1,595 @@
+#include "AtUKFFitter.h"
+
+#include "AtELossModel.h"
+#include "AtFittedTrack.h"
+#include "AtHitCluster.h"
+#include "AtTrack.h"
+
+#include <FairLogger.h>
+
+#include <Math/CholeskyDecomp.h>
+#include <Math/Point3D.h>
+#include <TMath.h>
+#include <TMatrixTSym.h>
+
+#include <algorithm> // for reverse, min, max
+#include <array>
+#include <cmath>  // for sqrt, abs, sin, cos, copysign, log
+#include <string> // for to_string
+#include <utility>
+
+using XYZVector = ROOT::Math::XYZVector;
+using StateVector = AtFITTER::AtUKFFitter::StateVector;
+using StateMatrix = AtFITTER::AtUKFFitter::StateMatrix;
+
+ClassImp(AtFITTER::AtUKFFitter);
+
+namespace {
+constexpr int cDim = 6;
+constexpr double cMomPerTmm = 0.299792458; // MeV/c of a unit charge bent on a 1 mm radius by 1 T
+constexpr double cAmuToMeV = 931.49401;
+constexpr double cSeedPosSigma = 10;    // mm
+constexpr double cSeedAngleSigma = 0.2; // rad
+constexpr double cPOCATolerance = 1e-3; // mm
+constexpr int cMaxPOCAIterations = 10;
+constexpr double cMaxXtrLength = 1000; // mm
+constexpr double cFirstXtrStep = 5;    // mm
+constexpr double cMaxXtrStep = 40;     // mm, also limited to a quarter turn of the track
+constexpr double cXtrTolerance = 1e-2; // mm
+constexpr double cMmToCm = 0.1;        // AtFittedTrack is filled in cm, like AtGenfit does
+
+XYZVector position(const StateVector &state)
+{
+   return {state[0], state[1], state[2]};
+}
+XYZVector momentum(const StateVector &state)
+{
+   return {state[3], state[4], state[5]};
+}
+void setState(StateVector &state, const XYZVector &pos, const XYZVector &mom)
+{
+   state[0] = pos.X();
+   state[1] = pos.Y();
+   state[2] = pos.Z();
+   state[3] = mom.X();
+   state[4] = mom.Y();
+   state[5] = mom.Z();
+}
+
+/// Rate at which the distance to the beam axis grows along the track, times that distance
+double approachRate(const StateVector &state)
+{
+   return (state[0] * state[3] + state[1] * state[4]) / std::sqrt(momentum(state).Mag2());
+}
+} // namespace
+
+AtFITTER::AtUKFFitter::AtUKFFitter(std::shared_ptr<AtTools::AtELossModel> eLossModel, Double_t magneticField)
+   : fELossModel(std::move(eLossModel)), fMagneticField(magneticField)
+{
+}
+
+void AtFITTER::AtUKFFitter::Init()
+{
+   if (!fELossModel)
+      LOG(error) << "No energy loss model set, tracks will be fit without energy loss!";
+
+   LOG(debug) << " AtFITTER::AtUKFFitter::Init - Fit parameters.";
+   LOG(debug) << " Magnetic Field       : " << fMagneticField << " T";
+   LOG(debug) << " PDG Code             : " << fPDGCode;
+   LOG(debug) << " Mass                 : " << fMass << " amu";
+   LOG(debug) << " Atomic Number        : " << fAtomicNumber;
+   LOG(debug) << " Maximum step         : " << fMaxStep << " mm";
+   LOG(debug) << " Radiation length     : " << fRadiationLength << " mm";
+   LOG(debug) << " Maximum iterations   : " << fMaxIterations;
+}
+
+Double_t AtFITTER::AtUKFFitter::GetMassMeV() const
+{
+   return fMass * cAmuToMeV;
+}
+
+Double_t AtFITTER::AtUKFFitter::GetKineticEnergy(Double_t mom) const
+{
+   auto mass = GetMassMeV();
+   return std::sqrt(mom * mom + mass * mass) - mass;
+}
+
+Double_t AtFITTER::AtUKFFitter::GetMomentum(Double_t energy) const
+{
+   return std::sqrt(energy * (energy + 2 * GetMassMeV()));
+}
+
+Double_t AtFITTER::AtUKFFitter::GetCurvature(Double_t mom) const
+{
+   return -cMomPerTmm * fAtomicNumber * fMagneticField / mom;
+}
+
+/**
+ * In each step the direction rotates around z at the rate given by the momentum at the average of
+ * the energies at the start and end of the step.
+ */
+bool AtFITTER::AtUKFFitter::Propagate(StateVector &state, Double_t length) const
+{
+   auto pos = position(state);
+   auto mom = momentum(state);
+   double energy = GetKineticEnergy(std::sqrt(mom.Mag2()));
+   if (!(energy > 0))
+      return false;
+   auto dir = mom.Unit();
+
+   double remaining = length;
+   while (remaining != 0) {
+      double step = remaining;
+      if (std::abs(remaining) > fMaxStep)
+         step = std::copysign(fMaxStep, remaining);
+      remaining -= step;
+
+      double newEnergy = fELossModel ? fELossModel->GetEnergy(energy, step) : energy;
+      if (!(newEnergy > 0))
+         return false;
+
+      double w = GetCurvature(GetMomentum((energy + newEnergy) / 2));
+      double angle = w * step;
+      double cosA = std::cos(angle);
+      double sinA = std::sin(angle);
+      // sin(angle)/w and (1 - cos(angle))/w, expanded for small angles
+      double along = step * (1 - angle * angle / 6);
+      double across = step * angle / 2;
+      if (std::abs(angle) > 1e-4) {
+         along = sinA / w;
+         across = (1 - cosA) / w;
+      }
+
+      pos += XYZVector(dir.X() * along - dir.Y() * across, dir.X() * across + dir.Y() * along, dir.Z() * step);
+      dir.SetXYZ(dir.X() * cosA - dir.Y() * sinA, dir.X() * sinA + dir.Y() * cosA, dir.Z());
+      energy = newEnergy;
+   }
+
+   setState(state, pos, dir * GetMomentum(energy));
+   return true;
+}
+
+/// Measurements ordered starting from the end of the track closest to the beam axis.
+std::vector<AtFITTER::AtUKFFitter::Measurement> AtFITTER::AtUKFFitter::GetMeasurements(AtTrack &track) const
+{
+   std::vector<Measurement> meas;
+   for (auto &cluster : *track.GetHitClusterArray()) {
+      Measurement m;
+      auto pos = cluster.GetPosition();
+      m.pos.SetXYZ(pos.X(), pos.Y(), pos.Z());
+      for (int i = 0; i < 3; ++i)
+         for (int j = 0; j < 3; ++j)
+            m.cov(i, j) = cluster.GetCovMatrix()(i, j);
+      meas.push_back(m);
+   }
+
+   if (!meas.empty() && meas.back().pos.Perp2() < meas.front().pos.Perp2())
+      std::reverse(meas.begin(), meas.end());
+   return meas;
+}
+
+/**
+ * Start at the first cluster with the direction of the chord to a later one, rotated back by half
+ * the turn of the track over it. The momentum comes from the radius of the track from pattern
+ * recognition, but is at least what the particle needs to travel the length of the track.
+ */
+bool AtFITTER::AtUKFFitter::SeedState(AtTrack &track, const std::vector<Measurement> &meas, StateVector &state) const
+{
+   auto chord = meas[std::min<size_t>(3, meas.size() - 1)].pos - meas[0].pos;
+   auto dir = chord.Unit();
+
+   double mom = 0;
+   double radius = track.GetGeoRadius();
+   double sinTheta = dir.Rho();
+   if (fMagneticField != 0 && radius > 0 && sinTheta > 0.1)
+      mom = cMomPerTmm * std::abs(fAtomicNumber * fMagneticField) * radius / sinTheta;
+
+   double length = 0;
+   for (int i = 1; i < meas.size(); ++i)
+      length += std::sqrt((meas[i].pos - meas[i - 1].pos).Mag2());
+   mom = std::max(mom, GetMomentumForRange(length));
+   if (!(mom > 0))
+      return false;
+
+   double angle = -GetCurvature(mom) * std::sqrt(chord.Mag2()) / 2;
+   dir.SetXYZ(dir.X() * std::cos(angle) - dir.Y() * std::sin(angle),
+              dir.X() * std::sin(angle) + dir.Y() * std::cos(angle), dir.Z());
+   setState(state, meas[0].pos, dir * mom);
+   return true;
+}
+
+/// Momentum (MeV/c) with which the particle travels range (mm) before stopping, 0 without an energy loss model
+Double_t AtFITTER::AtUKFFitter::GetMomentumForRange(Double_t range) const
+{
+   if (!fELossModel || !(range > 0))
+      return 0;
+
+   double eLow = 0;
+   double eHigh = 1;
+   while (fELossModel->GetRange(eHigh) < range && eHigh < 1e5)
+      eHigh *= 2;
+   for (int i = 0; i < 50; ++i) {
+      double energy = (eLow + eHigh) / 2;
+      if (fELossModel->GetRange(energy) < range)
+         eLow = energy;
+      else
+         eHigh = energy;
+   }
+   return GetMomentum(eHigh);
+}
+
+/**
+ * Restart the fit at the last cluster, in the direction of the last few clusters. The momentum is
+ * kept, but is at least what the particle needs to reach the last cluster from the one before.
+ */
+void AtFITTER::AtUKFFitter::ReseedAtEnd(const std::vector<Measurement> &meas, StateVector &state,
+                                        StateMatrix &cov) const
+{
+   const int last = meas.size() - 1;
+   auto dir = (meas[last].pos - meas[std::max(0, last - 3)].pos).Unit();
+   auto mom = std::max(std::sqrt(momentum(state).Mag2()),
+                       GetMomentumForRange(std::sqrt((meas[last].pos - meas[last - 1].pos).Mag2())));
+   setState(state, meas[last].pos, dir * mom);
+   cov = StateMatrix();
+   for (int i = 0; i < cDim; ++i)
+      cov(i, i) = GetMaxVariance(i, mom);
+}
+
+/// Variance of the seed, and the most the covariance is blown up to, of element i of the state
+Double_t AtFITTER::AtUKFFitter::GetMaxVariance(Int_t i, Double_t mom) const
+{
+   if (i < 3)
+      return cSeedPosSigma * cSeedPosSigma;
+   return mom * mom * (fSeedMomSigma * fSeedMomSigma + cSeedAngleSigma * cSeedAngleSigma);
+}
+
+/**
+ * Scale the covariance up by fBlowUpFactor before reversing the direction of the fit, so the
+ * measurements are not counted twice. Like in GENFIT the variances are capped, here at those of the
+ * seed, keeping the correlations.
+ */
+void AtFITTER::AtUKFFitter::BlowUp(StateMatrix &cov, Double_t mom) const
+{
+   cov *= fBlowUpFactor;
+   for (int i = 0; i < cDim; ++i) {
+      auto maxVar = GetMaxVariance(i, mom);
+      if (cov(i, i) <= maxVar)
+         continue;
+      auto scale = std::sqrt(maxVar / cov(i, i));
+      for (int j = 0; j < cDim; ++j) {
+         cov(i, j) *= scale;
+         cov(j, i) *= scale;
+      }
+   }
+}
+
+/// Length along the track from state to the point of closest approach to point. Returns false if the particle stops.
+bool AtFITTER::AtUKFFitter::LengthToPOCA(const StateVector &state, const XYZVector &point, Double_t &length) const
+{
+   StateVector probe = state;
+   length = 0;
+   for (int i = 0; i < cMaxPOCAIterations; ++i) {
+      double step = (point - position(probe)).Dot(momentum(probe).Unit());
+      if (!Propagate(probe, step))
+         return false;
+      length += step;
+      if (std::abs(step) < cPOCATolerance)
+         break;
+   }
+   return true;
+}
+
+/**
+ * Propagate the sigma points of (state, cov) by length and replace them with the mean and
+ * covariance of the result, plus the process noise. Sigma points with too little energy to make it
+ * stay where they stop.
+ */
+bool AtFITTER::AtUKFFitter::Predict(StateVector &state, StateMatrix &cov, Double_t length) const
+{
+   const double lambda = fAlpha * fAlpha * (cDim + fKappa) - cDim;
+   StateMatrix scaledCov = cov * (cDim + lambda);
+   ROOT::Math::CholeskyDecomp<double, cDim> decomp(scaledCov);
+   StateMatrix sqrtCov;
+   if (!decomp.ok() || !decomp.getL(sqrtCov))
+      return false;
+
+   std::array<StateVector, 2 * cDim + 1> sigmaPoints;
+   sigmaPoints[0] = state;
+   for (int i = 0; i < cDim; ++i) {
+      sigmaPoints[1 + i] = state + sqrtCov.Col(i);
+      sigmaPoints[1 + cDim + i] = state - sqrtCov.Col(i);
+   }
+   for (auto &point : sigmaPoints)
+      if (!Propagate(point, length))
+         return false;
+
+   const double weight0 = lambda / (cDim + lambda);
+   const double weight = 1 / (2 * (cDim + lambda));
+   StateVector mean = sigmaPoints[0] * weight0;
+   for (int i = 1; i < sigmaPoints.size(); ++i)
+      mean += sigmaPoints[i] * weight;
+
+   StateVector diff = sigmaPoints[0] - mean;
+   StateMatrix newCov = ROOT::Math::TensorProd(diff, diff) * (weight0 + 1 - fAlpha * fAlpha + fBeta);
+   for (int i = 1; i < sigmaPoints.size(); ++i) {
+      diff = sigmaPoints[i] - mean;
+      newCov += ROOT::Math::TensorProd(diff, diff) * weight;
+   }
+
+   // Multiple scattering (Highland) deflects the direction, and the position in proportion, while
+   // straggling spreads the momentum along it
+   auto mom = momentum(mean);
+   double p = std::sqrt(mom.Mag2());
+   auto dir = mom / p;
+   double d[3] = {dir.X(), dir.Y(), dir.Z()};
+   double thetaVar = 0;
+   if (fRadiationLength > 0) {
+      double beta = p / std::sqrt(p * p + GetMassMeV() * GetMassMeV());
+      double x = std::abs(length) / fRadiationLength;
+      double theta0 = 13.6 / (beta * p) * std::abs(fAtomicNumber) * std::sqrt(x) *
+                      std::max(0., 1 + 0.038 * std::log(x * fAtomicNumber * fAtomicNumber / (beta * beta)));
+      thetaVar = theta0 * theta0;
+   }
+   double momSigma = fStraggling * std::abs(p - std::sqrt(momentum(state).Mag2()));
+   for (int i = 0; i < 3; ++i) {
+      for (int j = 0; j < 3; ++j) {
+         double perp = (i == j ? 1 : 0) - d[i] * d[j];
+         newCov(i, j) += length * length / 3 * thetaVar * perp;
+         newCov(i, j + 3) += length / 2 * p * thetaVar * perp;
+         newCov(i + 3, j) += length / 2 * p * thetaVar * perp;
+         newCov(i + 3, j + 3) += p * p * thetaVar * perp + momSigma * momSigma * d[i] * d[j];
+      }
+   }
+
+   state = mean;
+   cov = newCov;
+   return true;
+}
+
+/**
+ * Kalman update with the position of the cluster in the plane perpendicular to the track. The
+ * measurement is linear in the state, so this needs no sigma points. Returns the chi2 of the update,
+ * or -1 if it failed.
+ */
+Double_t AtFITTER::AtUKFFitter::Update(StateVector &state, StateMatrix &cov, const Measurement &meas) const
+{
+   auto dir = momentum(state).Unit();
+   auto u = dir.Cross(XYZVector(0, 0, 1));
+   if (u.Mag2() < 1e-6)
+      u = dir.Cross(XYZVector(1, 0, 0));
+   u = u.Unit();
+   auto v = dir.Cross(u);
+
+   ROOT::Math::SMatrix<double, 2, 3> proj;
+   proj(0, 0) = u.X();
+   proj(0, 1) = u.Y();
+   proj(0, 2) = u.Z();
+   proj(1, 0) = v.X();
+   proj(1, 1) = v.Y();
+   proj(1, 2) = v.Z();
+   ROOT::Math::SMatrix<double, 2, 6> H;
+   for (int i = 0; i < 2; ++i)
+      for (int j = 0; j < 3; ++j)
+         H(i, j) = proj(i, j);
+
+   ROOT::Math::SMatrix<double, 2, 2> measCov = proj * meas.cov * ROOT::Math::Transpose(proj);
+   for (int i = 0; i < 2; ++i)
+      measCov(i, i) = std::max(measCov(i, i), fMinPosSigma * fMinPosSigma);
+
+   auto diff = position(state) - meas.pos;
+   ROOT::Math::SVector<double, 2> residual(-diff.Dot(u), -diff.Dot(v));
+   ROOT::Math::SMatrix<double, 2, 2> invResCov = H * cov * ROOT::Math::Transpose(H) + measCov;
+   if (!invResCov.Invert())
+      return -1;
+
+   ROOT::Math::SMatrix<double, 6, 2> gain = cov * ROOT::Math::Transpose(H) * invResCov;
+   state += gain * residual;
+   StateMatrix update = ROOT::Math::SMatrixIdentity();
+   update -= gain * H;
+   cov = update * cov * ROOT::Math::Transpose(update) + gain * measCov * ROOT::Math::Transpose(gain);
+
+   return ROOT::Math::Dot(residual, invResCov * residual);
+}
+
+/**
+ * Filter through the measurements from first to last, backwards if last is before first, starting
+ * from a state at the first one. The pass ends early if the particle stops before reaching a
+ * measurement. Returns the number of measurements used, or -1 if an update failed.
+ */
+Int_t AtFITTER::AtUKFFitter::FitPass(StateVector &state, StateMatrix &cov, const std::vector<Measurement> &meas,
+                                     Int_t first, Int_t last, Double_t &chi2, Int_t &ndf, Double_t &length) const
+{
+   chi2 = 0;
+   ndf = -cDim;
+   length = 0;
+
+   int dir = last < first ? -1 : 1;
+   int numUsed = 0;
+   for (int i = first; i != last + dir; i += dir) {
+      double step = 0;
+      if (i != first && (!LengthToPOCA(state, meas[i].pos, step) || !Predict(state, cov, step)))
+         break;
+
+      auto updateChi2 = Update(state, cov, meas[i]);
+      if (updateChi2 < 0)
+         return -1;
+      chi2 += updateChi2;
+      ndf += 2;
+      length += std::abs(step);
+      ++numUsed;
+   }
+   return numUsed;
+}
+
+/**
+ * Extrapolate state backwards (against its momentum) to the first point of closest approach to the
+ * beam (z) axis, at most cMaxXtrLength away. The minimum is bracketed by stepping back with growing
+ * steps until approachRate changes sign, and then refined as the root of approachRate.
+ * Returns the (negative) length extrapolated in mm.
+ */
+Double_t AtFITTER::AtUKFFitter::ExtrapolateToBeamPOCA(StateVector &state) const
+{
+   double s = 0;
+   double g = approachRate(state);
+   if (g <= 0)
+      return s;
+
+   double maxStep = cMaxXtrStep;
+   auto w = GetCurvature(std::sqrt(momentum(state).Mag2()));
+   if (w != 0)
+      maxStep = std::min(maxStep, TMath::PiOver2() / std::abs(w));
+
+   // Bracket the minimum, where g goes from positive to negative, stepping backwards
+   double sHigh = 0;
+   double gHigh = g;
+   double step = std::min(cFirstXtrStep, maxStep);
+   while (g > 0) {
+      if (s <= -cMaxXtrLength)
+         return s;
+      double next = std::max(s - step, -cMaxXtrLength);
+      if (!Propagate(state, next - s))
+         return s;
+      s = next;
+      g = approachRate(state);
+      if (g > 0) {
+         sHigh = s;
+         gHigh = g;
+      }
+      step = std::min(2 * step, maxStep);
+   }
+   double sLow = s;
+   double gLow = g;
+
+   // Illinois variant of regula falsi for the root of g
+   int lastSide = 0;
+   for (int i = 0; i < 50; ++i) {
+      double next = (sLow * gHigh - sHigh * gLow) / (gHigh - gLow);
+      bool done = std::abs(next - s) < cXtrTolerance;
+      if (!Propagate(state, next - s))
+         return s;
+      s = next;
+      if (done)
+         break;
+      g = approachRate(state);
+      if (g > 0) {
+         sHigh = s;
+         gHigh = g;
+         if (lastSide == 1)
+            gLow /= 2;
+         lastSide = 1;
+      } else {
+         sLow = s;
+         gLow = g;
+         if (lastSide == -1)
+            gHigh /= 2;
+         lastSide = -1;
+      }
+   }
+   return s;
+}
+
+std::vector<std::unique_ptr<AtFittedTrack>> AtFITTER::AtUKFFitter::ProcessTracks(std::vector<AtTrack> &tracks)
+{
+   std::vector<std::unique_ptr<AtFittedTrack>> fittedTracks;
+   for (auto &track : tracks) {
+      if (track.GetTrackID() == -1 || track.GetHitClusterArray()->size() < 3) {
+         LOG(debug) << "Skipping track " << track.GetTrackID() << " that is noise or has less than 3 clusters.";
+         continue;
+      }
+
+      auto fittedTrack = FitTrack(track);
+      if (fittedTrack)
+         fittedTracks.push_back(std::move(fittedTrack));
+   }
+   return fittedTracks;
+}
+
+std::unique_ptr<AtFittedTrack> AtFITTER::AtUKFFitter::FitTrack(AtTrack &track) const
+{
+   auto meas = GetMeasurements(track);
+   if (meas.size() < 3)
+      return nullptr;
+
+   StateVector state;
+   if (!SeedState(track, meas, state))
+      return nullptr;
+
+   double mom = std::sqrt(momentum(state).Mag2());
+   StateMatrix cov;
+   for (int i = 0; i < cDim; ++i)
+      cov(i, i) = GetMaxVariance(i, mom);
+
+   Double_t fChi2 = 0, bChi2 = 0, length = 0;
+   Int_t fNdf = 0, bNdf = 0, numUsed = 0;
+   bool converged = false;
+   const Int_t numMeas = meas.size();
+   for (int iter = 0; iter < fMaxIterations && !converged; ++iter) {
+      // If the particle stops before the end of the track (the energy is underestimated), or the
+      // state at the end is too poor to fit backwards from, the backward pass starts over from the
+      // last cluster
+      numUsed = FitPass(state, cov, meas, 0, numMeas - 1, fChi2, fNdf, length);
+      if (numUsed < 0)
+         return nullptr;
+      auto endState = state;
+      auto endCov = cov;
+      if (numUsed < numMeas)
+         ReseedAtEnd(meas, state, cov);
+      else
+         BlowUp(cov, std::sqrt(momentum(state).Mag2()));
+      if (FitPass(state, cov, meas, numMeas - 1, 0, bChi2, bNdf, length) != numMeas) {
+         if (numUsed < numMeas)
+            return nullptr;
+         state = endState;
+         cov = endCov;
+         ReseedAtEnd(meas, state, cov);
+         if (FitPass(state, cov, meas, numMeas - 1, 0, bChi2, bNdf, length) != numMeas)
+            return nullptr;
+      }
+
+      double newMom = std::sqrt(momentum(state).Mag2());
+      converged = std::abs(newMom - mom) < fConvergence * mom;
+      mom = newMom;
+      if (!converged)
+         BlowUp(cov, mom);
+   }
+
+   // A fit that turned around to run along the track the wrong way is not a fit of this track
+   if (momentum(state).Dot(meas[std::min(3, numMeas - 1)].pos - meas[0].pos) < 0) {
+      LOG(debug) << "Track " << track.GetTrackID() << " fit in the wrong direction";
+      return nullptr;
+   }
+
+   auto pos = position(state);
+   auto energy = GetKineticEnergy(mom);
+
+   // The angles are those at the vertex
+   StateVector stateXtr = state;
+   auto distXtr = ExtrapolateToBeamPOCA(stateXtr);
+   auto posXtr = position(stateXtr);
+   auto momXtr = momentum(stateXtr);
+   auto energyXtr = GetKineticEnergy(std::sqrt(momXtr.Mag2()));
+   LOG(debug) << "Track " << track.GetTrackID() << " fit with " << numMeas << " clusters, E " << energy
+              << " MeV, extrapolated " << distXtr << " mm to POCA " << posXtr.Rho() << " mm";
+
+   // Kinematics from pattern recognition
+   Double_t theta = track.GetGeoTheta();
+   Double_t brhoPRA = fMagneticField * track.GetGeoRadius() / 1000.0 / TMath::Sin(theta); // Tm
+   auto energyPRA = GetKineticEnergy(brhoPRA * cMomPerTmm * 1000.0 * fAtomicNumber);
+
+   Double_t charge = 0;
+   for (auto &cluster : *track.GetHitClusterArray())
+      charge += cluster.GetCharge();
+
+   auto fittedTrack = std::make_unique<AtFittedTrack>();
+   fittedTrack->SetTrackID(track.GetTrackID());
+   fittedTrack->SetEnergyAngles(energy, energyXtr, momXtr.Theta() * TMath::RadToDeg(),
+                                momXtr.Phi() * TMath::RadToDeg(), energyPRA, theta * TMath::RadToDeg(),
+                                track.GetGeoPhi() * TMath::RadToDeg());
+   fittedTrack->SetVertexPosition(pos * cMmToCm, meas[0].pos * cMmToCm, posXtr * cMmToCm);
+   fittedTrack->SetStats(TMath::Prob(bChi2, bNdf), fChi2, bChi2, fNdf, bNdf, converged);
+   fittedTrack->SetTrackProperties(fAtomicNumber, mom / (cMomPerTmm * 1000.0 * fAtomicNumber),
+                                   charge / track.GetHitClusterArray()->size(), charge / (length * cMmToCm),
+                                   std::to_string(fPDGCode), track.GetHitArray().size());
+   fittedTrack->SetDistances(distXtr * cMmToCm, length * cMmToCm, posXtr.Rho() * cMmToCm);
+   return fittedTrack;
+}
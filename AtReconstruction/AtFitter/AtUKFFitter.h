@@ -0,0 +1,137 @@
+#ifndef ATUKFFITTER_H
+#define ATUKFFITTER_H
+
+#include "AtFitter.h"
+
+#include <Math/SMatrix.h>
+#include <Math/SVector.h>
+#include <Math/Vector3D.h>
+#include <Rtypes.h>
+
+#include <memory>
+#include <vector>
+
+class AtFittedTrack;
+class AtTrack;
+class TBuffer;
+class TClass;
+class TMemberInspector;
+
+namespace AtTools {
+class AtELossModel;
+}
+
+namespace AtFITTER {
+
+/**
+ * Fits the hit clusters of a track with an unscented Kalman filter, without GENFIT or a geometry.
+ *
+ * The state is the position (mm) and momentum (MeV/c) of the particle in the frame of the hits.
+ * Between clusters the sigma points are propagated along a helix in a constant magnetic field
+ * along z, in steps no longer than fMaxStep over which the energy loss comes from an AtELossModel.
+ * Each cluster is a measurement of the two coordinates perpendicular to the track at its point of
+ * closest approach, so the spread of a cluster along the track does not bias the fit. Multiple
+ * scattering (if a radiation length is set) and energy straggling are added as process noise.
+ *
+ * A track is fit forwards from the end closest to the beam axis (the vertex), then backwards from
+ * the other end with the covariance blown up, until the momentum at the vertex converges. The result
+ * of the last backward pass is extrapolated back to the point of closest approach to the beam axis.
+ * All matrices are fixed size, so propagating and updating does not allocate.
+ *
+ * Positions and distances in the AtFittedTrack are in cm in the frame of the hits (like AtGenfit),
+ * the dE/dx in charge per cm, energies in MeV, and angles in degrees. Internally everything is in mm.
+ */
+class AtUKFFitter : public AtFitter {
+public:
+   using StateVector = ROOT::Math::SVector<double, 6>;
+   using StateMatrix = ROOT::Math::SMatrix<double, 6, 6>;
+   using XYZVector = ROOT::Math::XYZVector;
+
+private:
+   /// Position and covariance of a hit cluster
+   struct Measurement {
+      XYZVector pos;
+      ROOT::Math::SMatrix<double, 3, 3> cov;
+   };
+
+   std::shared_ptr<AtTools::AtELossModel> fELossModel; //!
+
+   Double_t fMagneticField;          //< Constant magnetic field along z in T
+   Double_t fMass{1.00727647};       //< Particle mass in atomic mass unit
+   Int_t fAtomicNumber{1};           //< Particle charge in e
+   Int_t fPDGCode{2212};             //< Particle PDG code
+   Double_t fMaxStep{2};             //< Maximum step (mm) of the energy loss integration
+   Double_t fRadiationLength{0};     //< Radiation length of the gas in mm, 0 disables multiple scattering
+   Double_t fStraggling{0.05};       //< Relative spread of the energy loss
+   Double_t fMinPosSigma{0.5};       //< Minimum position resolution (mm) of a cluster
+   Double_t fSeedMomSigma{0.2};      //< Relative uncertainty of the seed momentum
+   Double_t fBlowUpFactor{100};      //< Scale of the covariance when reversing the direction of the fit
+   Int_t fMaxIterations{5};          //< Maximum number of forward and backward passes
+   Double_t fConvergence{1e-3};      //< Relative change in momentum at the vertex considered converged
+   Double_t fAlpha{0.1};             //< Spread of the sigma points
+   Double_t fBeta{2};                //< Prior knowledge of the state distribution (2 for gaussian)
+   Double_t fKappa{0};               //< Secondary spread of the sigma points
+
+public:
+   AtUKFFitter(std::shared_ptr<AtTools::AtELossModel> eLossModel, Double_t magneticField);
+   ~AtUKFFitter() = default;
+
+   std::vector<std::unique_ptr<AtFittedTrack>> ProcessTracks(std::vector<AtTrack> &tracks) override;
+   void Init() override;
+
+   /// Fit a single track, returns nullptr if it could not be fit.
+   std::unique_ptr<AtFittedTrack> FitTrack(AtTrack &track) const;
+
+   void SetELossModel(std::shared_ptr<AtTools::AtELossModel> model) { fELossModel = std::move(model); }
+   void SetMagneticField(Double_t field) { fMagneticField = field; }
+   void SetMass(Double_t mass) { fMass = mass; }
+   void SetAtomicNumber(Int_t znumber) { fAtomicNumber = znumber; }
+   void SetPDGCode(Int_t pdgcode) { fPDGCode = pdgcode; }
+   void SetMaxStep(Double_t step) { fMaxStep = step; }
+   void SetRadiationLength(Double_t length) { fRadiationLength = length; }
+   void SetStraggling(Double_t straggling) { fStraggling = straggling; }
+   void SetMinPosSigma(Double_t sigma) { fMinPosSigma = sigma; }
+   void SetSeedMomSigma(Double_t sigma) { fSeedMomSigma = sigma; }
+   void SetBlowUpFactor(Double_t factor) { fBlowUpFactor = factor; }
+   void SetMaxIterations(Int_t maxit) { fMaxIterations = maxit; }
+   void SetConvergence(Double_t convergence) { fConvergence = convergence; }
+   void SetUKFParameters(Double_t alpha, Double_t beta, Double_t kappa)
+   {
+      fAlpha = alpha;
+      fBeta = beta;
+      fKappa = kappa;
+   }
+
+   /**
+    * Propagate the state by length (mm) along the helix, backwards if length is negative.
+    * Returns false if the particle stops before the end.
+    */
+   bool Propagate(StateVector &state, Double_t length) const;
+
+private:
+   Double_t GetMassMeV() const;
+   Double_t GetKineticEnergy(Double_t mom) const;
+   Double_t GetMomentum(Double_t energy) const;
+   /// Signed rotation (rad/mm) of the direction around z for the momentum mom
+   Double_t GetCurvature(Double_t mom) const;
+
+   std::vector<Measurement> GetMeasurements(AtTrack &track) const;
+   Double_t GetMomentumForRange(Double_t range) const;
+   bool SeedState(AtTrack &track, const std::vector<Measurement> &meas, StateVector &state) const;
+   void ReseedAtEnd(const std::vector<Measurement> &meas, StateVector &state, StateMatrix &cov) const;
+   Double_t GetMaxVariance(Int_t i, Double_t mom) const;
+   void BlowUp(StateMatrix &cov, Double_t mom) const;
+
+   bool LengthToPOCA(const StateVector &state, const XYZVector &point, Double_t &length) const;
+   bool Predict(StateVector &state, StateMatrix &cov, Double_t length) const;
+   Double_t Update(StateVector &state, StateMatrix &cov, const Measurement &meas) const;
+   Int_t FitPass(StateVector &state, StateMatrix &cov, const std::vector<Measurement> &meas, Int_t first, Int_t last,
+                 Double_t &chi2, Int_t &ndf, Double_t &length) const;
+   Double_t ExtrapolateToBeamPOCA(StateVector &state) const;
+
+   ClassDefOverride(AtUKFFitter, 1);
+};
+
+} // namespace AtFITTER
+
+#endif
@@ -19,12 +19,16 @@
 #include <TGraph.h>           // for TGraph
 #include <TMath.h>            // for Power, Sqrt, ATan2, Pi
 
-#include <algorithm> // for max, for_each, copy_if
+#include "kdtree.hpp" // for KdTree, KdNode, KdNodePredicate
+
+#include <algorithm> // for max, min, for_each, copy_if, partial_sort, any_of
 #include <cmath>     // for fabs, acos
 #include <cstddef>   // for size_t
 #include <exception> // for exception
 #include <iostream>  // for operator<<, basic_ostream
 #include <memory>    // for shared_ptr, __shared_p...
+#include <thread>    // for thread
+#include <vector>    // for vector
 ClassImp(AtPATTERN::AtPRA);
 
 /**
@@ -205,6 +209,32 @@ Double_t fitf(Double_t *x, Double_t *par)
    return par[0] + par[1] * x[0];
 }
 
+namespace {
+/// Accepts the nodes of hits that were not pruned. The data of each node points to the index of its hit.
+class NotPruned : public Kdtree::KdNodePredicate {
+   const std::vector<bool> &fPruned;
+
+public:
+   NotPruned(const std::vector<bool> &pruned) : fPruned(pruned) {}
+   bool operator()(const Kdtree::KdNode &node) const override
+   {
+      return !fPruned[*static_cast<const Int_t *>(node.data)];
+   }
+};
+
+/// Number of neighbours to average over when there are numHits hits left
+Int_t GetNumNeighbours(Int_t k, std::size_t numHits)
+{
+   return (k < 0 || k > numHits) ? numHits : k;
+}
+} // namespace
+
+/**
+ * Hits are removed as they are found to be noise, so whether a hit is noise depends on the earlier hits
+ * that were removed, and the hit after a removed one is not checked. The k nearest neighbours of every
+ * hit are first found among all the hits in parallel, and are only searched for again for the hits that
+ * lost one of them.
+ */
 void AtPATTERN::AtPRA::PruneTrack(AtTrack &track)
 {
    auto &hitArray = track.GetHitArray();
@@ -212,21 +242,85 @@ void AtPATTERN::AtPRA::PruneTrack(AtTrack &track)
    std::cout << "    === Prunning track : " << track.GetTrackID() << "\n";
    std::cout << "      = Hit Array size : " << hitArray.size() << "\n";
 
-   for (auto iHit = 0; iHit < hitArray.size(); ++iHit) {
+   Int_t numHits = hitArray.size();
+   if (numHits == 0)
+      return;
+
+   std::vector<Int_t> hitIndex(numHits);
+   Kdtree::KdNodeVector nodes;
+   nodes.reserve(numHits);
+   for (Int_t i = 0; i < numHits; ++i) {
+      hitIndex[i] = i;
+      const auto &pos = hitArray[i]->GetPosition();
+      nodes.emplace_back(Kdtree::CoordPoint{pos.X(), pos.Y(), pos.Z()}, &hitIndex[i]);
+   }
 
-      try {
-         bool isNoise = kNN(hitArray, *hitArray.at(iHit), fKNN); // Returns true if hit is an outlier
+   // Neighbours and noise flag of each hit among all hits
+   auto k = GetNumNeighbours(fKNN, numHits);
+   std::vector<Int_t> neighbours(numHits * k);
+   std::vector<char> isNoise(numHits);
+   auto findNeighbours = [&](Int_t begin, Int_t end) {
+      Kdtree::KdTree tree(&nodes); // Searching modifies the tree so each thread needs its own
+      Kdtree::KdNodeVector result;
+      std::vector<Double_t> distances;
+      for (Int_t i = begin; i < end; ++i) {
+         distances.clear();
+         tree.k_nearest_neighbors(nodes[i].point, k, &result, &distances);
+         for (Int_t j = 0; j < k; ++j)
+            neighbours[i * k + j] = *static_cast<Int_t *>(result[j].data);
+         isNoise[i] = kNNIsNoise(distances);
+      }
+   };
+
+   auto numThreads = std::max(1, std::min(fNumThreads, numHits));
+   if (numThreads == 1) {
+      findNeighbours(0, numHits);
+   } else {
+      auto hitsPerTh = numHits / numThreads;
+      auto remainder = numHits % numThreads;
+      std::vector<std::thread> threads;
+      Int_t begin = 0;
+      for (Int_t i = 0; i < numThreads; ++i) {
+         auto end = begin + hitsPerTh + (i < remainder ? 1 : 0);
+         threads.emplace_back(findNeighbours, begin, end);
+         begin = end;
+      }
+      for (auto &th : threads)
+         th.join();
+   }
 
-         if (isNoise) {
-            // std::cout<<" Hit "<<iHit<<" flagged as outlier. "<<"\n";
-            hitArray.erase(hitArray.begin() + iHit);
-         }
-      } catch (std::exception &e) {
+   // Remove the noise in order, searching again among the hits left when a neighbour was removed
+   std::vector<bool> pruned(numHits, false);
+   NotPruned notPruned(pruned);
+   std::unique_ptr<Kdtree::KdTree> tree;
+   Kdtree::KdNodeVector result;
+   std::vector<Double_t> distances;
+   Int_t numLeft = numHits;
+   for (Int_t i = 0; i < numHits; ++i) {
+      bool noise = isNoise[i];
+      auto kLeft = GetNumNeighbours(fKNN, numLeft);
+      auto first = neighbours.begin() + i * k;
+      if (kLeft != k || std::any_of(first, first + k, [&pruned](Int_t j) { return pruned[j]; })) {
+         if (tree == nullptr)
+            tree = std::make_unique<Kdtree::KdTree>(&nodes);
+         distances.clear();
+         tree->k_nearest_neighbors(nodes[i].point, kLeft, &result, &distances, &notPruned);
+         noise = kNNIsNoise(distances);
+      }
 
-         std::cout << " AtPRA::PruneTrack - Exception caught : " << e.what() << "\n";
+      if (noise) {
+         pruned[i] = true;
+         --numLeft;
+         ++i; // The next hit took the place of this one in the array
       }
    }
 
+   Int_t numKept = 0;
+   for (Int_t i = 0; i < numHits; ++i)
+      if (!pruned[i])
+         hitArray[numKept++] = std::move(hitArray[i]);
+   hitArray.resize(numKept);
+
    std::cout << "      = Hit Array size after prunning : " << hitArray.size() << "\n";
 }
 
@@ -237,26 +331,34 @@ bool AtPATTERN::AtPRA::kNN(const std::vector<std::unique_ptr<AtHit>> &hits, AtHi
    distances.reserve(hits.size());
 
    std::for_each(hits.begin(), hits.end(), [&distances, &hitRef](const std::unique_ptr<AtHit> &hit) {
-      distances.push_back(TMath::Sqrt((hitRef.GetPosition() - hit->GetPosition()).Mag2()));
+      distances.push_back((hitRef.GetPosition() - hit->GetPosition()).Mag2());
    });
 
-   std::sort(distances.begin(), distances.end(), [](Double_t a, Double_t b) { return a < b; });
+   k = GetNumNeighbours(k, hits.size());
+   std::partial_sort(distances.begin(), distances.begin() + k, distances.end());
+   distances.resize(k);
+
+   return kNNIsNoise(distances);
+}
+
+bool AtPATTERN::AtPRA::kNNIsNoise(std::vector<Double_t> &distances) const
+{
+   for (auto &dist : distances)
+      dist = TMath::Sqrt(dist);
 
    Double_t mean = 0.0;
    Double_t stdDev = 0.0;
-
-   if (k > hits.size())
-      k = hits.size();
+   int k = distances.size();
 
    // Compute mean distance of kNN
    for (auto i = 0; i < k; ++i)
-      mean += distances.at(i);
+      mean += distances[i];
 
    mean /= k;
 
    // Compute std dev
    for (auto i = 0; i < k; ++i)
-      stdDev += TMath::Power((distances.at(i) - mean), 2);
+      stdDev += TMath::Power((distances[i] - mean), 2);
 
    stdDev = TMath::Sqrt(stdDev / k);
 
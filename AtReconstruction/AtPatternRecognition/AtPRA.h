@@ -41,6 +41,7 @@ protected:
    Int_t fKNN{5};             //<! Number of nearest neighbors kNN
    Double_t fStdDevMulkNN{0}; //<! Std dev multiplier for kNN
    Double_t fkNNDist{10};     //<! Distance threshold for outlier rejection in kNN
+   Int_t fNumThreads{1};      //<! Number of threads used to find the kNN of the hits when prunning
 
    Bool_t kSetPrunning{false}; //<<! Enable prunning of tracks
 
@@ -61,16 +62,24 @@ public:
    void SetkNN(Double_t knn) { fKNN = knn; }
    void SetStdDevMulkNN(Double_t stdDevMul) { fStdDevMulkNN = stdDevMul; }
    void SetkNNDist(Double_t dist) { fkNNDist = dist; }
+   void SetNumThreads(Int_t num) { fNumThreads = num; }
    void SetPrunning() { kSetPrunning = kTRUE; }
    void SetClusterRadius(Double_t clusterRadius) { fClusterRadius = clusterRadius; }
    void SetClusterDistance(Double_t clusterDistance) { fClusterDistance = clusterDistance; }
 
    virtual std::unique_ptr<AtPatternEvent> FindTracks(AtEvent &event) = 0;
 
+   /// Remove the hits of the track that are noise according to kNN
    void PruneTrack(AtTrack &track);
+   /// Returns true if hit is noise: the mean distance of its k nearest neighbours in hits (+ fStdDevMulkNN std dev)
+   /// is not below fkNNDist
    bool kNN(const std::vector<std::unique_ptr<AtHit>> &hits, AtHit &hit, int k);
 
 protected:
+   /// kNN criterion from the squared distances of the k nearest neighbours (in increasing order). Replaces
+   /// them with the distances.
+   bool kNNIsNoise(std::vector<Double_t> &distances) const;
+
    // Functions that need to be moved to another class. They assume a curved track
    /*
     * Takes track and sets fGeo... parameters using SampleConsensus. I think these are then used
@@ -96,7 +105,7 @@ protected:
       return GetSign(num, std::is_signed<T>());
    }
 
-   ClassDef(AtPRA, 1)
+   ClassDef(AtPRA, 2)
 };
 
 } // namespace AtPATTERN
@@ -22,6 +22,7 @@
 #include <iostream> // for cout, cerr
 #include <memory>   // for allocator_traits<>::value_...
 #include <utility>  // for move
+#include <vector>   // for vector
 
 constexpr auto cRED = "\033[1;31m";
 constexpr auto cYELLOW = "\033[1;33m";
@@ -109,8 +110,7 @@ void AtPATTERN::AtTrackFinderHC::eventToClusters(AtEvent &event, pcl::PointCloud
 
    for (Int_t iHit = 0; iHit < nHits; iHit++) {
 
-      const AtHit hit = event.GetHit(iHit);
-      auto position = hit.GetPosition();
+      const auto &position = event.GetHit(iHit).GetPosition();
       cloud->points[iHit].x = position.X();
       cloud->points[iHit].y = position.Y();
       cloud->points[iHit].z = position.Z();
@@ -120,37 +120,27 @@ void AtPATTERN::AtTrackFinderHC::eventToClusters(AtEvent &event, pcl::PointCloud
 }
 
 std::unique_ptr<AtPatternEvent> AtPATTERN::AtTrackFinderHC::clustersToTrack(pcl::PointCloud<pcl::PointXYZI>::Ptr cloud,
-                                                                            Cluster const cluster, AtEvent &event)
+                                                                            const Cluster &cluster, AtEvent &event)
 {
-   std::vector<AtTrack> tracks;
+   const auto &clusters = cluster.getClusters();
 
-   std::vector<pcl::PointXYZI, Eigen::aligned_allocator<pcl::PointXYZI>> points = cloud->points;
+   std::vector<AtTrack> tracks;
+   tracks.reserve(clusters.size());
 
-   std::vector<pcl::PointIndicesPtr> clusters = cluster.getClusters();
+   // Points that are in at least one cluster, the rest is noise
+   std::vector<bool> isClustered(cloud->size(), false);
 
    for (size_t clusterIndex = 0; clusterIndex < clusters.size(); ++clusterIndex) {
 
-      AtTrack track; // One track per cluster
-
-      pcl::PointIndicesPtr const &pointIndices = clusters[clusterIndex];
-      // get color colour
-
-      for (int index : pointIndices->indices) {
-         pcl::PointXYZI point = cloud->points[index];
-
-         track.AddHit(event.GetHit(point.intensity));
-
-         // remove clustered points from point-vector
-         for (auto it = points.end(); it != points.begin(); --it) {
-            if (it->x == point.x && it->y == point.y && it->z == point.z) {
-
-               if (it != points.end()) {
-                  points.erase(it);
-                  break;
-               }
-            }
-         }
+      tracks.emplace_back(); // One track per cluster
+      auto &track = tracks.back();
 
+      const auto &indices = clusters[clusterIndex]->indices;
+      track.GetHitArray().reserve(indices.size());
+      for (int index : indices) {
+         auto hitIndex = static_cast<Int_t>(cloud->points[index].intensity);
+         track.AddHit(std::make_unique<AtHit>(event.GetHit(hitIndex)));
+         isClustered[index] = true;
       } // Indices loop
 
       track.SetTrackID(clusterIndex);
@@ -160,16 +150,15 @@ std::unique_ptr<AtPatternEvent> AtPATTERN::AtTrackFinderHC::clustersToTrack(pcl:
       if (kSetPrunning)
          PruneTrack(track);
 
-      tracks.push_back(track);
-
    } // Clusters loop
 
    std::cout << cRED << " Tracks found " << tracks.size() << cNORMAL << "\n";
 
    // Dump noise into pattern event
    auto retEvent = std::make_unique<AtPatternEvent>();
-   for (const auto &point : points)
-      retEvent->AddNoise(event.GetHit(point.intensity));
+   for (size_t i = 0; i < cloud->size(); ++i)
+      if (!isClustered[i])
+         retEvent->AddNoise(event.GetHit(static_cast<Int_t>(cloud->points[i].intensity)));
 
    for (auto &track : tracks) {
       if (track.GetHitArray().size() > 0)
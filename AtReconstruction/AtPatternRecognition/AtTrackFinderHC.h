@@ -69,7 +69,7 @@ private:
                   float cdist, size_t cleanup_min_triplets, int opt_verbose);
 
    std::unique_ptr<AtPatternEvent>
-   clustersToTrack(pcl::PointCloud<pcl::PointXYZI>::Ptr cloud, Cluster const cluster, AtEvent &event);
+   clustersToTrack(pcl::PointCloud<pcl::PointXYZI>::Ptr cloud, const Cluster &cluster, AtEvent &event);
 
    void eventToClusters(AtEvent &event, pcl::PointCloud<pcl::PointXYZI>::Ptr cloud);
 
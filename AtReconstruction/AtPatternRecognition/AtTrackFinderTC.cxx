@@ -19,6 +19,7 @@
 #include <iostream> // for cout, cerr
 #include <memory>   // for allocator_traits<>::value_...
 #include <utility>  // for move
+#include <vector>   // for vector
 
 constexpr auto cRED = "\033[1;31m";
 constexpr auto cYELLOW = "\033[1;33m";
@@ -95,8 +96,7 @@ void AtPATTERN::AtTrackFinderTC::eventToClusters(AtEvent &event, PointCloud &clo
 
    for (Int_t iHit = 0; iHit < nHits; iHit++) {
       Point point;
-      const AtHit hit = event.GetHit(iHit);
-      auto position = hit.GetPosition();
+      const auto &position = event.GetHit(iHit).GetPosition();
       point.x = position.X();
       point.y = position.Y();
       point.z = position.Z();
@@ -110,33 +110,21 @@ AtPATTERN::AtTrackFinderTC::clustersToTrack(PointCloud &cloud, const std::vector
 {
 
    std::vector<AtTrack> tracks;
-   // std::vector<Point> points = cloud;
-   auto points = cloud;
+   tracks.reserve(clusters.size());
 
    for (size_t cluster_index = 0; cluster_index < clusters.size(); ++cluster_index) {
 
-      AtTrack track; // One track per cluster
-
       const std::vector<size_t> &point_indices = clusters[cluster_index];
       if (point_indices.size() == 0)
          continue;
 
-      // add points
-      for (auto ind : point_indices) {
-
-         const Point &point = cloud[ind];
-
-         track.AddHit(event.GetHit(point.GetID()));
+      tracks.emplace_back(); // One track per cluster
+      auto &track = tracks.back();
 
-         // remove current point from vector points
-         for (auto p = points.begin(); p != points.end(); p++) {
-            if (*p == point) {
-               points.erase(p);
-               break;
-            }
-         }
-
-      } // Point indices
+      // add points
+      track.GetHitArray().reserve(point_indices.size());
+      for (auto ind : point_indices)
+         track.AddHit(std::make_unique<AtHit>(event.GetHit(cloud[ind].GetID())));
 
       track.SetTrackID(cluster_index);
 
@@ -145,16 +133,15 @@ AtPATTERN::AtTrackFinderTC::clustersToTrack(PointCloud &cloud, const std::vector
       if (kSetPrunning)
          PruneTrack(track);
 
-      tracks.push_back(track);
-
    } // Clusters loop
 
    std::cout << cRED << " Tracks found " << tracks.size() << cNORMAL << "\n";
 
    // Dump noise into pattern event
    auto retEvent = std::make_unique<AtPatternEvent>();
-   for (const auto &point : points)
-      retEvent->AddNoise(event.GetHit(point.GetID()));
+   for (const auto &point : cloud)
+      if (point.cluster_ids.empty()) // Labels of the clusters the point is in, set by add_clusters
+         retEvent->AddNoise(event.GetHit(point.GetID()));
 
    for (auto &track : tracks) {
       if (track.GetHitArray().size() > 0)
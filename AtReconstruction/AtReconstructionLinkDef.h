@@ -39,11 +39,13 @@
 
 #pragma link C++ class AtMacroTask + ;
 
+#pragma link C++ namespace AtFITTER;
+#pragma link C++ class AtFITTER::AtFitter + ;
+#pragma link C++ class AtFITTER::AtUKFFitter + ;
+
 /* Classes that depend on Genfit2 */
 #pragma link C++ class genfit::AtSpacepointMeasurement + ;
-#pragma link C++ class AtFITTER::AtFitter + ;
 #pragma link C++ class AtFITTER::AtGenfit + ;
-#pragma link C++ namespace AtFITTER;
 #pragma link C++ class AtFitterTask + ;
 
 #pragma link C++ namespace MCFitter;
@@ -60,6 +62,7 @@
 #pragma link C++ class AtRansacTask + ;
 #pragma link C++ class AtSampleConsensusTask + ;
 #pragma link C++ class AtDataReductionTask + ;
+#pragma link C++ class AtEntrySelector - !;
 #pragma link C++ class AtSpaceChargeCorrectionTask + ;
 #pragma link C++ class AtFilterTask + ;
 #pragma link C++ class AtHDF5WriteTask + ;
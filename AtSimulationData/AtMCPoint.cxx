@@ -11,12 +11,20 @@
 
 #include <TVector3.h>
 
+#include <algorithm> // for find
+#include <array>
 #include <iostream>
+#include <iterator> // for begin, end
 #include <utility>
 
 using std::cout;
 using std::endl;
 
+namespace {
+/// Name of the volume with each AtMCPoint::VolumeID
+const std::array<const char *, 3> fVolumeNames = {"drift_volume", "tpc_window", "cell"};
+} // namespace
+
 AtMCPoint::AtMCPoint() : FairMCPoint() {}
 
 AtMCPoint::AtMCPoint(Int_t trackID, Int_t detID, TVector3 pos, TVector3 mom, Double_t tof, Double_t length,
@@ -27,11 +35,40 @@ AtMCPoint::AtMCPoint(Int_t trackID, Int_t detID, TVector3 pos, TVector3 mom, Dou
 
 AtMCPoint::AtMCPoint(Int_t trackID, Int_t detID, TVector3 pos, TVector3 mom, Double_t tof, Double_t length,
                      Double_t eLoss, TString VolName, Int_t detCopyID, Double_t EIni, Double_t AIni, Int_t A, Int_t Z)
-   : FairMCPoint(trackID, detID, pos, mom, tof, length, eLoss), fDetCopyID(detCopyID), fVolName(std::move(VolName)),
+   : AtMCPoint(trackID, detID, pos, mom, tof, length, eLoss, FindVolID(VolName), detCopyID, EIni, AIni, A, Z)
+{
+   if (fVolID == kOtherVolume)
+      fVolName = std::move(VolName);
+}
+
+AtMCPoint::AtMCPoint(Int_t trackID, Int_t detID, TVector3 pos, TVector3 mom, Double_t tof, Double_t length,
+                     Double_t eLoss, Int_t volID, Int_t detCopyID, Double_t EIni, Double_t AIni, Int_t A, Int_t Z)
+   : FairMCPoint(trackID, detID, pos, mom, tof, length, eLoss), fDetCopyID(detCopyID), fVolID(volID),
      fEnergyIni(EIni), fAngleIni(AIni), fAiso(A), fZiso(Z)
 {
 }
 
+Int_t AtMCPoint::FindVolID(const TString &name)
+{
+   auto it = std::find(std::begin(fVolumeNames), std::end(fVolumeNames), name);
+   if (it == std::end(fVolumeNames))
+      return kOtherVolume;
+   return std::distance(std::begin(fVolumeNames), it);
+}
+
+TString AtMCPoint::GetVolName(Int_t volID)
+{
+   if (volID < 0 || volID >= static_cast<Int_t>(fVolumeNames.size()))
+      return "";
+   return fVolumeNames[volID];
+}
+
+void AtMCPoint::SetVolName(TString VolName)
+{
+   fVolID = FindVolID(VolName);
+   fVolName = fVolID == kOtherVolume ? std::move(VolName) : "";
+}
+
 AtMCPoint::AtMCPoint(Int_t trackID, Int_t detID, XYZPoint pos, XYZVector mom, Double_t tof, Double_t length,
                      Double_t eLoss)
    : AtMCPoint(trackID, detID, TVector3(pos.X(), pos.Y(), pos.Z()), TVector3(mom.X(), mom.Y(), mom.Z()), 0, length,
@@ -66,6 +103,7 @@ void AtMCPoint::Clear(Option_t *)
 
    // Clear AtMCPoint
    fDetCopyID = 0;
+   fVolID = kOtherVolume;
    fVolName = "";
    fEnergyIni = 0;
    fAngleIni = 0;
@@ -30,13 +30,21 @@ protected:
    using XYZVector = ROOT::Math::XYZVector;
 
    Int_t fDetCopyID = 0;
-   TString fVolName;
+   Int_t fVolID = -1; ///< ID of the volume (see VolumeID)
+   TString fVolName;  ///< Name of the volume, only set if it has no ID
    Double_t fEnergyIni = 0;
    Double_t fAngleIni = 0;
    Int_t fAiso = 0;
    Int_t fZiso = 0;
 
 public:
+   /**
+    * Volumes whose points only store an integer ID instead of the volume name. The IDs are written
+    * to file, so new volumes may only be appended. Points in any other volume have the ID
+    * kOtherVolume and keep their name.
+    */
+   enum VolumeID : Int_t { kOtherVolume = -1, kDriftVolume = 0, kWindow = 1, kCell = 2 };
+
    /** Default constructor **/
    AtMCPoint();
 
@@ -54,6 +62,8 @@ public:
 
    AtMCPoint(Int_t trackID, Int_t detID, TVector3 pos, TVector3 mom, Double_t tof, Double_t length, Double_t eLoss,
              TString VolName, Int_t detCopyID, Double_t EIni, Double_t AIni, Int_t A, Int_t Z);
+   AtMCPoint(Int_t trackID, Int_t detID, TVector3 pos, TVector3 mom, Double_t tof, Double_t length, Double_t eLoss,
+             Int_t volID, Int_t detCopyID, Double_t EIni, Double_t AIni, Int_t A, Int_t Z);
 
    /** Destructor **/
    virtual ~AtMCPoint() = default;
@@ -65,14 +75,20 @@ public:
 
    /** Accessors **/
    Int_t GetDetCopyID() const { return fDetCopyID; } // added by Marc
-   TString GetVolName() const { return fVolName; }
+   Int_t GetVolID() const { return fVolID; }
+   TString GetVolName() const { return fVolID == kOtherVolume ? fVolName : GetVolName(fVolID); }
    Double_t GetEIni() const { return fEnergyIni; }
    Double_t GetAIni() const { return fAngleIni; }
    Int_t GetMassNum() const { return fAiso; }
    Int_t GetAtomicNum() const { return fZiso; }
 
    void SetDetCopyID(Int_t id) { fDetCopyID = id; };         // added by Marc
-   void SetVolName(TString VolName) { fVolName = VolName; }; // added by Ari
+   void SetVolID(Int_t id)
+   {
+      fVolID = id;
+      fVolName = "";
+   }
+   void SetVolName(TString VolName); // added by Ari
    void SetPosition(const XYZPoint &pos) { SetXYZ(pos.X(), pos.Y(), pos.Z()); }
    void SetMomentum(const XYZVector &mom)
    {
@@ -80,11 +96,16 @@ public:
       FairMCPoint::SetMomentum(mom2);
    }
 
+   /// Get the ID of the volume called name, or kOtherVolume if it does not have one.
+   static Int_t FindVolID(const TString &name);
+   /// Get the name of the volume with ID volID, or an empty string for kOtherVolume.
+   static TString GetVolName(Int_t volID);
+
    /** Output to screen **/
    virtual void Print(const Option_t *opt) const override;
 
    friend AtSimpleSimulation;
-   ClassDefOverride(AtMCPoint, 2)
+   ClassDefOverride(AtMCPoint, 3)
 };
 
 #endif
@@ -17,4 +17,7 @@
 #pragma link C++ class AtVertexPropagator + ;
 #pragma link C++ class AtMCPoint + ;
 
+// Version 2 stored the volume name for every point
+#pragma read sourceClass = "AtMCPoint" version = "[-2]" source = "TString fVolName" targetClass = "AtMCPoint" target = "fVolID, fVolName" code = "{ fVolID = AtMCPoint::FindVolID(onfile.fVolName); fVolName = fVolID == AtMCPoint::kOtherVolume ? onfile.fVolName : TString(); }"
+
 #endif
@@ -304,6 +304,18 @@ void AtStack::Register()
 }
 // -------------------------------------------------------------------------
 
+// -----   Public method CloneStack   --------------------------------------
+FairGenericStack *AtStack::CloneStack() const
+{
+   auto *stack = new AtStack(fParticles->GetSize());
+   stack->fStoreSecondaries = fStoreSecondaries;
+   stack->fMinPoints = fMinPoints;
+   stack->fEnergyCut = fEnergyCut;
+   stack->fStoreMothers = fStoreMothers;
+   return stack;
+}
+// -------------------------------------------------------------------------
+
 // -----   Public method Print  --------------------------------------------
 void AtStack::Print(Int_t iVerbose) const
 {
@@ -146,6 +146,9 @@ public:
    /** Register the MCTrack array to the Root Manager  **/
    virtual void Register();
 
+   /** Empty stack with the same settings for a Geant4 worker thread **/
+   virtual FairGenericStack *CloneStack() const override;
+
    /** Output to screen
     **@param iVerbose: 0=events summary, 1=track info
     **/
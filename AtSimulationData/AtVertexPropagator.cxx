@@ -2,9 +2,11 @@
 
 #include <Rtypes.h>
 #include <TRandom.h>
+#include <TRandom3.h>
 #include <TVector3.h>
 
 #include <cmath>
+#include <mutex>
 #include <utility>
 
 // Allow us use std::make_unique using a protected constructor this struct
@@ -12,14 +14,53 @@
 namespace {
 struct concrete_AtVertexPropagator : public AtVertexPropagator {
 };
+
+std::mutex fContextMutex;     // Protects gRandom and fFirstContext while creating contexts
+bool fFirstContext = true;    // The first context created uses gRandom
+thread_local std::unique_ptr<AtVertexPropagator> fThreadInstance = nullptr;
+thread_local AtVertexPropagator *fCurrentInstance = nullptr;
 } // namespace
-std::unique_ptr<AtVertexPropagator> AtVertexPropagator::fInstance = nullptr;
 
 AtVertexPropagator *AtVertexPropagator::Instance()
 {
-   if (fInstance == nullptr)
-      fInstance = std::make_unique<concrete_AtVertexPropagator>();
-   return fInstance.get();
+   if (fCurrentInstance != nullptr)
+      return fCurrentInstance;
+   if (fThreadInstance == nullptr)
+      fThreadInstance = Create();
+   return fThreadInstance.get();
+}
+
+std::unique_ptr<AtVertexPropagator> AtVertexPropagator::Create()
+{
+   std::unique_ptr<AtVertexPropagator> context = std::make_unique<concrete_AtVertexPropagator>();
+
+   std::lock_guard<std::mutex> lk(fContextMutex);
+   if (fFirstContext)
+      fFirstContext = false;
+   else
+      context->fRandom = std::make_unique<TRandom3>(gRandom->Integer(kMaxUInt) + 1);
+   return context;
+}
+
+void AtVertexPropagator::SetInstance(AtVertexPropagator *context)
+{
+   fCurrentInstance = context;
+}
+
+AtVertexPropagator::~AtVertexPropagator() = default;
+
+TRandom *AtVertexPropagator::GetRandom()
+{
+   return fRandom ? fRandom.get() : gRandom;
+}
+
+/// Give this context its own random stream starting from seed.
+void AtVertexPropagator::SetSeed(UInt_t seed)
+{
+   if (fRandom)
+      fRandom->SetSeed(seed);
+   else
+      fRandom = std::make_unique<TRandom3>(seed);
 }
 
 AtVertexPropagator::AtVertexPropagator()
@@ -174,7 +215,7 @@ void AtVertexPropagator::Setd2HeVtx(TVector3 avec)
 void AtVertexPropagator::Setd2HeVtx(Double_t x0, Double_t y0, Double_t Ax, Double_t Ay)
 {
    Double_t vx, vy, vz;
-   vz = 100.0 * (gRandom->Uniform()); // cm
+   vz = 100.0 * (GetRandom()->Uniform()); // cm
    vx = x0 + vz * tan(Ax);
    vy = y0 + sqrt(pow(vz, 2) + pow(vx - x0, 2)) * tan(Ay);
    fd2HeVtx.SetXYZ(vx, vy, vz);
@@ -11,11 +11,21 @@
 class TBuffer;
 class TClass;
 class TMemberInspector;
-
+class TRandom;
+
+/**
+ * Vertex and reaction state shared between the generators and AtTpc while simulating an event.
+ *
+ * Instance() returns the context of the calling thread, so every Geant4 worker (each with its own
+ * clone of the generators and detectors) propagates its own events. A context can also be created
+ * explicitly with Create() and bound to a thread with SetInstance() to run several simulations in
+ * one process. Generators should draw random numbers from GetRandom(): the first context uses
+ * gRandom so sequential runs are unchanged, every other context owns a stream seeded from gRandom.
+ */
 class AtVertexPropagator : public TObject {
 
 private:
-   static std::unique_ptr<AtVertexPropagator> fInstance;
+   std::unique_ptr<TRandom> fRandom; //! Random stream of this context (nullptr uses gRandom)
 
    Int_t fGlobalEvtCnt;
    Int_t fBeamEvtCnt;
@@ -59,9 +69,17 @@ protected:
    AtVertexPropagator();
 
 public:
-   virtual ~AtVertexPropagator() = default;
+   virtual ~AtVertexPropagator();
 
+   /// Context of the calling thread
    static AtVertexPropagator *Instance();
+   /// Create a new context with its own random stream
+   static std::unique_ptr<AtVertexPropagator> Create();
+   /// Use context for the calling thread. nullptr restores the thread's default context.
+   static void SetInstance(AtVertexPropagator *context);
+
+   TRandom *GetRandom();
+   void SetSeed(UInt_t seed);
 
    void SetVertex(Double_t vx, Double_t vy, Double_t vz, Double_t invx, Double_t invy, Double_t invz, Double_t px,
                   Double_t py, Double_t pz, Double_t E);
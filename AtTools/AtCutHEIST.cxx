@@ -1,7 +1,8 @@
 #include "AtCutHEIST.h"
 
+#include "AtEntryListSource.h"
+
 #include <FairLogger.h>
-#include <FairRootManager.h>
 
 #include <TCollection.h> // for TIter
 #include <TCutG.h>
@@ -64,9 +65,23 @@ void AtCutHEIST::AddAllSpecies()
       AddSpecies(key->GetName());
 }
 
+/// Only move the reader if the entry changed so calling operator() and GetSpecies on the same event reads once.
+void AtCutHEIST::LoadEntry(Long64_t entry)
+{
+   if (entry == fLoadedEntry)
+      return;
+   fReader.SetEntry(entry);
+   fLoadedEntry = entry;
+}
+
 bool AtCutHEIST::operator()()
 {
-   fReader.SetEntry(FairRootManager::Instance()->GetEntryNr());
+   return (*this)(AtEntryListSource::GetCurrentTreeEntry());
+}
+
+bool AtCutHEIST::operator()(Long64_t entry)
+{
+   LoadEntry(entry);
    auto energy = GetEnergy();
    auto tof = GetToF();
    LOG(debug) << "Energy: " << energy << " ToF: " << tof;
@@ -84,7 +99,12 @@ bool AtCutHEIST::operator()()
 
 std::string AtCutHEIST::GetSpecies()
 {
-   fReader.SetEntry(FairRootManager::Instance()->GetEntryNr());
+   return GetSpecies(AtEntryListSource::GetCurrentTreeEntry());
+}
+
+std::string AtCutHEIST::GetSpecies(Long64_t entry)
+{
+   LoadEntry(entry);
    auto energy = GetEnergy();
    auto tof = GetToF();
 
@@ -32,7 +32,8 @@ private:
    std::shared_ptr<TFile> fCutFile; //< File all cuts availible
    std::map<std::string, TCutG *> fSpecies;
 
-   TFile *fOutFile{nullptr}; //< File to save cuts in
+   TFile *fOutFile{nullptr};  //< File to save cuts in
+   Long64_t fLoadedEntry{-1}; //< Entry currently loaded in fReader
 
 public:
    AtCutHEIST(TTree *tree, TString cutFile);
@@ -41,12 +42,16 @@ public:
    bool AddSpecies(std::string species);
    void AddAllSpecies();
    std::string GetSpecies();
+   std::string GetSpecies(Long64_t entry);
 
    bool operator()();
+   /// Check the species of an entry directly (e.g. as a selection in AtEntrySelector)
+   bool operator()(Long64_t entry);
 
    void SetSaveCuts(TFile *outFile) { fOutFile = outFile; }
 
 private:
+   void LoadEntry(Long64_t entry);
    double GetEnergy();
    double GetToF();
 };
@@ -12,7 +12,7 @@
 
 #include <AtHit.h>
 
-#include <cmath> // for sqrt
+#include <cmath> // for sqrt, erf
 
 /**
  * Assumes that window is at z = 0, and the electrons are drifting towards the pad plane at
@@ -72,21 +72,66 @@ std::unique_ptr<TF1> AtTools::GetHitFunction(const AtHit &hit, const AtDigiPar *
 }
 
 std::unique_ptr<TF1> AtTools::GetHitFunctionTB(const AtHit &hit, const AtDigiPar *fPar)
+{
+   auto kernel = GetHitKernelTB(hit, fPar);
+   if (!kernel.IsValid())
+      return nullptr;
+
+   // Create the function we are going to set and make sure it isn't added to the global list
+   auto func = std::make_unique<TF1>("hitFuncTB", "gaus", 0, 512, TF1::EAddToList::kNo);
+   func->SetParameter(0, kernel.fAmplitude);
+   func->SetParameter(1, kernel.fMean);
+   func->SetParameter(2, kernel.fSigma);
+
+   return func;
+}
+
+AtTools::HitKernel AtTools::GetHitKernelTB(const AtHit &hit, const AtDigiPar *fPar)
 {
    if (hit.GetPositionSigma().Z() == 0) {
       LOG(error) << "Hits that are points (sig_z = 0) are not supported yet!";
-      return nullptr;
+      return {};
    }
    if (fPar == nullptr)
       fPar = dynamic_cast<const AtDigiPar *>(FairRun::Instance()->GetRuntimeDb()->getContainer("AtDigiPar"));
+   if (fPar == nullptr) {
+      LOG(error) << "Could not find the digipar file!";
+      return {};
+   }
 
-   // Create the function we are going to set and make sure it isn't added to the global list
-   auto func = std::make_unique<TF1>("hitFuncTB", "gaus", 0, 512, TF1::EAddToList::kNo);
+   HitKernel kernel;
+   kernel.fSigma = GetDriftTB(hit.GetPositionSigma().Z(), fPar);
+   kernel.fMean = GetTB(hit.GetPosition().Z(), fPar);
+   kernel.fAmplitude = hit.GetCharge() / (kernel.fSigma * std::sqrt(2 * TMath::Pi()));
+   return kernel;
+}
 
-   auto ampl = hit.GetCharge() / (GetDriftTB(hit.GetPositionSigma().Z(), fPar) * std::sqrt(2 * TMath::Pi()));
-   func->SetParameter(0, ampl);
-   func->SetParameter(1, GetTB(hit.GetPosition().Z(), fPar));
-   func->SetParameter(2, GetDriftTB(hit.GetPositionSigma().Z(), fPar));
+void AtTools::AddHitToTrace(const HitKernel &kernel, double *trace, int size, double scale, double threshold,
+                            bool integrate, double numSigma)
+{
+   if (!kernel.IsValid())
+      return;
+
+   // When integrating, each TB extends half a TB past where it is evaluated
+   auto range = kernel.GetTBRange(0, size, integrate ? numSigma + 0.5 / kernel.fSigma : numSigma);
+   if (!integrate) {
+      for (int tb = range.first; tb < range.second; ++tb) {
+         auto val = kernel.Eval(tb) * scale;
+         if (val > threshold)
+            trace[tb] += val;
+      }
+      return;
+   }
 
-   return func;
+   // Each bin edge is shared by two TBs, so only evaluate erf once per edge.
+   auto norm = 1 / (kernel.fSigma * std::sqrt(2.));
+   auto halfCharge = 0.5 * scale * kernel.GetCharge();
+   auto lowerBound = std::erf((range.first - 0.5 - kernel.fMean) * norm);
+   for (int tb = range.first; tb < range.second; ++tb) {
+      auto upperBound = std::erf((tb + 0.5 - kernel.fMean) * norm);
+      auto val = halfCharge * (upperBound - lowerBound);
+      lowerBound = upperBound;
+      if (val > threshold)
+         trace[tb] += val;
+   }
 }
@@ -1,6 +1,10 @@
 #ifndef ATDATAMANIP_H
 #define ATDATAMANIP_H
+#include <algorithm> // for max, min
+#include <cmath>     // for exp, erf, sqrt, ceil, floor
+#include <limits>    // for numeric_limits
 #include <memory>
+#include <utility>   // for pair
 class TF1;
 class AtHit;
 class AtDigiPar;
@@ -12,6 +16,78 @@ class AtDigiPar;
  */
 namespace AtTools {
 
+/**
+ * @brief Gaussian charge distribution of a hit as a function of TB.
+ *
+ * Same function as the TF1 returned by GetHitFunctionTB, but evaluated in closed form and
+ * without any allocation. A default constructed (or invalid) kernel has fSigma == 0.
+ */
+struct HitKernel {
+   double fAmplitude{0}; //< Height of the gaussian (charge/(sigma*sqrt(2pi)))
+   double fMean{0};      //< TB
+   double fSigma{0};     //< TB
+
+   bool IsValid() const { return fSigma > 0; }
+
+   /// Charge density at tb
+   double Eval(double tb) const
+   {
+      auto x = (tb - fMean) / fSigma;
+      return fAmplitude * std::exp(-0.5 * x * x);
+   }
+
+   /// Total charge of the hit
+   double GetCharge() const { return fAmplitude * fSigma * 2.5066282746310002; } // sqrt(2pi)
+
+   /// Charge between tbLow and tbHigh
+   double Integral(double tbLow, double tbHigh) const
+   {
+      auto norm = 1 / (fSigma * std::sqrt(2.));
+      return 0.5 * GetCharge() * (std::erf((tbHigh - fMean) * norm) - std::erf((tbLow - fMean) * norm));
+   }
+
+   /// TBs [first, last) within numSigma of the mean, clamped to [minTB, maxTB)
+   std::pair<int, int> GetTBRange(int minTB, int maxTB, double numSigma) const
+   {
+      auto first = std::ceil(fMean - numSigma * fSigma);
+      auto last = std::floor(fMean + numSigma * fSigma) + 1;
+      first = std::max<double>(first, minTB);
+      last = std::min<double>(last, maxTB);
+      return {static_cast<int>(first), static_cast<int>(std::max(first, last))};
+   }
+
+   /**
+    * Number of sigma from the mean outside of which Eval(tb) * scale is not above threshold, with
+    * a TB of margin for rounding. Infinite if threshold <= 0 since the kernel is never negative.
+    */
+   double GetNumSigmaAbove(double threshold, double scale = 1) const
+   {
+      if (threshold <= 0)
+         return std::numeric_limits<double>::infinity();
+      if (fAmplitude * scale <= threshold)
+         return 0;
+      return std::sqrt(2 * std::log(fAmplitude * scale / threshold)) + 1 / fSigma;
+   }
+};
+
+/**
+ * @brief Get the charge distribution of a hit as a function of TB.
+ * Returns an invalid kernel if the hit has no z sigma or the parameters could not be found.
+ */
+HitKernel GetHitKernelTB(const AtHit &hit, const AtDigiPar *par = nullptr);
+
+/**
+ * @brief Add the charge of a hit to a trace indexed by TB.
+ *
+ * Only the TBs within numSigma of the mean are touched, and the charge added to each is scaled
+ * by scale and skipped if not above threshold. If integrate is false, the charge added is the
+ * kernel evaluated at the TB (what GetHitFunctionTB()->Eval(tb) gives). If true, it is the
+ * integral over [tb - 0.5, tb + 0.5], so the charge in the trace sums to the charge of the hit.
+ */
+void AddHitToTrace(const HitKernel &kernel, double *trace, int size, double scale = 1,
+                   double threshold = std::numeric_limits<double>::lowest(), bool integrate = false,
+                   double numSigma = 7);
+
 /**
  * @brief Get charge as a function of TB.
  */
@@ -15,7 +15,7 @@
 
 #include <cassert> // for assert
 #include <iostream>
-#include <memory> // for allocator
+#include <memory> // for make_shared
 
 using XYZPoint = ROOT::Math::XYZPoint;
 using XYZVector = ROOT::Math::XYZVector;
@@ -24,6 +24,18 @@ using XYVector = ROOT::Math::XYVector;
 
 AtEDistortionModel::AtEDistortionModel() : AtSpaceChargeModel() {}
 
+/// The clone has its own copy of the correction maps, the lookup tables are not copied.
+std::shared_ptr<AtSpaceChargeModel> AtEDistortionModel::Clone() const
+{
+   auto clone = std::make_shared<AtEDistortionModel>();
+   clone->SetBeamLocation(fWindow, fPadPlane);
+   *clone->fDistortionMap = *fDistortionMap;
+   *clone->fZMap = *fZMap;
+   *clone->fRadMap = *fRadMap;
+   *clone->fTraMap = *fTraMap;
+   return clone;
+}
+
 XYZPoint AtEDistortionModel::CorrectSpaceCharge(const XYZPoint &input)
 {
 
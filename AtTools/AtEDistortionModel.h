@@ -67,6 +67,7 @@ private:
 
 public:
    AtEDistortionModel();
+   virtual std::shared_ptr<AtSpaceChargeModel> Clone() const override;
 
    virtual XYZPoint CorrectSpaceCharge(const XYZPoint &directInputPosition) override;
    virtual XYZPoint ApplySpaceCharge(const XYZPoint &reverseInputPosition) override;
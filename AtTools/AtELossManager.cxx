@@ -7,6 +7,8 @@
 #include <cmath>
 #include <fstream> // IWYU pragma: keep
 #include <iostream>
+#include <iterator>
+#include <sstream>
 
 ClassImp(AtTools::AtELossManager);
 
@@ -20,8 +22,7 @@ AtTools::AtELossManager::AtELossManager(std::string Eloss_file, Double_t Mass)
    Double_t _IonEnergy = 0;
    Double_t _dEdx_e = 0, _dEdx_n = 0;
    Double_t _Range = 0;
-   Double_t _Stragg_lon = 0, _Stragg_lat = 0;
-   std::string aux;
+   std::string line;
 
    std::ifstream Read(Eloss_file.c_str());
 
@@ -32,34 +33,32 @@ AtTools::AtELossManager::AtELossManager(std::string Eloss_file, Double_t Mass)
       GoodELossFile = false;
    } else {
       GoodELossFile = true;
-      Read >> aux >> aux >> aux >> aux >> aux >> aux; // The first line has 6 strings (columns' description).
-      points = 0;
+      std::getline(Read, line); // The first line has the columns' description.
 
-      do {
-         Read >> _IonEnergy >> _dEdx_e >> _dEdx_n >> _Range >> _Stragg_lon >> _Stragg_lat;
-         points++;
-
-      } while (!Read.eof());
-
-      Read.close();
-
-      // Go to the begining of the file and read it again to now save the info in the newly created arrays.
-      Read.open(Eloss_file.c_str());
-      Read >> aux >> aux >> aux >> aux;
-
-      for (int p = 0; p < points; p++) {
-         Read >> _IonEnergy >> _dEdx_e >> _dEdx_n >> _Range;
+      // Each line is the energy, electronic and nuclear stopping power, and range. Any other columns are ignored.
+      while (std::getline(Read, line)) {
+         std::istringstream lineStream(line);
+         if (!(lineStream >> _IonEnergy >> _dEdx_e >> _dEdx_n >> _Range))
+            continue;
 
          IonEnergy.push_back(_IonEnergy);
          dEdx_e.push_back(_dEdx_e);
          dEdx_n.push_back(_dEdx_n);
          Range.push_back(_Range);
       }
+      Read.close();
+
+      // Only keep the part of the table where the energy is strictly increasing so it can be searched
+      points = IonEnergy.empty() ? 0 : 1;
+      while (points < IonEnergy.size() && IonEnergy[points] > IonEnergy[points - 1])
+         points++;
 
       Energy_in_range = true;
       IonMass = Mass; // In MeV/c^2
       c = 29.9792458; // Speed of light in cm/ns.
       EvD = std::make_shared<TGraph>();
+
+      BuildRangeTables();
    }
 }
 
@@ -70,18 +69,11 @@ Double_t AtTools::AtELossManager::GetEnergyLossLinear(Double_t energy, Double_t
 
    int i = -1;
    if (energy >= 0.01) {
-      // Look for two points for which the initial energy lays in between.  This for-loop should find the points
-      // unless there was a big jump from the energy used in the last point and the energy used now.
-
-      for (int p = 0; p < points - 1; p++) {
-
-         if (energy >= IonEnergy[p] && energy < IonEnergy[p + 1]) {
-
-            i = p + 1;
-            last_point = p;
-
-            break;
-         }
+      // Look for two points for which the initial energy lays in between.
+      auto p = FindEnergyBin(energy);
+      if (p != -1) {
+         i = p + 1;
+         last_point = p;
       }
 
       // If after this two loop i is still -1 it means the energy was out of range.
@@ -121,45 +113,51 @@ Double_t AtTools::AtELossManager::GetEnergyLossLinear(Double_t energy, Double_t
 /////////////////////////////////// SPLINE INTERPOLATION ////////////////////////////////////////////
 double AtTools::AtELossManager::GetEnergyLoss(double energy /*MeV*/, double distance /*cm*/)
 {
-   Float_t a11 = 0.0, a12 = 0.0, a21 = 0.0, a22 = 0.0, a23 = 0.0, a32 = 0.0, a33 = 0.0;
-   Float_t b11 = 0.0, b22 = 0.0, b33 = 0.0;
-   Float_t a1 = 0.0, a2 = 0.0, b1 = 0.0, b2 = 0.0;
-   Float_t K0 = 0.0, K1 = 0.0, K2 = 0.0;
-   Float_t N1 = 0.0, N2 = 0.0, N3 = 0.0;
-   Float_t T1 = 0.0, T2 = 0.0, q1 = 0.0, q2 = 0.0;
-
-   int i = -1;
    if (energy < 0.01)
       return (0);
 
-   // if(energy < 0.01){
-   // break;
-   // }
-
    // Look for two points for which the initial energy lies in between.
-   // This for-loop should find the points
-   // unless there was a big jump from the energy used in the
-   // last point and the energy used now.
+   // The spline also needs the point after the upper one.
+   auto p = FindEnergyBin(energy);
+   if (p == -1 || p + 2 >= points) {
 
-   for (int p = 0; p < points - 1; p++) {
+      std::cout << "*** EnergyLoss Error: energy not within range: " << energy << "\n";
 
-      if (energy >= IonEnergy[p] && energy < IonEnergy[p + 1]) {
+      Energy_in_range = false;
+      return 0;
+   }
+   last_point = p;
 
-         i = p + 1;
-         last_point = p;
+   return (GetStoppingPower(p, energy) * 10 * distance);
+}
 
-         break;
-      }
-   }
-   // If after this two loop i is still -1 it means the energy was out of range.
+/**
+ * Returns the index p such that IonEnergy[p] <= energy < IonEnergy[p+1] using a binary search,
+ * or -1 if the energy is not in the table.
+ */
+Int_t AtTools::AtELossManager::FindEnergyBin(Double_t energy) const
+{
+   if (points < 2 || energy < IonEnergy[0] || energy >= IonEnergy[points - 1])
+      return -1;
 
-   if (i == -1) {
+   auto it = std::upper_bound(IonEnergy.begin(), IonEnergy.begin() + points, energy);
+   return std::distance(IonEnergy.begin(), it) - 1;
+}
 
-      std::cout << "*** EnergyLoss Error: energy not within range: " << energy << "\n";
+/**
+ * Total stopping power (electric + nuclear) in MeV/mm at the passed energy, using the spline through
+ * the points p, p+1 and p+2 of the table. Requires IonEnergy[p] <= energy <= IonEnergy[p+1].
+ */
+Double_t AtTools::AtELossManager::GetStoppingPower(Int_t p, Double_t energy) const
+{
+   Float_t a11 = 0.0, a12 = 0.0, a21 = 0.0, a22 = 0.0, a23 = 0.0, a32 = 0.0, a33 = 0.0;
+   Float_t b11 = 0.0, b22 = 0.0, b33 = 0.0;
+   Float_t a1 = 0.0, b1 = 0.0;
+   Float_t K0 = 0.0, K1 = 0.0;
+   Float_t N1 = 0.0, N2 = 0.0, N3 = 0.0;
+   Float_t T1 = 0.0, q1 = 0.0;
 
-      Energy_in_range = false;
-      return 0;
-   }
+   int i = p + 1;
 
    // Ion Energy
    Float_t x0 = IonEnergy[i - 1];
@@ -187,194 +185,200 @@ double AtTools::AtELossManager::GetEnergyLoss(double energy /*MeV*/, double dist
    N1 = (a21 * a33 * a12 - a11 * (a22 * a33 - a23 * a32)) / (a33 * a12);
    N2 = (b22 * a33 - a23 * b33) / a33;
    N3 = b11 * (a22 * a33 - a23 * a32) / (a33 * a12);
-   // cout<<"N1="<<N1<<" N2="<<N2<<" N3="<<N3<<endl;
 
    // curvatures
    K0 = (N2 - N3) / N1;
    K1 = (b11 - a11 * K0) / a12;
-   // K2 = (b33 - a32 * K1) / a33;
-   //  cout<<"K0="<<K0<<" K1="<<K1<<" K2="<<K2<<endl;
 
    a1 = K0 * (x1 - x0) - (y1 - y0);
    b1 = -K1 * (x1 - x0) + (y1 - y0);
-   // a2 = K1 * (x2 - x1) - (y2 - y1);
-   // b2 = -K2 * (x2 - x1) + (y2 - y1);
-   //  cout<<"a1="<<a1<<" b1="<<b1<<" a2="<<a2<<" b2="<<b2<<endl;
 
    T1 = (energy - x0) / (x1 - x0);
-   // T2 = (energy - x1) / (x2 - x1);
 
    // polynomials //which gives the value of energy loss for given energy.
    q1 = (1 - T1) * y0 + T1 * y1 + T1 * (1 - T1) * (a1 * (1 - T1) + b1 * T1);
-   // q2 = (1 - T2) * y1 + T2 * y2 + T2 * (1 - T2) * (a2 * (1 - T2) + b2 * T2);
 
-   // cout<<"q1="<<q1<<" q2="<<q2<<endl;
-
-   return (q1 * 10 * distance);
+   return q1;
 }
 
-//////////////////////////////////////////////////////////////////////////////////////////////////////////////
-Double_t AtTools::AtELossManager::GetInitialEnergy(Double_t FinalEnergy /*MeV*/, Double_t PathLength /*cm*/ /*dist*/,
-                                                   Double_t StepSize /*cm*/)
+/**
+ * Build the tables of the range and time of flight (integrated from the lowest energy in the table)
+ * as a function of energy. Every query of the range or energy after a distance is then a binary
+ * search and a linear interpolation in these tables.
+ */
+void AtTools::AtELossManager::BuildRangeTables()
 {
-   Double_t Energy = FinalEnergy;
-   int Steps = (int)floor(PathLength / StepSize);
-   last_point = 0;
-
-   // The function starts by assuming FinalEnergy is within the energy range,
-   // but this could be changed in the GetEnergyLoss() function.
-
-   Energy_in_range = true;
-
-   for (int s = 0; s < Steps; s++) {
+   fTabEnergy.clear();
+   fTabRange.clear();
+   fTabTime.clear();
+
+   // Spline is valid between IonEnergy[0] and IonEnergy[points-2]
+   if (points < 3)
+      return;
+
+   Double_t eMin = std::max(0.01, IonEnergy[0]);
+   Int_t pMin = FindEnergyBin(eMin);
+   if (pMin == -1 || pMin + 2 >= points)
+      return;
+
+   // Inverse stopping power (cm/MeV) and inverse of the velocity (ns/cm)
+   auto invStopping = [this](Int_t p, Double_t E) { return 1.0 / (GetStoppingPower(p, E) * 10); };
+   auto invVelocity = [this](Double_t E) { return IonMass > 0 ? 1.0 / (c * std::sqrt(2 * E / IonMass)) : 0; };
+
+   Double_t lastE = eMin;
+   Double_t lastInvS = invStopping(pMin, eMin);
+   Double_t lastInvV = invVelocity(eMin);
+   fTabEnergy.push_back(eMin);
+   fTabRange.push_back(0);
+   fTabTime.push_back(0);
+
+   for (Int_t p = pMin; p + 2 < points; ++p) {
+      Double_t eLow = std::max(eMin, IonEnergy[p]);
+      Double_t eHigh = IonEnergy[p + 1];
+
+      for (int k = 1; k <= fNumSubSteps; ++k) {
+         Double_t E = eLow + (eHigh - eLow) * k / fNumSubSteps;
+         Double_t invS = invStopping(p, E);
+         Double_t invV = invVelocity(E);
+         if (!(invS > 0) || !std::isfinite(invS)) {
+            std::cout << "*** EnergyLoss Error: non-positive stopping power at " << E
+                      << " MeV, truncating range table."
+                      << "\n";
+            return;
+         }
 
-      Energy = Energy + GetEnergyLoss(Energy, PathLength / Steps);
+         // Trapezoidal integration of dx = dE/S and dt = dE/(S*v)
+         fTabRange.push_back(fTabRange.back() + 0.5 * (invS + lastInvS) * (E - lastE));
+         fTabTime.push_back(fTabTime.back() + 0.5 * (invS * invV + lastInvS * lastInvV) * (E - lastE));
+         fTabEnergy.push_back(E);
 
-      if (!Energy_in_range) {
-         break;
+         lastE = E;
+         lastInvS = invS;
+         lastInvV = invV;
       }
    }
-   Energy = Energy + GetEnergyLoss(Energy, PathLength - Steps * StepSize);
+}
 
-   if (!Energy_in_range)
-      Energy = -1000; // Return an unrealistic value.
+/// Linear interpolation of y(x) where x is sorted, using a binary search.
+Double_t AtTools::AtELossManager::Interpolate(const std::vector<Double_t> &x, const std::vector<Double_t> &y,
+                                              Double_t val)
+{
+   if (x.empty())
+      return 0;
+   if (val <= x.front())
+      return y.front();
+   if (val >= x.back())
+      return y.back();
+
+   auto it = std::upper_bound(x.begin(), x.end(), val);
+   auto i = std::distance(x.begin(), it);
+   return y[i - 1] + (val - x[i - 1]) * (y[i] - y[i - 1]) / (x[i] - x[i - 1]);
+}
 
-   return Energy;
+/// Range (cm) of an ion with the passed energy, 0 if below the table.
+Double_t AtTools::AtELossManager::GetRangeFromTable(Double_t energy) const
+{
+   return Interpolate(fTabEnergy, fTabRange, energy);
 }
 
-///////////////////////////////////////////////////////////////////////////////////////////////////////////////
-Double_t AtTools::AtELossManager::GetFinalEnergy(Double_t InitialEnergy /*MeV*/, Double_t PathLength /*cm*/,
-                                                 Double_t StepSize /*cm*/)
+/// Energy (MeV) of an ion with the passed range (cm).
+Double_t AtTools::AtELossManager::GetEnergyFromTable(Double_t range) const
 {
+   return Interpolate(fTabRange, fTabEnergy, range);
+}
 
-   Double_t Energy = InitialEnergy;
-   int Steps = (int)floor(PathLength / StepSize);
+/// Time (ns) taken by an ion with the passed energy to stop.
+Double_t AtTools::AtELossManager::GetTimeFromTable(Double_t energy) const
+{
+   return Interpolate(fTabEnergy, fTabTime, energy);
+}
 
-   // The function starts by assuming InitialEnergy is within the energy range, but
-   // this could be changes in the GetEnergyLoss() function.
+/// If the energy is above the range tables.
+bool AtTools::AtELossManager::IsAboveTable(Double_t energy) const
+{
+   return fTabEnergy.empty() || energy > fTabEnergy.back();
+}
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// The step size is no longer used, the energy is found from the range table.
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+Double_t AtTools::AtELossManager::GetInitialEnergy(Double_t FinalEnergy /*MeV*/, Double_t PathLength /*cm*/ /*dist*/,
+                                                   Double_t StepSize /*cm*/)
+{
+   // The function starts by assuming FinalEnergy is within the energy range.
    Energy_in_range = true;
 
-   for (int s = 0; s < Steps; s++) {
+   Double_t range = GetRangeFromTable(FinalEnergy) + PathLength;
+   if (IsAboveTable(FinalEnergy) || range > fTabRange.back()) {
+      Energy_in_range = false;
+      return -1000; // Return an unrealistic value.
+   }
 
-      Energy = Energy - GetEnergyLoss(Energy, PathLength / Steps);
+   return GetEnergyFromTable(range);
+}
 
-      if (!Energy_in_range) {
-         break;
-      }
-      // cout<<"1: ="<<Energy<< "  "<<s*StepSize<<endl;
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// The step size is no longer used, the energy is found from the range table.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+Double_t AtTools::AtELossManager::GetFinalEnergy(Double_t InitialEnergy /*MeV*/, Double_t PathLength /*cm*/,
+                                                 Double_t StepSize /*cm*/)
+{
+   // The function starts by assuming InitialEnergy is within the energy range.
+   Energy_in_range = true;
+
+   if (IsAboveTable(InitialEnergy)) {
+      Energy_in_range = false;
+      return -1000;
    }
 
-   Energy = Energy - GetEnergyLoss(Energy, PathLength - Steps * StepSize);
+   // No energy loss below the table
+   if (InitialEnergy < fTabEnergy.front())
+      return InitialEnergy;
 
-   if (!Energy_in_range) {
-      Energy = -1000;
-   }
+   Double_t range = GetRangeFromTable(InitialEnergy) - PathLength;
+   if (range <= 0)
+      return 0; // The ion stopped
 
-   //  if (PathLength == 6.0){
-   //  cout << " Get Final Energy :"<< InitialEnergy << " " << PathLength << " " << Energy << endl;
-   //}
-   return Energy;
+   return GetEnergyFromTable(range);
 }
 
 Double_t AtTools::AtELossManager::GetDistance(Double_t InitialE, Double_t FinalE, Double_t StepSize)
 {
-
-   Double_t dist = 0;
-   Double_t E = 0, Elast = 0;
-   // Double_t  Tolerance = 0.01;
-
-   E = InitialE;
-
-   while (E > FinalE) {
-      dist += StepSize;
-      Elast = E;
-      E = E - GetEnergyLoss(E, StepSize);
-   }
-
-   return ((dist - StepSize) - (StepSize * (Elast - FinalE) / (E - Elast)));
+   return GetRangeFromTable(InitialE) - GetRangeFromTable(FinalE);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
 // Calulates the ion's path length in cm.
+// This is the distance travelled while slowing from the initial to final energy, so the
+// time step is no longer used.
 ////////////////////////////////////////////////////////////////////////////////////////
 Double_t AtTools::AtELossManager::GetPathLength(Float_t InitialEnergy /*MeV*/, Float_t FinalEnergy /*MeV*/,
                                                 Float_t DeltaT /*ns*/)
 {
-   Double_t L = 0, DeltaX = 0;
-   Double_t Kn = InitialEnergy;
-   Double_t Kn1 = InitialEnergy;
-   Int_t n = 0;
-
-   if (IonMass == 0)
+   if (IonMass == 0) {
       std::cout << "*** EnergyLoss Error: Path length cannot be calculated for IonMass = 0."
                 << "\n";
-   else {
-
-      // The path length (L) is proportional to sqrt(Kn).
-      // After the sum, L will be multiplied by the proportionality factor.
-
-      while (Kn > FinalEnergy && Kn1 > FinalEnergy && n < (int)pow(10.0, 6)) {
-
-         // L += sqrt(Kn); // 2016-06-15 changed
-         L += sqrt((Kn + Kn1) / 2) * sqrt(2 / IonMass) * DeltaT * c; // DeltaL going from point n to n+1.
-         // cout<<"1 = "<<Kn<<"  "<<Kn1<<endl;
-
-         ////DeltaX = sqrt(2*Kn/IonMass)*DeltaT*c; // dx = v*dt// 2016-06-15 changed
-         DeltaX = sqrt((Kn + Kn1) / IonMass) * DeltaT * c;
-
-         Kn1 = Kn;
-         // Kn -= GetEnergyLoss(Kn,DeltaX); // 2016-06-15 changed
-         Kn -= GetEnergyLoss((Kn + Kn1) / 2, DeltaX); // After L is incremented the kinetic energy at n+1 is calculated.
-         // cout<<"2 = "<<Kn<<"  "<<Kn1<<endl;
-         // outfile4 << Kn << "\t" << L << endl;
-         n++;
-      }
-      if (n >= (int)pow(10.0, 6)) {
-         std::cout << "*** EnergyLoss Warning: Full path length wasn't reached after 10^6 iterations."
-                   << "\n";
-         L = 0;
-      } else
-         // L *= sqrt(2/IonMass)*DeltaT*c;
-         L *= 1.0;
+      return 0;
    }
-   return L;
+   if (InitialEnergy <= FinalEnergy)
+      return 0;
+
+   return GetRangeFromTable(InitialEnergy) - GetRangeFromTable(FinalEnergy);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
 Double_t AtTools::AtELossManager::LoadRange(Float_t energy1)
 {
-   Int_t i = -1;
-   Double_t Range1 = 0;
-
    if (energy1 >= 0.01) { // greater than= 10 keV
 
-      for (Int_t p = last_point1 - 1; p < points1 - 1; p++) {
-         if (last_point1 >= 0)
-            if (energy1 >= IonEnergy[p] && energy1 < IonEnergy[p + 1]) {
-               i = p + 1;
-               last_point1 = p;
-               break;
-            }
-      }
-
-      if (i == -1) {
-         for (Int_t p = 0; p < last_point1 - 1; p++) {
-            if (energy1 >= IonEnergy[p] && energy1 < IonEnergy[p + 1]) {
-               i = p + 1;
-               last_point1 = p;
-               break;
-            }
-         }
-      }
-
-      if (i == -1) {
+      auto p = FindEnergyBin(energy1);
+      if (p == -1) {
          std::cout << "*** EnergyLoss Error: energy not within range: " << energy1 << "\n";
          Energy_in_range = false;
          return 0;
       }
-      Range1 = Range[i];
-      return Range1;
+      last_point1 = p;
+      return Range[p + 1];
    }
    return (0);
 }
@@ -385,31 +389,24 @@ Double_t AtTools::AtELossManager::LoadRange(Float_t energy1)
 
 Double_t AtTools::AtELossManager::GetTimeOfFlight(Double_t InitialEnergy, Double_t PathLength, Double_t StepSize)
 {
-   Double_t TOF = 0;
-   Double_t Kn = InitialEnergy;
-   int Steps = (int)(PathLength / StepSize);
-
    if (IonMass == 0) {
       std::cout << "Error: Time of flight cannot be calculated because mass is zero."
                 << "\n";
+      return (0);
    }
 
-   else {
-
-      for (int n = 0; n < Steps; n++) {
+   auto finalEnergy = GetFinalEnergy(InitialEnergy, PathLength, StepSize);
+   if (!Energy_in_range)
+      return 0;
 
-         TOF += sqrt(IonMass / (2 * Kn)) * StepSize / c; // DeltaT going from point n to n+1.
-         Kn -= GetEnergyLoss(Kn, StepSize);              // After the TOF is added the K.E. at point n+1 is calc.}
-      }
-      return TOF;
-   }
-   return (0);
+   return GetTimeFromTable(InitialEnergy) - GetTimeFromTable(finalEnergy);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////
 void AtTools::AtELossManager::SetIonMass(Double_t Mass)
 {
    IonMass = Mass;
+   BuildRangeTables(); // Time of flight depends on the mass
 }
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Lookup Table Extension
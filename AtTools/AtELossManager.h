@@ -21,6 +21,14 @@ class TMemberInspector;
 
 namespace AtTools {
 
+/**
+ * Energy loss of an ion using a stopping power table.
+ *
+ * On construction, the stopping power is integrated into tables of the range and time of flight as a
+ * function of energy. Queries of the final/initial energy after some distance, the distance between
+ * two energies, and the time of flight are then binary searches in these tables instead of stepping
+ * through the path.
+ */
 class AtELossManager : public TObject {
 
 public:
@@ -30,18 +38,51 @@ public:
 
    Double_t GetEnergyLossLinear(Double_t energy, Double_t distance);
    Double_t GetEnergyLoss(Double_t energy, Double_t distance);
+   /**
+    * Get the energy (MeV) an ion had PathLength (cm) before reaching FinalEnergy (MeV).
+    * Returns -1000 if that energy is above the table. StepSize is ignored, it is only kept for
+    * compatibility with the old stepping integration.
+    */
    Double_t GetInitialEnergy(Double_t FinalEnergy, Double_t PathLength, Double_t StepSize);
+   /**
+    * Get the energy (MeV) of an ion after travelling PathLength (cm) from InitialEnergy (MeV).
+    * Returns -1000 if InitialEnergy is above the table. StepSize is ignored, it is only kept for
+    * compatibility with the old stepping integration.
+    *
+    * @note If the ion stops before PathLength this returns 0. The old stepping integration instead
+    * returned what was left after the last step (which could be negative), or -1000 if a step ended
+    * below the bottom of the table.
+    */
    Double_t GetFinalEnergy(Double_t InitialEnergy, Double_t PathLength, Double_t StepSize);
+   /// Get the distance (cm) for an ion to slow from InitialE to FinalE (MeV). StepSize is ignored.
    Double_t GetDistance(Double_t InitialE, Double_t FinalE, Double_t StepSize);
+   /// Get the distance (cm) for an ion to slow from InitialEnergy to FinalEnergy (MeV). DeltaT is ignored.
    Double_t GetPathLength(Float_t InitialEnergy, Float_t FinalEnergy, Float_t DeltaT);
    Double_t LoadRange(Float_t energy1);
+   /**
+    * Get the time (ns) for an ion to travel PathLength (cm) from InitialEnergy (MeV). Returns 0 if
+    * InitialEnergy is above the table. StepSize is ignored.
+    */
    Double_t GetTimeOfFlight(Double_t InitialEnergy, Double_t PathLength, Double_t StepSize);
    void SetIonMass(Double_t IonMass);
    void InitializeLookupTables(Double_t MaximumEnergy, Double_t MaximumDistance, Double_t DeltaE, Double_t DeltaD);
    void PrintLookupTables();
    Double_t GetLookupEnergy(Double_t InitialEnergy, Double_t distance);
 
+   /// Get the range (cm) of an ion with the passed energy (MeV) from the range table.
+   Double_t GetRangeFromTable(Double_t energy) const;
+   /// Get the energy (MeV) of an ion with the passed range (cm) from the range table.
+   Double_t GetEnergyFromTable(Double_t range) const;
+   /// Get the time (ns) for an ion with the passed energy (MeV) to stop from the range table.
+   Double_t GetTimeFromTable(Double_t energy) const;
+
 private:
+   Int_t FindEnergyBin(Double_t energy) const;
+   Double_t GetStoppingPower(Int_t p, Double_t energy) const;
+   void BuildRangeTables();
+   bool IsAboveTable(Double_t energy) const;
+   static Double_t Interpolate(const std::vector<Double_t> &x, const std::vector<Double_t> &y, Double_t val);
+
    std::shared_ptr<TGraph> EvD;
 
    Double_t c{29.9792458};
@@ -60,6 +101,12 @@ private:
    std::vector<Double_t> EtoDtab;
    std::vector<Double_t> DtoEtab;
 
+   // Range tables built from the stopping power, sorted by energy
+   static constexpr int fNumSubSteps = 20; //< Integration steps between each point in the stopping power table
+   std::vector<Double_t> fTabEnergy;       //< Energy (MeV)
+   std::vector<Double_t> fTabRange;        //< Distance to slow to the lowest energy in the table (cm)
+   std::vector<Double_t> fTabTime;         //< Time to slow to the lowest energy in the table (ns)
+
    Int_t points{0};
    Int_t last_point{0};
    Int_t points1{0};
@@ -67,7 +114,7 @@ private:
    Bool_t Energy_in_range{true};
    Bool_t GoodELossFile{false};
 
-   ClassDef(AtELossManager, 1)
+   ClassDef(AtELossManager, 2)
 };
 } // namespace AtTools
 
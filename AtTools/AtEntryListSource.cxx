@@ -0,0 +1,73 @@
+#include "AtEntryListSource.h"
+
+#include <FairLogger.h>
+#include <FairRootManager.h>
+
+#include <TEntryList.h>
+#include <TFile.h>
+
+#include <memory> // for unique_ptr
+
+ClassImp(AtEntryListSource);
+
+AtEntryListSource::AtEntryListSource(TString inputFile, TString entryListFile, TString entryListName)
+   : FairFileSource(inputFile), fEntryListFile(entryListFile), fEntryListName(entryListName)
+{
+}
+
+AtEntryListSource::~AtEntryListSource()
+{
+   delete fEntryList;
+}
+
+Bool_t AtEntryListSource::Init()
+{
+   std::unique_ptr<TFile> file(TFile::Open(fEntryListFile));
+   if (file == nullptr || file->IsZombie()) {
+      LOG(fatal) << "Cannot open entry list file " << fEntryListFile;
+      return false;
+   }
+
+   auto list = dynamic_cast<TEntryList *>(file->Get(fEntryListName));
+   if (list == nullptr) {
+      LOG(fatal) << "Cannot find TEntryList " << fEntryListName << " in " << fEntryListFile;
+      return false;
+   }
+   fEntryList = dynamic_cast<TEntryList *>(list->Clone());
+   fEntryList->SetDirectory(nullptr);
+   LOG(info) << "Reading " << fEntryList->GetN() << " selected entries from " << fEntryListFile;
+
+   return FairFileSource::Init();
+}
+
+Long64_t AtEntryListSource::GetTreeEntry(UInt_t i) const
+{
+   if (fEntryList == nullptr || i >= fEntryList->GetN())
+      return -1;
+   return fEntryList->GetEntry(i);
+}
+
+Long64_t AtEntryListSource::GetCurrentTreeEntry()
+{
+   auto ioMan = FairRootManager::Instance();
+   auto source = dynamic_cast<AtEntryListSource *>(ioMan->GetSource());
+   if (source == nullptr)
+      return ioMan->GetEntryNr();
+   return source->GetTreeEntry(ioMan->GetEntryNr());
+}
+
+Int_t AtEntryListSource::ReadEvent(UInt_t i)
+{
+   auto entry = GetTreeEntry(i);
+   if (entry < 0) {
+      LOG(error) << "Event " << i << " is not in the entry list!";
+      return 1;
+   }
+   return FairFileSource::ReadEvent(entry);
+}
+
+Int_t AtEntryListSource::CheckMaxEventNo(Int_t EvtEnd)
+{
+   // Like FairFileSource, the maximum is the number of events availible
+   return fEntryList ? fEntryList->GetN() : 0;
+}
@@ -0,0 +1,45 @@
+#ifndef ATENTRYLISTSOURCE_H
+#define ATENTRYLISTSOURCE_H
+
+#include <FairFileSource.h>
+
+#include <Rtypes.h>
+#include <TString.h>
+
+class TEntryList;
+class TBuffer;
+class TClass;
+class TMemberInspector;
+
+/**
+ * FairFileSource that only reads the entries in a TEntryList (usually created with AtEntrySelector).
+ * Event i of the run is entry fEntryList->GetEntry(i) of the input tree, so none of the branches of
+ * rejected entries are read. FairRootManager::GetEntryNr() returns the index in the list, use
+ * GetCurrentTreeEntry() to get the entry number in the input tree.
+ */
+class AtEntryListSource : public FairFileSource {
+private:
+   TString fEntryListFile;
+   TString fEntryListName;
+   TEntryList *fEntryList{nullptr}; //!
+
+public:
+   AtEntryListSource(TString inputFile, TString entryListFile, TString entryListName = "AtSelectedEntries");
+   ~AtEntryListSource();
+
+   Bool_t Init() override;
+   Int_t ReadEvent(UInt_t i = 0) override;
+   Int_t CheckMaxEventNo(Int_t EvtEnd = 0) override;
+
+   Long64_t GetTreeEntry(UInt_t i) const;
+
+   /**
+    * Entry of the input tree of the event being processed. This is FairRootManager::GetEntryNr()
+    * unless the source of the run is an AtEntryListSource.
+    */
+   static Long64_t GetCurrentTreeEntry();
+
+   ClassDefOverride(AtEntryListSource, 1);
+};
+
+#endif //#ifndef ATENTRYLISTSOURCE_H
@@ -10,36 +10,64 @@ Move this to Fitter folder, the vertex determination will go with the fitter
 
 #include <FairLogger.h>
 
+#include <Math/CholeskyDecomp.h>
+#include <Math/SMatrix.h>
+#include <Math/SVector.h>
 #include <Math/Vector3D.h> // for DisplacemenXYZVectorD
+#include <TMath.h>         // for RadToDeg
+
+#include <algorithm> // for sort, min, max, equal_range
+#include <array>
+#include <cmath>   // for sqrt, floor, abs, isfinite
+#include <limits>  // for numeric_limits
+#include <numeric> // for iota
+#include <utility> // for pair
+
+namespace {
+constexpr double cMaxVertexRadius = 30; // mm, from the beam
+constexpr double cMinVertexZ = 0;       // mm
+constexpr double cMaxVertexZ = 1000;    // mm
+constexpr double cParallelAngle = 10;   // deg, lines closer to parallel are matched through the beam
+
+bool isParallel(double angle)
+{
+   return angle < cParallelAngle || angle > 180 - cParallelAngle;
+}
 
-#include <algorithm>
-#include <cmath>    // for sqrt
-#include <iostream> // for operator<<, basic_ostream::operator<<
-#include <iterator> // for back_insert_iterator, back_inserter
-#include <memory>   // for shared_ptr, __shared_ptr_access, __sha...
-#include <utility>  // for pair
+/// Line of a track (if it is an AtPatternLine), with the weight of the track in the vertex fit
+bool getLine(const AtTrack &track, AtFindVertex::Line &line, Double_t &weight)
+{
+   auto ransacLine = dynamic_cast<const AtPatterns::AtPatternLine *>(track.GetPattern());
+   if (ransacLine == nullptr)
+      return false;
+   auto patternPar = ransacLine->GetPatternPar();
+   if (patternPar.size() < 6)
+      return false;
+   line.point.SetXYZ(patternPar[0], patternPar[1], patternPar[2]);
+   line.dir.SetXYZ(patternPar[3], patternPar[4], patternPar[5]);
+   weight = ransacLine->GetChi2() > 0 ? 1. / ransacLine->GetChi2() : 1.; // weights for CoG (ex: Chi2, chargeTot...)
+   return true;
+}
 
-constexpr auto cRED = "\033[1;31m";
-constexpr auto cYELLOW = "\033[1;33m";
-constexpr auto cNORMAL = "\033[0m";
-constexpr auto cGREEN = "\033[1;32m";
+/// Disjoint sets of pairs, for clustering their points of closest approach
+int findRoot(std::vector<int> &parent, int i)
+{
+   while (parent[i] != i) {
+      parent[i] = parent[parent[i]];
+      i = parent[i];
+   }
+   return i;
+}
+} // namespace
 
 AtFindVertex::AtFindVertex(Double_t lineDistThreshold) : fLineDistThreshold(lineDistThreshold), fTracksFromVertex(0)
 {
-   fBeamPoint.SetXYZ(0, 0, 500);
-   fBeamDir.SetXYZ(0, 0, 1);
-   fBeamLine.resize(6);
-   fBeamLine[0] = fBeamPoint.X();
-   fBeamLine[1] = fBeamPoint.Y();
-   fBeamLine[2] = fBeamPoint.Z();
-   fBeamLine[3] = fBeamDir.X();
-   fBeamLine[4] = fBeamDir.Y();
-   fBeamLine[5] = fBeamDir.Z();
+   SetBeam({0, 0, 500}, {0, 0, 1});
 }
 
 AtFindVertex::~AtFindVertex() = default;
 
-void AtFindVertex::FindVertex(std::vector<AtTrack> tracks, Int_t nbTracksPerVtx)
+void AtFindVertex::FindVertex(const std::vector<AtTrack> &tracks, Int_t nbTracksPerVtx)
 {
    if (tracks.size() < nbTracksPerVtx)
       return;
@@ -49,324 +77,308 @@ void AtFindVertex::FindVertex(std::vector<AtTrack> tracks, Int_t nbTracksPerVtx)
    }
 }
 
-void AtFindVertex::FindVertexSingleLine(std::vector<AtTrack> tracks)
+void AtFindVertex::FindVertexSingleLine(const std::vector<AtTrack> &tracks)
 {
-   std::vector<std::vector<Double_t>> lines;
-   std::vector<Int_t> itracks;
-   Int_t it = -1;
-   for (auto track : tracks) {
-      it++;
-      auto ransacLine = dynamic_cast<const AtPatterns::AtPatternLine *>(track.GetPattern());
-      std::vector<Double_t> patternPar;
-      patternPar = ransacLine->GetPatternPar();
-      if (patternPar.size() == 0)
+   for (const auto &track : tracks) {
+      Line line;
+      Double_t weight = 0;
+      if (!getLine(track, line, weight) || distLines(line, fBeamLine) >= fLineDistThreshold)
          continue;
-      lines.push_back(patternPar);
-      itracks.push_back(it);
-   }
-   std::vector<std::pair<Int_t, XYZVector>> cogVtx;
-   cogVtx = CoGVtxSingleTrack(lines, itracks);
-   // for(Int_t i =0; i<cogVtx.size(); i++)std::cout<<cogVtx.size()<<" check cogVtx size "<<cogVtx.at(i).second.X()<<"
-   // "<<cogVtx.at(i).second.Y()<<" "<<cogVtx.at(i).second.Z()<<std::endl;
 
-   for (auto &[num, pos] : cogVtx) {
-      if (pos.Z() <= 0 || pos.Z() >= 1000 || sqrt(pos.Perp2()) > 30)
+      // this way the track angle is better than taking the CoG, the uncertainty on the range is not improved
+      auto pos = ClosestPointProjOnLines(line, fBeamLine).first;
+      if (pos.Z() <= cMinVertexZ || pos.Z() >= cMaxVertexZ || std::sqrt(pos.Perp2()) > cMaxVertexRadius)
          continue;
-      std::vector<AtTrack> tracksVtx;
-      tracksVtx.push_back(tracks.at(num));
-      tracksFromVertex tv;
-      tv.vertex = pos;
-      tv.tracks = tracksVtx;
-      SetTracksVertex(tv);
+      SetTracksVertex({pos, {track}});
    }
 }
 
-void AtFindVertex::FindVertexMultipleLines(std::vector<AtTrack> tracks, Int_t nbTracksPerVtx)
+void AtFindVertex::FindVertexMultipleLines(const std::vector<AtTrack> &tracks, Int_t nbTracksPerVtx)
 {
-   std::vector<std::vector<Double_t>> lines;
-   std::vector<Double_t> wlines; // weights for CoG (ex: Chi2, chargeTot, nbInliners...)
-   for (auto track : tracks) {
-      auto ransacLine = dynamic_cast<const AtPatterns::AtPatternLine *>(track.GetPattern());
-      std::vector<Double_t> patternPar;
-      patternPar = ransacLine->GetPatternPar();
-      if (patternPar.size() == 0)
+   std::vector<Line> lines;
+   std::vector<Double_t> wlines; // weights for CoG
+   std::vector<Int_t> itracks;   // index in tracks of each line
+   for (Int_t it = 0; it < tracks.size(); ++it) {
+      Line line;
+      Double_t weight = 0;
+      if (!getLine(tracks[it], line, weight))
          continue;
-      lines.push_back(patternPar);
-      wlines.push_back(ransacLine->GetChi2());
-      // wlines.push_back(ransacLine->GetNumPoints());
-      // wlines.push_back(1.);
+      lines.push_back(line);
+      wlines.push_back(weight);
+      itracks.push_back(it);
    }
 
-   std::vector<AtTrack> tracksFromSameVtx;  // save tracks coming from a common vertex
-   std::vector<std::vector<Int_t>> vtxCand; // save track ID of tracks coming from a common vertex
-   vtxCand = SortTrackSameVtx(lines);
-   for (Int_t i = 0; i < vtxCand.size(); i++)
-      std::cout << vtxCand.size() << " check vtxCand size " << vtxCand.at(i).size() << std::endl;
+   for (auto &group : SortTrackSameVtx(lines)) {
+      auto vertex = FitVertex(lines, wlines, group);
 
-   std::vector<XYZVector> cogVtx;
-   cogVtx = CoGVtx(vtxCand, lines, wlines);
-   // for(Int_t i =0; i<cogVtx.size(); i++)std::cout<<cogVtx.size()<<" check cogVtx size "<<cogVtx.at(i).X()<<"
-   // "<<cogVtx.at(i).Y()<<" "<<cogVtx.at(i).Z()<<std::endl;
-
-   if (vtxCand.size() != cogVtx.size())
-      LOG(WARNING) << cYELLOW << "AtFindVertex : vtxCand.size() != cogVtx.size()" << cNORMAL << std::endl;
+      std::vector<Int_t> closeLines;
+      for (auto i : group)
+         if (distPtLine(lines[i].dir, lines[i].point, vertex) < fLineDistThreshold)
+            closeLines.push_back(i);
+      if (closeLines.size() > 1 && closeLines.size() < group.size()) {
+         group = std::move(closeLines);
+         vertex = FitVertex(lines, wlines, group);
+      }
 
-   for (Int_t i = 0; i < vtxCand.size(); i++) {
-      if (cogVtx.at(i).X() != cogVtx.at(i).X() || cogVtx.at(i).Y() != cogVtx.at(i).Y() ||
-          cogVtx.at(i).Z() != cogVtx.at(i).Z())
+      if (!std::isfinite(vertex.X()) || !std::isfinite(vertex.Y()) || !std::isfinite(vertex.Z()))
          continue;
-      if (cogVtx.at(i).Z() <= 0 || cogVtx.at(i).Z() >= 1000 || sqrt(cogVtx.at(i).Perp2()) > 30)
+      if (vertex.Z() <= cMinVertexZ || vertex.Z() >= cMaxVertexZ || std::sqrt(vertex.Perp2()) > cMaxVertexRadius)
          continue;
-      if (vtxCand.at(i).size() > nbTracksPerVtx)
-         std::cout << cYELLOW << " vtx with more than " << nbTracksPerVtx << " tracks(" << vtxCand.at(i).size() << ")"
-                   << cNORMAL << std::endl;
-      std::vector<AtTrack> tracksVtx;
-      for (auto vtxInd : vtxCand.at(i)) {
-         tracksVtx.push_back(tracks.at(vtxInd));
-      }
+      if (group.size() > nbTracksPerVtx)
+         LOG(debug) << "AtFindVertex : vertex with more than " << nbTracksPerVtx << " tracks (" << group.size() << ")";
+      LOG(debug) << "AtFindVertex : vertex " << vertex.X() << " " << vertex.Y() << " " << vertex.Z();
+
       tracksFromVertex tv;
-      tv.vertex = cogVtx.at(i);
-      tv.tracks = tracksVtx;
-      SetTracksVertex(tv);
+      tv.vertex = vertex;
+      for (auto i : group)
+         tv.tracks.push_back(tracks[itracks[i]]);
+      SetTracksVertex(std::move(tv));
    }
 }
 
-std::vector<std::vector<Int_t>> AtFindVertex::SortTrackSameVtx(std::vector<std::vector<Double_t>> lines)
+/**
+ * Range of the position along the beam over which the line is close enough to the beam to be part
+ * of a vertex, padded by fLineDistThreshold. Returns false if it never is.
+ */
+bool AtFindVertex::GetBeamRegion(const Line &line, Double_t &sMin, Double_t &sMax) const
 {
-   std::vector<std::vector<Int_t>> result;
-   std::vector<Int_t> paired;
-   std::vector<XYZVector> vtx;
-
-   // Test lines against each others
-   for (Int_t i = 0; i < lines.size() - 1; i++) {
-      if (std::find(paired.begin(), paired.end(), i) != paired.end())
-         continue;
-      std::vector<Double_t> line = lines.at(i);
+   auto beamDir = fBeamLine.dir.Unit();
+   auto toLine = line.point - fBeamLine.point;
+   auto q = toLine - toLine.Dot(beamDir) * beamDir;
+   auto e = line.dir - line.dir.Dot(beamDir) * beamDir;
+   double radius = cMaxVertexRadius + fLineDistThreshold;
+
+   // |q + t e| <= radius
+   double a = e.Mag2();
+   double b = q.Dot(e);
+   double c = q.Mag2() - radius * radius;
+   if (a < 1e-12 * line.dir.Mag2()) {
+      sMin = -std::numeric_limits<double>::max();
+      sMax = std::numeric_limits<double>::max();
+      return c <= 0;
+   }
+   double disc = b * b - a * c;
+   if (disc < 0)
+      return false;
+
+   double s1 = toLine.Dot(beamDir) + (-b - std::sqrt(disc)) / a * line.dir.Dot(beamDir);
+   double s2 = toLine.Dot(beamDir) + (-b + std::sqrt(disc)) / a * line.dir.Dot(beamDir);
+   sMin = std::min(s1, s2) - fLineDistThreshold;
+   sMax = std::max(s1, s2) + fLineDistThreshold;
+   return true;
+}
 
-      for (Int_t j = i + 1; j < lines.size(); j++) {
-         if (std::find(paired.begin(), paired.end(), j) != paired.end())
+/**
+ * Two lines that meet near the beam are both close to it around the same position along it, so
+ * only lines whose beam regions overlap are compared, found by sweeping along the beam.
+ */
+std::vector<AtFindVertex::LinePair> AtFindVertex::FindLinePairs(const std::vector<Line> &lines) const
+{
+   struct Region {
+      Double_t sMin;
+      Double_t sMax;
+      Int_t line;
+   };
+   std::vector<Region> regions;
+   for (Int_t i = 0; i < lines.size(); ++i) {
+      Region region{0, 0, i};
+      if (GetBeamRegion(lines[i], region.sMin, region.sMax))
+         regions.push_back(region);
+   }
+   std::sort(regions.begin(), regions.end(), [](const Region &a, const Region &b) { return a.sMin < b.sMin; });
+
+   std::vector<LinePair> pairs;
+   std::vector<Region> active;
+   for (const auto &region : regions) {
+      active.erase(std::remove_if(active.begin(), active.end(),
+                                  [&region](const Region &other) { return other.sMax < region.sMin; }),
+                   active.end());
+
+      for (const auto &other : active) {
+         const auto &line = lines[std::min(region.line, other.line)];
+         const auto &line_f = lines[std::max(region.line, other.line)];
+         if (distLines(line, line_f) >= fLineDistThreshold)
             continue;
 
-         XYZVector buffVtx(0., 0., 9999.);
-         std::vector<Double_t> line_f = lines.at(j);
-
-         if (vtx.size() == 0) { // if no vertex found
-            Double_t angle = angLines(line, line_f);
-            Double_t dist = distLines(line, line_f);
-
-            if (dist < fLineDistThreshold) { // lines.at(i) and lines.at(j) close enough to make a new vertex
-               if (angle < 10 || angle > 170) {
-                  XYZVector vtxLines1 = ClosestPoint2Lines(line, fBeamLine);
-                  XYZVector vtxLines2 = ClosestPoint2Lines(line_f, fBeamLine);
-                  buffVtx = 0.5 * (vtxLines1 + vtxLines2);
-               } else {
-                  buffVtx = ClosestPoint2Lines(line, line_f);
-               }
-               // std::cout<<" paired size "<<paired.size()<<" "<<i<<" "<<j<<" "<<std::endl;
-               paired.push_back(i);
-               paired.push_back(j);
-               vtx.push_back(buffVtx);
-            }
-         } else { // if already a vertex
-            // std::cout<<" paired size "<<paired.size()<<" "<<i<<" "<<j<<" "<<std::endl;
-            XYZVector projVtx;
-            projVtx = ptOnLine(
-               line_f, vtx.back()); // vtx.back() assumes one only wants events with one vertex, but it can be modified
-            Double_t dist1 =
-               sqrt((vtx.back() - projVtx).Mag2()); // distance between saved vtx and its projection on the new line
-            Double_t radProjVtx = sqrt((0.5 * (vtx.back() + projVtx)).Perp2());
-            // std::cout<<radProjVtx<<" distlines "<<dist1<<" vtxBack "<<vtx.back().X()<<" "<<vtx.back().Y()<<"
-            // "<<vtx.back().Z()<<" "<<projVtx.X()<<" "<<projVtx.Y()<<" "<<projVtx.Z()<<std::endl;
-            if (dist1 < fLineDistThreshold &&
-                radProjVtx <= 30.) { // more than 2 lines from a same vertex in the beam region
-               if (std::find(paired.begin(), paired.end(), i) == paired.end()) {
-                  paired.push_back(i);
-               }
-               paired.push_back(j);
-            }
-         }
-      } // j loop lines
-   }    // i loop lines
-   if (paired.size() > 1)
-      result.push_back(paired);
-
-   // for (size_t ipaired = 0; ipaired < paired.size(); ipaired++) {
-   //   std::cout<<paired.at(ipaired)<<std::endl;
-   // }
+         XYZVector poca;
+         if (isParallel(angLines(line, line_f)))
+            poca = 0.5 * (ClosestPointProjOnLines(line, fBeamLine).first +
+                          ClosestPointProjOnLines(line_f, fBeamLine).first);
+         else
+            poca = ClosestPoint2Lines(line, line_f);
+         if (distPtLine(fBeamLine.dir, fBeamLine.point, poca) > cMaxVertexRadius)
+            continue;
+         pairs.push_back({std::min(region.line, other.line), std::max(region.line, other.line), poca});
+      }
+      active.push_back(region);
+   }
 
-   return result;
+   std::sort(pairs.begin(), pairs.end(), [](const LinePair &a, const LinePair &b) {
+      return a.line1 < b.line1 || (a.line1 == b.line1 && a.line2 < b.line2);
+   });
+   return pairs;
 }
 
-std::vector<std::pair<Int_t, XYZVector>>
-AtFindVertex::CoGVtxSingleTrack(std::vector<std::vector<Double_t>> lines, std::vector<Int_t> itracks)
+std::vector<std::vector<Int_t>> AtFindVertex::SortTrackSameVtx(const std::vector<Line> &lines) const
 {
-   std::vector<std::pair<Int_t, XYZVector>> result;
-   for (Int_t i = 0; i < lines.size(); i++) {
-      XYZVector vtx(0, 0, 0);
-      // std::cout<<lines.size()<<" check lines size "<<std::endl;
-      std::vector<Double_t> line = lines.at(i);
-      // Double_t angle = angLines(line, fBeamLine);
-      Double_t dist = distLines(line, fBeamLine);
-      if (dist < fLineDistThreshold) {
-         std::vector<XYZVector> projVtxOnLines1 = ClosestPointProjOnLines(line, fBeamLine);
-         vtx = projVtxOnLines1.at(
-            0); // this way the track angle is better than taking the CoG, the uncertainty on the range is not improved
-         auto p = std::make_pair(itracks.at(i), vtx);
-         result.push_back(p);
+   std::vector<std::vector<Int_t>> result;
+   auto pairs = FindLinePairs(lines);
+   if (pairs.empty())
+      return result;
+
+   // Connect the points of closest approach closer than fLineDistThreshold, looking only in the
+   // neighbouring cells of a grid of that size
+   using Cell = std::array<Int_t, 3>;
+   auto getCell = [this](const XYZVector &pos) {
+      return Cell{static_cast<Int_t>(std::floor(pos.X() / fLineDistThreshold)),
+                  static_cast<Int_t>(std::floor(pos.Y() / fLineDistThreshold)),
+                  static_cast<Int_t>(std::floor(pos.Z() / fLineDistThreshold))};
+   };
+   std::vector<std::pair<Cell, Int_t>> cells;
+   for (Int_t i = 0; i < pairs.size(); ++i)
+      cells.emplace_back(getCell(pairs[i].poca), i);
+   std::sort(cells.begin(), cells.end());
+
+   std::vector<int> parent(pairs.size());
+   std::iota(parent.begin(), parent.end(), 0);
+   for (Int_t i = 0; i < pairs.size(); ++i) {
+      auto cell = getCell(pairs[i].poca);
+      for (int dx = -1; dx <= 1; ++dx)
+         for (int dy = -1; dy <= 1; ++dy)
+            for (int dz = -1; dz <= 1; ++dz) {
+               Cell neighbour{cell[0] + dx, cell[1] + dy, cell[2] + dz};
+               auto begin = std::lower_bound(cells.begin(), cells.end(), std::make_pair(neighbour, 0));
+               for (auto it = begin; it != cells.end() && it->first == neighbour; ++it)
+                  if (it->second > i && (pairs[i].poca - pairs[it->second].poca).Mag2() <
+                                           fLineDistThreshold * fLineDistThreshold)
+                     parent[findRoot(parent, it->second)] = findRoot(parent, i);
+            }
+   }
+
+   // Vertices with the most pairs first
+   std::vector<std::vector<Int_t>> clusters(pairs.size());
+   for (Int_t i = 0; i < pairs.size(); ++i)
+      clusters[findRoot(parent, i)].push_back(i);
+   clusters.erase(std::remove_if(clusters.begin(), clusters.end(), [](const auto &c) { return c.empty(); }),
+                  clusters.end());
+   std::stable_sort(clusters.begin(), clusters.end(),
+                    [](const auto &a, const auto &b) { return a.size() > b.size(); });
+
+   // Each line goes to the vertex it makes the most pairs with
+   std::vector<std::pair<Int_t, Int_t>> best(lines.size(), {-1, 0}); // Cluster and number of pairs
+   std::vector<Int_t> numPairs(lines.size(), 0);
+   for (Int_t c = 0; c < clusters.size(); ++c) {
+      for (auto i : clusters[c]) {
+         ++numPairs[pairs[i].line1];
+         ++numPairs[pairs[i].line2];
       }
-   } // loop i
+      for (auto i : clusters[c])
+         for (auto line : {pairs[i].line1, pairs[i].line2}) {
+            if (numPairs[line] > best[line].second)
+               best[line] = {c, numPairs[line]};
+            numPairs[line] = 0;
+         }
+   }
 
+   result.resize(clusters.size());
+   for (Int_t line = 0; line < lines.size(); ++line)
+      if (best[line].first >= 0)
+         result[best[line].first].push_back(line);
+   result.erase(std::remove_if(result.begin(), result.end(), [](const auto &group) { return group.size() < 2; }),
+                result.end());
    return result;
 }
 
-std::vector<XYZVector> AtFindVertex::CoGVtx(std::vector<std::vector<Int_t>> vtxCand,
-                                            std::vector<std::vector<Double_t>> lines, std::vector<Double_t> wlines)
+/**
+ * Minimizes the weighted sum of squared distances to the lines, solving sum w(I - dd^T)x =
+ * sum w(I - dd^T)p. If the lines are all close to parallel, the vertex is the weighted average of
+ * their points of closest approach to the beam instead.
+ */
+XYZVector AtFindVertex::FitVertex(const std::vector<Line> &lines, const std::vector<Double_t> &weights,
+                                 const std::vector<Int_t> &group) const
 {
-   std::vector<XYZVector> result;
-
-   // loop on vtx Candidates
-   for (auto iv : vtxCand) {
-
-      XYZVector CoG(0, 0, 0);
-
-      std::vector<XYZVector> sumVtx; // sum of points corresponding to where are the closest distances between each
-                                     // lines
-      XYZVector buffVec1(0, 0, 0);
-      sumVtx.resize(iv.size(), buffVec1);
-
-      for (Int_t i = 0; i < iv.size() - 1; i++) {
-         Int_t ii = iv.at(i);
-         std::vector<Double_t> line = lines.at(ii);
-
-         for (Int_t j = i + 1; j < iv.size(); j++) {
-            Int_t jj = iv.at(j);
-            std::vector<Double_t> line_f = lines.at(jj);
-
-            Double_t angle = angLines(line, line_f);
-            Double_t dist = distLines(line, line_f);
-            if (dist < fLineDistThreshold) {
-               if (angle < 10 || angle > 170) {
-                  std::vector<XYZVector> projVtxOnLines1 = ClosestPointProjOnLines(line, fBeamLine);
-                  std::vector<XYZVector> projVtxOnLines2 = ClosestPointProjOnLines(line_f, fBeamLine);
-                  sumVtx.at(i) += projVtxOnLines1.at(0);
-                  sumVtx.at(j) += projVtxOnLines2.at(0);
-               } else {
-                  std::vector<XYZVector> projVtxOnLines = ClosestPointProjOnLines(line, line_f);
-                  sumVtx.at(i) += projVtxOnLines.at(0);
-                  sumVtx.at(j) += projVtxOnLines.at(1);
-                  // std::cout<<"check CoG "<<line.at(0)<<" "<<line.at(1)<<" "<<line_f.at(0)<<"
-                  // "<<line_f.at(1)<<std::endl;
-               }
+   bool crossing = false;
+   for (Int_t i = 0; i < group.size() && !crossing; ++i)
+      for (Int_t j = i + 1; j < group.size() && !crossing; ++j)
+         crossing = !isParallel(angLines(lines[group[i]], lines[group[j]]));
+
+   XYZVector CoG(0, 0, 0);
+   Double_t sumW = 0; // sum of the weights
+   if (crossing) {
+      ROOT::Math::SMatrix<double, 3, 3, ROOT::Math::MatRepSym<double, 3>> A;
+      ROOT::Math::SVector<double, 3> b;
+      for (auto i : group) {
+         auto dir = lines[i].dir.Unit();
+         double d[3] = {dir.X(), dir.Y(), dir.Z()};
+         double p[3] = {lines[i].point.X(), lines[i].point.Y(), lines[i].point.Z()};
+         for (int r = 0; r < 3; ++r)
+            for (int c = 0; c <= r; ++c) {
+               double proj = (r == c ? 1 : 0) - d[r] * d[c];
+               A(r, c) += weights[i] * proj;
+               b[r] += weights[i] * proj * p[c];
+               if (c != r)
+                  b[c] += weights[i] * proj * p[r];
             }
-         } // End of track_f (for loop j)
-      }    // Loop over the lines (for loop i)
-
-      Double_t sumW = 0; // sum of the weights
-      for (Int_t i = 0; i < iv.size(); i++) {
-         // std::cout<<"sumvtx "<<sumVtx.at(i).X()<<" "<<sumVtx.at(i).Y()<<" "<<sumVtx.at(i).Z()<<" chi2
-         // "<<wlines.at(iv.at(i))<<std::endl;
-         CoG += sumVtx.at(i) * (1. / wlines.at(iv.at(i)));
-         sumW += (Double_t)(1. / wlines.at(iv.at(i)));
       }
-      CoG = CoG * (1. / (iv.size() - 1)) * (1. / sumW);
-      std::cout << " vertex " << CoG.X() << " " << CoG.Y() << " " << CoG.Z() << std::endl;
-      result.push_back(CoG);
-
-   } // for iv vertex candidates
+      ROOT::Math::CholeskyDecomp<double, 3> decomp(A);
+      if (decomp.ok() && decomp.Solve(b))
+         return {b[0], b[1], b[2]};
+   }
 
-   return result;
+   for (auto i : group) {
+      CoG += ClosestPointProjOnLines(lines[i], fBeamLine).first * weights[i];
+      sumW += weights[i];
+   }
+   return CoG * (1. / sumW);
 }
 
 // returns the mean point at the closest distance between two lines
-XYZVector AtFindVertex::ClosestPoint2Lines(std::vector<Double_t> line1, std::vector<Double_t> line2)
+XYZVector AtFindVertex::ClosestPoint2Lines(const Line &line1, const Line &line2)
 {
-   XYZVector p1(line1.at(0), line1.at(1), line1.at(2));
-   XYZVector d1(line1.at(3), line1.at(4), line1.at(5));
-   XYZVector p2(line2.at(0), line2.at(1), line2.at(2));
-   XYZVector d2(line2.at(3), line2.at(4), line2.at(5));
-   XYZVector n1 = d1.Cross(d2.Cross(d1));
-   XYZVector n2 = d2.Cross(d1.Cross(d2));
-   Double_t t1 = (p2 - p1).Dot(n2) / (d1.Dot(n2));
-   Double_t t2 = (p1 - p2).Dot(n1) / (d2.Dot(n1));
-   XYZVector c1 = p1 + t1 * d1;
-   XYZVector c2 = p2 + t2 * d2;
-   XYZVector meanpoint = 0.5 * (c1 + c2);
-
-   return meanpoint;
+   auto proj = ClosestPointProjOnLines(line1, line2);
+   return 0.5 * (proj.first + proj.second);
 }
 
 // returns the projections on each lines of the mean point at the closest distance between two lines
-std::vector<XYZVector> AtFindVertex::ClosestPointProjOnLines(std::vector<Double_t> line1, std::vector<Double_t> line2)
+std::pair<XYZVector, XYZVector> AtFindVertex::ClosestPointProjOnLines(const Line &line1, const Line &line2)
 {
-   std::vector<XYZVector> result;
-   XYZVector p1(line1.at(0), line1.at(1), line1.at(2));
-   XYZVector d1(line1.at(3), line1.at(4), line1.at(5));
-   XYZVector p2(line2.at(0), line2.at(1), line2.at(2));
-   XYZVector d2(line2.at(3), line2.at(4), line2.at(5));
+   const auto &p1 = line1.point;
+   const auto &d1 = line1.dir;
+   const auto &p2 = line2.point;
+   const auto &d2 = line2.dir;
    XYZVector n1 = d1.Cross(d2.Cross(d1));
    XYZVector n2 = d2.Cross(d1.Cross(d2));
    Double_t t1 = (p2 - p1).Dot(n2) / (d1.Dot(n2));
    Double_t t2 = (p1 - p2).Dot(n1) / (d2.Dot(n1));
-   XYZVector c1 = p1 + t1 * d1;
-   XYZVector c2 = p2 + t2 * d2;
-   result.push_back(c1);
-   result.push_back(c2);
-
-   return result;
+   return {p1 + t1 * d1, p2 + t2 * d2};
 }
 
 // returns the projection of a point on the parametric line
-XYZVector AtFindVertex::ptOnLine(std::vector<Double_t> line, XYZVector pointToProj)
+XYZVector AtFindVertex::ptOnLine(const Line &line, const XYZVector &pointToProj)
 {
-   XYZVector result(-999, -999, -999);
-   XYZVector posOn(line.at(0), line.at(1), line.at(2));
-   XYZVector dir(line.at(3), line.at(4), line.at(5));
-   XYZVector vop1 = ((dir.Cross(pointToProj - posOn)).Cross(dir)).Unit();
-   Double_t paraVar1 = pointToProj.Dot(dir.Unit()) - posOn.Dot(dir.Unit());
-   Double_t paraVar2 = posOn.Dot(vop1) - pointToProj.Dot(vop1);
-   XYZVector vInter1 = posOn + dir.Unit() * paraVar1;
-   XYZVector vInter2 = pointToProj + vop1 * paraVar2;
-   if (sqrt((vInter1 - vInter2).Mag2()) < 1e-6)
-      result = vInter1;
-
-   return result;
+   auto dir = line.dir.Unit();
+   return line.point + dir * (pointToProj - line.point).Dot(dir);
 }
 
 // returns the distance between a point and a parametric line
-Double_t AtFindVertex::distPtLine(XYZVector dir, XYZVector ptLine, XYZVector pt)
+Double_t AtFindVertex::distPtLine(const XYZVector &dir, const XYZVector &ptLine, const XYZVector &pt)
 {
-   return sqrt((ptLine - pt).Cross(dir).Mag2()) / sqrt(dir.Mag2());
+   return std::sqrt((ptLine - pt).Cross(dir).Mag2() / dir.Mag2());
 }
 
 // returns the distance between two lines
-Double_t AtFindVertex::distLines(std::vector<Double_t> line1, std::vector<Double_t> line2)
+Double_t AtFindVertex::distLines(const Line &line1, const Line &line2)
 {
-   XYZVector p1(line1.at(0), line1.at(1), line1.at(2));
-   XYZVector d1(line1.at(3), line1.at(4), line1.at(5));
-   XYZVector p2(line2.at(0), line2.at(1), line2.at(2));
-   XYZVector d2(line2.at(3), line2.at(4), line2.at(5));
-   XYZVector n = d1.Cross(d2);
-
-   return fabs(n.Dot(p1 - p2) / sqrt(n.Mag2()));
+   XYZVector n = line1.dir.Cross(line2.dir);
+   if (n.Mag2() < 1e-12 * line1.dir.Mag2() * line2.dir.Mag2())
+      return distPtLine(line2.dir, line2.point, line1.point);
+   return std::abs(n.Dot(line1.point - line2.point)) / std::sqrt(n.Mag2());
 }
 
 // returns the angle between two lines
-Double_t AtFindVertex::angLines(std::vector<Double_t> line1, std::vector<Double_t> line2)
+Double_t AtFindVertex::angLines(const Line &line1, const Line &line2)
 {
-   XYZVector d1(line1.at(3), line1.at(4), line1.at(5));
-   XYZVector d2(line2.at(3), line2.at(4), line2.at(5));
-
-   return acos(d1.Dot(d2) / (sqrt(d1.Mag2()) * sqrt(d2.Mag2()))) * 180. / 3.1415;
-}
-
-// check if a track already makes a vertex
-Bool_t AtFindVertex::checkExclusivity(std::vector<Int_t> v1, std::vector<Int_t> v2)
-{
-   Bool_t result = kTRUE;
-   std::vector<Int_t> diff;
-   std::set_difference(v1.begin(), v1.end(), v2.begin(), v2.end(), std::inserter(diff, diff.begin()));
-   if (v1.size() != diff.size())
-      result = kFALSE;
-
-   return result;
+   const auto &d1 = line1.dir;
+   const auto &d2 = line2.dir;
+   return std::acos(d1.Dot(d2) / std::sqrt(d1.Mag2() * d2.Mag2())) * TMath::RadToDeg();
 }
@@ -8,9 +8,8 @@
 #include <Math/Vector3Dfwd.h> // for XYZVector
 #include <Rtypes.h>
 
-#include <algorithm> // for max
-#include <utility>   // for pair
-#include <vector>    // for vector
+#include <utility> // for pair
+#include <vector>  // for vector
 
 using XYZVector = ROOT::Math::XYZVector;
 
@@ -19,29 +18,70 @@ struct tracksFromVertex {
    std::vector<AtTrack> tracks;
 };
 
+/**
+ * Finds the vertices of the straight tracks (AtPatternLine) of an event.
+ *
+ * With one track per vertex, the vertex of each track is its point of closest approach to the beam.
+ * Otherwise, the pairs of lines that pass within fLineDistThreshold of each other near the beam are
+ * found by sweeping over the part of each line close to the beam, instead of testing all pairs.
+ * Their points of closest approach are clustered (DBSCAN with a neighbourhood of fLineDistThreshold
+ * and a single point per core, searched for in a grid), and each cluster is a vertex. A line
+ * belongs to the vertex with the most pairs it is part of, and the vertex is the least squares
+ * point closest to its lines weighted by 1/chi2 of the line fits. This is the weighted average of
+ * the closest points on each line when there are only two. Lines farther than fLineDistThreshold
+ * from that point are dropped, and the vertex is fit again without them.
+ *
+ * @note With more than one track per vertex, every vertex of the event is now kept, so
+ * GetTracksVertex() can have more than one entry for an event with several vertices. Before, only
+ * the first vertex was kept. The vertices with the most pairs of lines come first, so code that
+ * expects a single vertex should use the first entry.
+ */
 class AtFindVertex {
 
+public:
+   /// Straight line through point along dir
+   struct Line {
+      XYZVector point;
+      XYZVector dir;
+   };
+
+private:
+   /// Two lines that could come from the same vertex
+   struct LinePair {
+      Int_t line1;
+      Int_t line2;
+      XYZVector poca; //< Middle of the points of closest approach, or of each line to the beam if near parallel
+   };
+
+   std::vector<tracksFromVertex> fTracksFromVertex;
+
+   Double_t fLineDistThreshold;
+   XYZVector fBeamPoint;
+   XYZVector fBeamDir;
+   Line fBeamLine;
+
 public:
    AtFindVertex(Double_t lineDistThreshold = 15);
    virtual ~AtFindVertex();
 
-   void FindVertex(std::vector<AtTrack> tracks, Int_t nbTracksPerVtx);
-   void FindVertexSingleLine(std::vector<AtTrack> tracks);
-   void FindVertexMultipleLines(std::vector<AtTrack> tracks, Int_t nbTracksPerVtx);
-   XYZVector ClosestPoint2Lines(std::vector<Double_t> line1, std::vector<Double_t> line2);
-   std::vector<XYZVector> ClosestPointProjOnLines(std::vector<Double_t> line1, std::vector<Double_t> line2);
-   std::vector<std::vector<Int_t>> SortTrackSameVtx(std::vector<std::vector<Double_t>> lines);
-   std::vector<XYZVector> CoGVtx(std::vector<std::vector<Int_t>> vtxCand, std::vector<std::vector<Double_t>> lines,
-                                 std::vector<Double_t> wlines);
-   std::vector<std::pair<Int_t, XYZVector>>
-   CoGVtxSingleTrack(std::vector<std::vector<Double_t>> lines, std::vector<Int_t> itracks);
-   XYZVector ptOnLine(std::vector<Double_t> line, XYZVector pointToProj);
-   Double_t distPtLine(XYZVector dir, XYZVector ptLine, XYZVector pt);
-   Double_t distLines(std::vector<Double_t> line1, std::vector<Double_t> line2);
-   Double_t angLines(std::vector<Double_t> line1, std::vector<Double_t> line2);
-   Bool_t checkExclusivity(std::vector<Int_t> v1, std::vector<Int_t> v2);
-
-   void SetTracksVertex(tracksFromVertex val) { fTracksFromVertex.push_back(val); }
+   void FindVertex(const std::vector<AtTrack> &tracks, Int_t nbTracksPerVtx);
+   void FindVertexSingleLine(const std::vector<AtTrack> &tracks);
+   void FindVertexMultipleLines(const std::vector<AtTrack> &tracks, Int_t nbTracksPerVtx);
+
+   /// Indices of the lines coming from each vertex, vertices with the most pairs of lines first
+   std::vector<std::vector<Int_t>> SortTrackSameVtx(const std::vector<Line> &lines) const;
+   /// Weighted least squares vertex of the lines in group
+   XYZVector FitVertex(const std::vector<Line> &lines, const std::vector<Double_t> &weights,
+                       const std::vector<Int_t> &group) const;
+
+   static XYZVector ClosestPoint2Lines(const Line &line1, const Line &line2);
+   static std::pair<XYZVector, XYZVector> ClosestPointProjOnLines(const Line &line1, const Line &line2);
+   static XYZVector ptOnLine(const Line &line, const XYZVector &pointToProj);
+   static Double_t distPtLine(const XYZVector &dir, const XYZVector &ptLine, const XYZVector &pt);
+   static Double_t distLines(const Line &line1, const Line &line2);
+   static Double_t angLines(const Line &line1, const Line &line2);
+
+   void SetTracksVertex(tracksFromVertex val) { fTracksFromVertex.push_back(std::move(val)); }
 
    void SetLineDistThreshold(Double_t val) { fLineDistThreshold = val; }
 
@@ -49,25 +89,15 @@ public:
    {
       fBeamPoint = pos;
       fBeamDir = dir;
-      fBeamLine.resize(6);
-      fBeamLine[0] = fBeamPoint.X();
-      fBeamLine[1] = fBeamPoint.Y();
-      fBeamLine[2] = fBeamPoint.Z();
-      fBeamLine[3] = fBeamDir.X();
-      fBeamLine[4] = fBeamDir.Y();
-      fBeamLine[5] = fBeamDir.Z();
+      fBeamLine = {pos, dir};
    }
 
-   std::vector<tracksFromVertex> GetTracksVertex() { return fTracksFromVertex; }
+   /// Every vertex found and its tracks, with more than one track per vertex the most pairs of lines first
+   const std::vector<tracksFromVertex> &GetTracksVertex() const { return fTracksFromVertex; }
 
 private:
-   std::vector<tracksFromVertex> fTracksFromVertex;
-
-   Double_t fLineDistThreshold;
-   XYZVector fBeamPoint;
-   XYZVector fBeamDir;
-   std::vector<Double_t> fBeamLine;
-   std::vector<std::vector<Double_t>> fLineCand;
+   std::vector<LinePair> FindLinePairs(const std::vector<Line> &lines) const;
+   bool GetBeamRegion(const Line &line, Double_t &sMin, Double_t &sMax) const;
 };
 
 #endif //#ifndef AtFindVertex_H
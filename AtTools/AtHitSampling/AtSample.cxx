@@ -7,21 +7,49 @@
 #include <TRandom.h>      // for TRandom
 #include <TRandom3.h>
 
+#include <algorithm>
 #include <functional> // for multiplies
+#include <iterator>
 #include <numeric>
 
 using namespace RandomSample;
 
 /**
- * @brief Sample hits (AtHit) from fHits.
+ * @brief Sample the indices of N hits in fHits.
  *
  * Assumes fCDF is already setup and we are just using it.
  */
+std::vector<int> AtSample::SampleIndices(int N)
+{
+   return sampleIndicesFromCDF(N);
+}
+
+/**
+ * @brief Sample pointers to hits (AtHit) in fHits.
+ *
+ * Calls SampleIndices(int N).
+ */
+std::vector<const AtHit *> AtSample::SampleHitPointers(int N)
+{
+   std::vector<const AtHit *> ret;
+   auto indices = SampleIndices(N);
+   ret.reserve(indices.size());
+   for (auto ind : indices)
+      ret.push_back(fHits->at(ind));
+   return ret;
+}
+
+/**
+ * @brief Sample copies of hits (AtHit) from fHits.
+ *
+ * Calls SampleIndices(int N).
+ */
 std::vector<AtHit> AtSample::SampleHits(int N)
 {
-   // Using the sampled indices, return a vector of positions
    std::vector<AtHit> ret;
-   for (auto ind : sampleIndicesFromCDF(N))
+   auto indices = SampleIndices(N);
+   ret.reserve(indices.size());
+   for (auto ind : indices)
       ret.push_back(*fHits->at(ind));
    return ret;
 }
@@ -29,42 +57,65 @@ std::vector<AtHit> AtSample::SampleHits(int N)
 /**
  * @brief Sample spacial locations (XYZPoints) from fHits.
  *
- * Calls SampleHits(int N).
+ * Calls SampleIndices(int N).
  */
 std::vector<ROOT::Math::XYZPoint> AtSample::SamplePoints(int N)
 {
    std::vector<ROOT::Math::XYZPoint> ret;
-   for (const auto &hit : SampleHits(N))
-      ret.push_back(hit.GetPosition());
+   auto indices = SampleIndices(N);
+   ret.reserve(indices.size());
+   for (auto ind : indices)
+      ret.push_back(fHits->at(ind)->GetPosition());
    return ret;
 }
 
 /**
  * @brief Get the index i where CDF[i] >= r and CDF[i-1] < r.
  *
- * Loop through fCDF, skipping any index in vetoed, for the index that corresponds to r
- * So need to track what indices are not allowed (vetoed) and the amount of the CDF that has been removed (i.e.
- * sum of PDFs for all removed indices). (rmCDF) The new CDF is then oldCDF/(1-rmCDF) We then need to loop through
- * CDF and look for index where CDF[i] >= r
-
- * @param[in] r Random number between [0,1) to compare to fCDF
- * @param[in] vetoed Indices to ignore while searching fCDF
+ * Binary search of fCDF, so it does not account for any vetoed indices.
  *
+ * @param[in] r Random number between [0,1) to compare to fCDF
  */
-int AtSample::getIndexFromCDF(double r, double rmCFD, std::vector<int> vetoed)
+int AtSample::getIndexFromCDF(double r)
 {
-   double probRemoved = 0; // Probability removed up to this point in the CFD
-   for (int i = 0; i < fCDF.size(); ++i) {
+   auto it = std::lower_bound(fCDF.begin(), fCDF.end(), r);
+   if (it == fCDF.end())
+      return fCDF.size() - 1;
+   return std::distance(fCDF.begin(), it);
+}
 
-      if (isInVector(i, vetoed)) {
-         probRemoved += getPDFfromCDF(i);
-         continue;
+/**
+ * @brief Get the index i where the sum of the PDF in fTree up to and including i is >= r.
+ *
+ * Vetoed indices have had their PDF removed from fTree, so they are skipped. This is the same as
+ * looking for the index where (CDF[i] - removedCDF)/(1 - totalRemovedCDF) >= r with
+ * r scaled by the remaining probability.
+ *
+ * @param[in] r Value between [0, remaining probability) to compare to the partial sums of fTree
+ */
+int AtSample::getIndexFromTree(double r)
+{
+   int n = fTree.size() - 1;
+   int step = 1;
+   while (step * 2 <= n)
+      step *= 2;
+
+   // Walk down the tree looking for the last position where the partial sum is < r
+   int pos = 0;
+   for (; step > 0; step /= 2) {
+      if (pos + step <= n && fTree[pos + step] < r) {
+         pos += step;
+         r -= fTree[pos];
       }
-
-      if ((fCDF[i] - probRemoved) / (1.0 - rmCFD) >= r)
-         return i;
    }
-   return fCDF.size() - 1;
+   return std::min(pos, n - 1);
+}
+
+/// Add val to the PDF of index in fTree
+void AtSample::addToTree(int index, double val)
+{
+   for (int i = index + 1; i < fTree.size(); i += i & (-i))
+      fTree[i] += val;
 }
 
 /**
@@ -74,28 +125,50 @@ int AtSample::getIndexFromCDF(double r, double rmCFD, std::vector<int> vetoed)
  * total number of hits in the hit array.
  * @param[in] vetoed Indices to not sample (even if sampling with replacement).
  */
-std::vector<int> AtSample::sampleIndicesFromCDF(int N, std::vector<int> vetoed)
+std::vector<int> AtSample::sampleIndicesFromCDF(int N, const std::vector<int> &vetoed)
 {
-   // Get the total probablility from the CDF that accounts for the vetoed pads
-   auto probSum = [this](double accum, int ind) { return accum + getPDFfromCDF(ind); };
-   double rmProb = std::accumulate(vetoed.begin(), vetoed.end(), 0.0, probSum);
-
    std::vector<int> sampledInd;
-   while (sampledInd.size() < N) {
-      auto r = gRandom->Uniform();
+   if (fCDF.empty()) // There is nothing to sample (e.g. an event with no hits)
+      return sampledInd;
+   sampledInd.reserve(N);
+
+   // Fast path: nothing is ever removed from the distribution
+   if (fWithReplacement && vetoed.empty()) {
+      while (sampledInd.size() < N)
+         sampledInd.push_back(getIndexFromCDF(gRandom->Uniform()));
+      return sampledInd;
+   }
 
-      // Get the index i where CDF[i] >= r and CDF[i-1] < r
-      int hitInd = getIndexFromCDF(r, rmProb, vetoed);
+   // Remove the vetoed indices from the tree, and track the remaining probability
+   std::vector<int> removed;
+   double probLeft = fCDF.back();
+   auto veto = [this, &removed, &probLeft](int ind) {
+      if (fIsVetoed[ind])
+         return;
+      fIsVetoed[ind] = true;
+      removed.push_back(ind);
+      addToTree(ind, -getPDFfromCDF(ind));
+      probLeft -= getPDFfromCDF(ind);
+   };
+   for (auto ind : vetoed)
+      veto(ind);
+
+   while (sampledInd.size() < N && probLeft > 1e-12 * fCDF.back() && removed.size() < fCDF.size()) {
+      int hitInd = getIndexFromTree(gRandom->Uniform() * probLeft);
+
+      // Protect against round off in the tree landing on a vetoed index
+      if (fIsVetoed[hitInd])
+         continue;
 
-      if (!fWithReplacement) {
-         rmProb += getPDFfromCDF(hitInd);
-         vetoed.push_back(hitInd);
-      }
+      sampledInd.push_back(hitInd);
+      if (!fWithReplacement)
+         veto(hitInd);
+   }
 
-      // Save the index if it has not already been sampled
-      if (fWithReplacement || !isInVector(hitInd, sampledInd)) {
-         sampledInd.push_back(hitInd);
-      }
+   // Restore the tree for the next call
+   for (auto ind : removed) {
+      fIsVetoed[ind] = false;
+      addToTree(ind, getPDFfromCDF(ind));
    }
 
    return sampledInd;
@@ -141,6 +214,16 @@ void AtSample::FillCDF()
    for (auto &elem : fCDF) {
       elem /= norm;
    }
+
+   // Build the Fenwick tree of the PDF in O(N)
+   fTree.assign(fCDF.size() + 1, 0);
+   for (int i = 1; i < fTree.size(); ++i) {
+      fTree[i] += getPDFfromCDF(i - 1);
+      auto parent = i + (i & (-i));
+      if (parent < fTree.size())
+         fTree[parent] += fTree[i];
+   }
+   fIsVetoed.assign(fCDF.size(), false);
 }
 
 void AtSample::SetHitsToSample(const std::vector<HitPtr> &hits)
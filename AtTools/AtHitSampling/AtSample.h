@@ -28,7 +28,12 @@ enum class SampleMethod;
 /**
  * @brief Interface for randomly sampling AtHits.
  *
- * Samples according to the cumulitive distribution function fCDF.
+ * Samples according to the cumulitive distribution function fCDF. Without vetoed hits each draw is a
+ * binary search of fCDF. When hits are vetoed (including hits already drawn when sampling without
+ * replacement) draws use a Fenwick tree of the PDF where vetoed hits have their weight removed, so
+ * every draw is O(log N) regardless of the number of vetoed hits.
+ *
+ * Derived classes implement SampleIndices(); SampleHits() and SamplePoints() are built on top of it.
  *
  * @ingroup AtHitSampling
  */
@@ -37,12 +42,16 @@ protected:
    using HitPtr = std::unique_ptr<AtHit>;
    const std::vector<const AtHit *> *fHits; //< Hits to sample from
    std::vector<double> fCDF;                //< Cummulative distribution function for hits
+   std::vector<double> fTree;               //< Fenwick tree (1-indexed) of the PDF for hits
+   std::vector<bool> fIsVetoed;             //< If each hit is currently vetoed while sampling
    bool fWithReplacement{false};            //< If we should sample with replacement
 
 public:
    virtual ~AtSample() = default;
 
-   virtual std::vector<AtHit> SampleHits(int N);
+   virtual std::vector<int> SampleIndices(int N);
+   std::vector<const AtHit *> SampleHitPointers(int N);
+   std::vector<AtHit> SampleHits(int N);
    std::vector<ROOT::Math::XYZPoint> SamplePoints(int N);
 
    virtual void SetHitsToSample(const std::vector<const AtHit *> &hits) = 0;
@@ -63,13 +72,15 @@ protected:
    virtual std::vector<double> PDF(const AtHit &hit) = 0;
    void FillCDF();
 
-   std::vector<int> sampleIndicesFromCDF(int N, std::vector<int> vetoed = {});
-   int getIndexFromCDF(double r, double rmCFD, std::vector<int> vetoed);
+   std::vector<int> sampleIndicesFromCDF(int N, const std::vector<int> &vetoed = {});
+   int getIndexFromCDF(double r);
+   int getIndexFromTree(double r);
+   void addToTree(int index, double val);
 
    double getPDFfromCDF(int index);
 
    template <typename T>
-   static inline bool isInVector(T val, std::vector<T> vec)
+   static inline bool isInVector(T val, const std::vector<T> &vec)
    {
       if (vec.size() == 0)
          return false;
@@ -8,11 +8,11 @@
 #include <utility> // for move
 
 using namespace RandomSample;
-std::vector<AtHit> AtSampleFromReference::SampleHits(int N)
+std::vector<int> AtSampleFromReference::SampleIndices(int N)
 {
    SampleReferenceHit();
 
-   return AtSample::SampleHits(N);
+   return AtSample::SampleIndices(N);
 }
 
 /**
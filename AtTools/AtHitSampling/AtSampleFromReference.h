@@ -21,7 +21,7 @@ protected:
 
 public:
    virtual ~AtSampleFromReference() = default;
-   virtual std::vector<AtHit> SampleHits(int N) override;
+   virtual std::vector<int> SampleIndices(int N) override;
    virtual void SetHitsToSample(const std::vector<const AtHit *> &hits) override { fHits = &hits; }
    void SetReferenceHit(AtHit hit);
    const AtHit &GetReferenceHit() const { return fReferenceHit; }
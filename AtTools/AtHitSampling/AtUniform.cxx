@@ -8,18 +8,16 @@
 #include <algorithm>
 using namespace RandomSample;
 
-std::vector<AtHit> AtUniform::SampleHits(int N)
+std::vector<int> AtUniform::SampleIndices(int N)
 {
    std::vector<int> ind;
-   std::vector<AtHit> retVec;
+   ind.reserve(N);
    while (ind.size() < N) {
       int i = gRandom->Uniform() * fHits->size();
-      if (fWithReplacement || !isInVector(i, ind)) {
+      if (fWithReplacement || !isInVector(i, ind))
          ind.push_back(i);
-         retVec.push_back(*fHits->at(i));
-      }
    }
-   return retVec;
+   return ind;
 }
 std::vector<double> AtUniform::PDF(const AtHit &hit)
 {
@@ -15,7 +15,7 @@ namespace RandomSample {
  */
 class AtUniform : public AtSample {
 public:
-   virtual std::vector<AtHit> SampleHits(int N) override;
+   virtual std::vector<int> SampleIndices(int N) override;
    virtual void SetHitsToSample(const std::vector<const AtHit *> &hits) override { fHits = &hits; }
 
 protected:
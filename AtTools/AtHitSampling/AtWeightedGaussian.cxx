@@ -8,7 +8,6 @@
 #include <Math/Vector3D.h> // for DisplacementVector3D
 
 #include <cmath>   // for sqrt
-#include <utility> // for move
 
 using namespace RandomSample;
 void AtWeightedGaussian::SetHitsToSample(const std::vector<const AtHit *> &hits)
@@ -26,7 +25,5 @@ std::vector<double> AtWeightedGaussian::PDF(const AtHit &hit)
 
 void AtWeightedGaussian::SampleReferenceHit()
 {
-   AtChargeWeighted charge;
-   charge.SetHitsToSample(*fHits);
-   SetReferenceHit(std::move(charge.SampleHits(1)[0]));
+   SetReferenceHit(*fChargeSample.SampleHitPointers(1)[0]);
 }
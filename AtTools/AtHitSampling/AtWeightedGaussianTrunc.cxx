@@ -11,7 +11,7 @@
 #include <cmath> // for sqrt
 using namespace RandomSample;
 
-std::vector<AtHit> AtWeightedGaussianTrunc::SampleHits(int N)
+std::vector<int> AtWeightedGaussianTrunc::SampleIndices(int N)
 {
    int p1, p2;
    int pclouds = fHits->size();
@@ -24,7 +24,7 @@ std::vector<AtHit> AtWeightedGaussianTrunc::SampleHits(int N)
    double Tcharge = 0;
    double avgCharge = 0;
    std::vector<double> Proba;
-   std::vector<AtHit> retVec;
+   std::vector<int> retVec;
 
    for (int i = 0; i < pclouds; i++)
       Tcharge += fHits->at(i)->GetCharge();
@@ -35,7 +35,7 @@ std::vector<AtHit> AtWeightedGaussianTrunc::SampleHits(int N)
 
    avgCharge = Tcharge / (double)pclouds;
    p1 = gRandom->Uniform() * pclouds;
-   retVec.push_back(*fHits->at(p1));
+   retVec.push_back(p1);
 
    do {
       counter++;
@@ -47,7 +47,7 @@ std::vector<AtHit> AtWeightedGaussianTrunc::SampleHits(int N)
       y = gRandom->Uniform();
       w = gRandom->Uniform() * 4. * avgCharge;
       if (fHits->at(p2)->GetCharge() > w || y < gauss) {
-         retVec.push_back(*fHits->at(p2));
+         retVec.push_back(p2);
       }
    } while (retVec.size() < N && counter < pclouds && counter < 50);
 
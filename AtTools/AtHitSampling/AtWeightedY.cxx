@@ -10,23 +10,19 @@
 
 using namespace RandomSample;
 
-std::vector<AtHit> AtWeightedY::SampleHits(int N)
+std::vector<int> AtWeightedY::SampleIndices(int N)
 {
-   std::vector<AtHit> ret;
    LOG(debug) << "Vetoing " << fVetoIn.size();
 
    // If every hit is outside of the beam region, then skip the vetoed beam region
    if (fVetoIn.size() == fHits->size() || fVetoIn.size() == 0) {
       LOG(error) << "Defaulting to normal sampling (fVetoIn is size: " << fVetoIn.size() << ")";
-      for (auto ind : sampleIndicesFromCDF(N))
-         ret.push_back(*fHits->at(ind));
-      return ret;
+      return sampleIndicesFromCDF(N);
    }
 
-   for (auto ind : sampleIndicesFromCDF(2, fVetoIn))
-      ret.push_back(*fHits->at(ind));
-   for (auto ind : sampleIndicesFromCDF(N - 2, fVetoOut))
-      ret.push_back(*fHits->at(ind));
+   auto ret = sampleIndicesFromCDF(2, fVetoIn);
+   auto outer = sampleIndicesFromCDF(N - 2, fVetoOut);
+   ret.insert(ret.end(), outer.begin(), outer.end());
    return ret;
 }
 
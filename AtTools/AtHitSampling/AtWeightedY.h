@@ -20,7 +20,7 @@ protected:
    std::vector<int> fVetoOut; //< List of indicies for inner region of the TPC
 
 public:
-   virtual std::vector<AtHit> SampleHits(int N) override;
+   virtual std::vector<int> SampleIndices(int N) override;
    virtual void SetHitsToSample(const std::vector<const AtHit *> &hits) override;
 };
 } // namespace RandomSample
@@ -10,29 +10,25 @@
 
 using namespace RandomSample;
 
-std::vector<AtHit> AtY::SampleHits(int N)
+std::vector<int> AtY::SampleIndices(int N)
 {
-   std::vector<AtHit> ret;
    LOG(debug) << "Vetoing " << fBeam.size() << " from beam region";
 
    // If every hit is outside of the beam region, then skip the vetoed beam region
    if (fBeam.size() + N - 2 > fHits->size() || fNotBeam.size() + 2 > fHits->size()) {
       LOG(debug) << "Defaulting to normal sampling (fBeam is size: " << fBeam.size() << ")";
-      for (auto ind : sampleIndicesFromCDF(N))
-         ret.push_back(*fHits->at(ind));
-      return ret;
+      return sampleIndicesFromCDF(N);
    }
 
-   double maxZ = std::max(ret[0].GetPosition().Z(), ret[1].GetPosition().Z());
+   std::vector<int> ret;
 
    // Try to sample 10 times respecting all of the conditions.
    // If they're not met just return the final attempt
    for (int iter = 0; iter < 10; iter++) {
-      ret.clear();
 
       // Sample the beam region
-      for (auto ind : sampleIndicesFromCDF(2, fNotBeam))
-         ret.push_back(*fHits->at(ind));
+      ret = sampleIndicesFromCDF(2, fNotBeam);
+      double maxZ = std::max(fHits->at(ret[0])->GetPosition().Z(), fHits->at(ret[1])->GetPosition().Z());
 
       // try 10 times to find fragment hits that are closer to the pad plane
       for (int iterFF = 0; iterFF < 10; ++iterFF) {
@@ -42,8 +38,7 @@ std::vector<AtHit> AtY::SampleHits(int N)
             isGood |= fHits->at(ind)->GetPosition().Z() > maxZ;
 
          if (isGood) {
-            for (auto ind : indices)
-               ret.push_back(*fHits->at(ind));
+            ret.insert(ret.end(), indices.begin(), indices.end());
             return ret;
          }
       }
@@ -51,8 +46,8 @@ std::vector<AtHit> AtY::SampleHits(int N)
 
    // Failed to find hits that meat our contition but we should have beam sampled already
    // so just sample the non-beam region.
-   for (auto ind : sampleIndicesFromCDF(N - 2, fBeam))
-      ret.push_back(*fHits->at(ind));
+   auto indices = sampleIndicesFromCDF(N - 2, fBeam);
+   ret.insert(ret.end(), indices.begin(), indices.end());
 
    return ret;
 }
@@ -24,7 +24,7 @@ protected:
    double fBeamRadius{40}; // Radius of the beam in mm
 
 public:
-   virtual std::vector<AtHit> SampleHits(int N) override;
+   virtual std::vector<int> SampleIndices(int N) override;
    virtual void SetHitsToSample(const std::vector<const AtHit *> &hits) override;
    virtual std::vector<double> PDF(const AtHit &hit) override { return {1}; }
 };
@@ -1,32 +1,63 @@
 #include "AtKinematics.h"
 
-#include <Rtypes.h>        // for TGenericClassInfo
-#include <TError.h>        // for Error
-#include <TMath.h>         // for Power, Sqrt
-#include <TMatrixTUtils.h> // for TMatrixTRow
-
-#include <algorithm> // for max
+#include <Math/CholeskyDecomp.h>
+#include <Math/MatrixRepresentationsStatic.h> // for MatRepSym
+#include <Math/SMatrix.h>
+#include <Math/SVector.h>
+#include <Rtypes.h> // for TGenericClassInfo
+#include <TMath.h>  // for Power, Sqrt
+
+#include <algorithm> // for copy_n
 #include <cassert>   // for assert
-#include <cmath>     // for pow, sqrt, cos
+#include <cmath>     // for pow, sqrt, cos, abs
 #include <cstdlib>   // for exit
 #include <iostream>  // for operator<<, basic_ostream, basic_ostream<>::__os...
-#include <utility>   // for mov
 ClassImp(AtTools::AtKinematics);
 
-AtTools::AtKinematics::AtKinematics() : fVerbosity(0)
-{
+namespace {
+constexpr int cNumConstraints = 4; // Momentum and energy conservation
+constexpr int cNumTriangle = 10;   // Elements in the lower triangle of a 4x4 matrix
+/// Diagonal of each 4x4 block of the derivative of the constraints
+constexpr double cConstraintSign[cNumConstraints] = {1, -1, -1, -1};
 
-   std::cout << " AtTools::AtKinematics: Initializing Kinematical Fit matrices "
-             << "\n";
+/**
+ * Iterate the kinematical fit of one event, updating the coordinates alpha in place. N is the
+ * number of particles when known at compile time, and 0 to use numParticles instead.
+ */
+template <int N>
+void FitEvent(double *alpha, int numParticles, double targetMass, int numIterations, const double *chol,
+              const double *gain)
+{
+   const int n = N > 0 ? 4 * N : 4 * numParticles;
+   for (int k = 0; k < numIterations; ++k, chol += cNumTriangle, gain += cNumConstraints * n) {
+      // Projectile (and target) minus the exit channel
+      double d[cNumConstraints] = {alpha[0], alpha[1], alpha[2], alpha[3] + targetMass};
+      for (int i = cNumConstraints; i < n; i += cNumConstraints)
+         for (int j = 0; j < cNumConstraints; ++j)
+            d[j] -= alpha[i + j];
+
+      // Forward substitution for y = L^-1 d, so chi2 = d^T (D V D^T)^-1 d = y^T y
+      double y[cNumConstraints];
+      double chi2 = 0;
+      for (int r = 0, idx = 0; r < cNumConstraints; ++r) {
+         double sum = d[r];
+         for (int c = 0; c < r; ++c)
+            sum -= chol[idx++] * y[c];
+         y[r] = sum / chol[idx++];
+         chi2 += y[r] * y[r];
+      }
 
-   auto alpha0 = std::make_unique<TMatrixD>(4 * fNumParticles, 1);
-   fAlphaP.push_back(std::move(alpha0));
+      for (int a = 0; a < n; ++a)
+         for (int l = 0; l < cNumConstraints; ++l)
+            alpha[a] -= gain[a * cNumConstraints + l] * y[l];
 
-   for (auto i = 0; i < fNumParticles; ++i) {
-      auto alpha = std::make_unique<TMatrixD>(4, 1);
-      fAlphaP.push_back(std::move(alpha));
+      if (std::abs(chi2) < 1.0)
+         break;
    }
 }
+} // namespace
+
+AtTools::AtKinematics::AtKinematics() : fVerbosity(0) {}
 
 std::tuple<Double_t, Double_t> AtTools::AtKinematics::GetMomFromBrho(Double_t M, Double_t Z, Double_t brho)
 {
@@ -83,161 +114,153 @@ std::vector<double> AtTools::AtKinematics::KinematicalFit(std::vector<double> &p
    // Input vector is composed by 4 four-momentum vectors of (projectile,ejectile,proton1,proton2)
    // Output vector contains the fitted coordinates in the same order
 
-   std::vector<Double_t> parOut;
-
-   Int_t rowDim = fAlphaP[0]->GetNrows();
-   std::cout << " Row dimension " << rowDim << "\n";
-   if (rowDim != fNumParticles * 4 || rowDim != parameters.size()) {
+   if (fVerbosity == 1)
+      std::cout << " Row dimension " << parameters.size() << "\n";
+   if (parameters.size() % cNumConstraints != 0) {
       std::cerr << " Wrong matrix/parameter dimension. Aborting... "
                 << "\n";
       std::exit(0);
    }
 
-   ResetMatrices();
-
-   for (auto i = 0; i < fNumParticles; ++i) {
-      for (auto j = 0; j < 4; ++j) {
-         (*fAlphaP.at(i + 1))[j][0] = parameters[i * 4 + j];
-      }
-      (*fAlphaP.at(0)).SetSub(i * 4, 0, (*fAlphaP.at(i + 1)));
-   }
-
-   TMatrixD *alpha;
-   TMatrixD dalpha(4 * fNumParticles, 1); // delta alpha
-   dalpha.Zero();
-   alpha = fAlphaP.at(0).get();
-
-   // alpha->Print();
-
-   TMatrixD chi2(1, 1);
-   chi2.Zero();
-
-   TMatrixD Cov = CalculateCovariance();
-
-   double weighting = 0.05;
-
-   for (auto i = 0; i < fNumIterations; i++) {
-
-      TMatrixD D = CalculateD(alpha);
-      TMatrixD Dt = D;
-      Dt.T();
-      TMatrixD Vd = D * Cov * Dt;
-      Vd.Invert();
-      Cov = Cov - Cov * Dt * Vd * D * Cov * weighting;
-
-      // calculate labmda
-      TMatrixD d = Calculated(alpha);
-      TMatrixD temp1 = (d + D * dalpha);
-      TMatrixD lambda = Vd * temp1;
-
-      // calculate chi2
-      TMatrixD lambdaT = lambda;
-      chi2 = lambdaT.T() * temp1;
-
-      // calculate alpha
-      *alpha = *fAlphaP.at(0).get() - weighting * Cov * Dt * lambda;
-      dalpha = *alpha - *fAlphaP.at(0).get();
-      *fAlphaP.at(0).get() = *alpha;
-
-      // std::cout<<" chi2 "<<chi2[0][0]<<"\n";
-
-      if (fabs(chi2[0][0]) < 1.0)
-         break;
-   }
-
-   for (auto i = 0; i < 4 * fNumParticles; ++i)
-      parOut.push_back((*alpha)[i][0]);
-
+   std::vector<double> parOut(parameters.size());
+   KinematicalFit(parameters.data(), parOut.data(), 1, parameters.size() / cNumConstraints);
    return parOut;
 }
 
-TMatrixD AtTools::AtKinematics::Calculated(TMatrixD *alpha)
+std::vector<double> AtTools::AtKinematics::KinematicalFit(const std::vector<double> &parameters, Int_t numParticles)
 {
-   TMatrixD dval(4, 1);
-   dval.Zero();
-   double mt = fTargetMass * 931.494; // target mass
-
-   double mout1 = 0.0;
-   double mout2 = 0.0;
-   double mout3 = 0.0;
-   double mout4 = 0.0;
-
-   // Exit channel momentum
-   for (auto i = 1; i < fNumParticles; ++i) {
-      mout1 += (*alpha)[4 * i][0];
-      mout2 += (*alpha)[4 * i + 1][0];
-      mout3 += (*alpha)[4 * i + 2][0];
-      mout4 += (*alpha)[4 * i + 3][0];
-      // std::cout<<mout1<<"\n";
+   if (numParticles <= 0 || parameters.size() % (cNumConstraints * numParticles) != 0) {
+      std::cerr << " Wrong matrix/parameter dimension. Aborting... "
+                << "\n";
+      std::exit(0);
    }
 
-   double h1 = (*alpha)[0][0] - mout1;      // momentum conservation X
-   double h2 = (*alpha)[1][0] - mout2;      // momentum conservation Y
-   double h3 = (*alpha)[2][0] - mout3;      // momentum conservation Z
-   double h4 = (*alpha)[3][0] + mt - mout4; // Total Energy conservation
-
-   dval[0][0] = h1;
-   dval[1][0] = h2;
-   dval[2][0] = h3;
-   dval[3][0] = h4;
-
-   // dval.Print();
-
-   return dval;
+   std::vector<double> parOut(parameters.size());
+   KinematicalFit(parameters.data(), parOut.data(), parameters.size() / (cNumConstraints * numParticles),
+                  numParticles);
+   return parOut;
 }
 
-TMatrixD AtTools::AtKinematics::CalculateD(TMatrixD *alpha)
+/**
+ * The fixed size fits for the usual numbers of particles let the compiler unroll the loops. Nothing
+ * is allocated unless the number of particles, iterations, or weighting changed since the last call.
+ */
+void AtTools::AtKinematics::KinematicalFit(const double *parameters, double *fitted, size_t numEvents,
+                                           Int_t numParticles)
 {
-
-   TMatrixD Dval(4, 4 * fNumParticles);
-   Dval.Zero();
-
-   for (auto i = 0; i < fNumParticles; ++i) {
-      TMatrixD Dsub(4, 4);
-      Dsub.Zero();
-
-      Dsub[0][0] = 1;
-      for (int j = 1; j < 4; j++)
-         Dsub[j][j] = -1;
-
-      Dval.SetSub(0, i * 4, Dsub);
+   if (numParticles < 2) {
+      std::cerr << " Kinematical fit needs at least two particles. Aborting... "
+                << "\n";
+      std::exit(0);
    }
-
-   // Dval.Print();
-
-   return Dval;
-}
-
-TMatrixD AtTools::AtKinematics::CalculateCovariance()
-{
-   TMatrixD Vval(4 * fNumParticles, 4 * fNumParticles);
-   Vval.Zero();
-
-   for (auto i = 0; i < fNumParticles; ++i) {
-      TMatrixD Vsub(4, 4);
-      Vsub.Zero();
-
-      for (int j = 0; j < 4; j++)
-         Vsub[j][j] = 0.1;
-
-      Vval.SetSub(i * 4, i * 4, Vsub);
+   if (fKFNumParticles != numParticles)
+      CalculateKFSchedule(numParticles);
+
+   auto fitEvent = FitEvent<0>;
+   switch (numParticles) {
+   case 2: fitEvent = FitEvent<2>; break;
+   case 3: fitEvent = FitEvent<3>; break;
+   case 4: fitEvent = FitEvent<4>; break;
+   default: break;
    }
 
-   // Vval.Print();
-
-   return Vval;
+   const int n = cNumConstraints * numParticles;
+   const int numIterations = fKFCholesky.size() / cNumTriangle;
+   const double mt = fTargetMass * 931.494; // target mass
+   for (size_t i = 0; i < numEvents; ++i) {
+      double *alpha = fitted + i * n;
+      if (alpha != parameters + i * n)
+         std::copy_n(parameters + i * n, n, alpha);
+      fitEvent(alpha, numParticles, mt, numIterations, fKFCholesky.data(), fKFGain.data());
+   }
 }
 
-void AtTools::AtKinematics::ResetMatrices()
+/**
+ * The constraints are linear with derivative D (4 x 4N), and the coordinates start with a covariance
+ * V of 0.1 on the diagonal. Each iteration updates V -= w (DV)^T (DVD^T)^-1 DV, with w the weighting,
+ * and then moves the coordinates by -w V D^T (DVD^T)^-1 d. Neither V nor D depend on the coordinates,
+ * so for each iteration we store the Cholesky factor L of DVD^T (with the covariance before the
+ * update), and the gain w V D^T L^-T (with the covariance after it).
+ */
+void AtTools::AtKinematics::CalculateKFSchedule(Int_t numParticles)
 {
-   for (auto &alpha : fAlphaP)
-      alpha->Zero();
-}
+   using SymMatrix = ROOT::Math::SMatrix<double, cNumConstraints, cNumConstraints,
+                                         ROOT::Math::MatRepSym<double, cNumConstraints>>;
+   using Matrix = ROOT::Math::SMatrix<double, cNumConstraints, cNumConstraints>;
+   using Vector = ROOT::Math::SVector<double, cNumConstraints>;
+
+   const int n = cNumConstraints * numParticles;
+   fKFCholesky.assign(std::max(fNumIterations, 0) * cNumTriangle, 0);
+   fKFGain.assign(std::max(fNumIterations, 0) * n * cNumConstraints, 0);
+   fKFNumParticles = numParticles;
+
+   std::vector<double> cov(n * n, 0);
+   for (int a = 0; a < n; ++a)
+      cov[a * n + a] = 0.1;
+   std::vector<double> DV(cNumConstraints * n);
+
+   for (int k = 0; k < fNumIterations; ++k) {
+      for (int r = 0; r < cNumConstraints; ++r)
+         for (int c = 0; c < n; ++c) {
+            double sum = 0;
+            for (int i = r; i < n; i += cNumConstraints)
+               sum += cov[i * n + c];
+            DV[r * n + c] = cConstraintSign[r] * sum;
+         }
+
+      SymMatrix DVDt;
+      for (int r = 0; r < cNumConstraints; ++r)
+         for (int l = 0; l <= r; ++l) {
+            double sum = 0;
+            for (int i = l; i < n; i += cNumConstraints)
+               sum += DV[r * n + i];
+            DVDt(r, l) = cConstraintSign[l] * sum;
+         }
+
+      ROOT::Math::CholeskyDecomp<double, cNumConstraints> decomp(DVDt);
+      if (!decomp.ok()) {
+         std::cerr << " Kinematical fit covariance is not positive definite after " << k << " iterations "
+                   << "\n";
+         fKFCholesky.resize(k * cNumTriangle);
+         fKFGain.resize(k * n * cNumConstraints);
+         return;
+      }
+      Matrix L;
+      decomp.getL(L);
+      auto chol = &fKFCholesky[k * cNumTriangle];
+      for (int r = 0, idx = 0; r < cNumConstraints; ++r)
+         for (int c = 0; c <= r; ++c)
+            chol[idx++] = L(r, c);
+
+      for (int c = 0; c < n; ++c) {
+         Vector x;
+         for (int r = 0; r < cNumConstraints; ++r)
+            x[r] = DV[r * n + c];
+         decomp.Solve(x);
+         for (int a = 0; a < n; ++a) {
+            double sum = 0;
+            for (int r = 0; r < cNumConstraints; ++r)
+               sum += DV[r * n + a] * x[r];
+            cov[a * n + c] -= fWeigth * sum;
+         }
+      }
 
-void AtTools::AtKinematics::PrintMatrices()
-{
-   for (auto &alpha : fAlphaP)
-      alpha->Print();
+      // Rows of the gain are (L^-1 w D V_a)^T, by forward substitution
+      auto gain = &fKFGain[k * n * cNumConstraints];
+      for (int a = 0; a < n; ++a) {
+         double y[cNumConstraints];
+         for (int r = 0, idx = 0; r < cNumConstraints; ++r) {
+            double sum = 0;
+            for (int i = r; i < n; i += cNumConstraints)
+               sum += cov[a * n + i];
+            sum *= fWeigth * cConstraintSign[r];
+            for (int c = 0; c < r; ++c)
+               sum -= chol[idx++] * y[c];
+            y[r] = sum / chol[idx++];
+            gain[a * cNumConstraints + r] = y[r];
+         }
+      }
+   }
 }
 
 namespace AtTools::Kinematics {
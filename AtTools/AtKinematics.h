@@ -10,14 +10,12 @@
 #include <Math/Vector4D.h>
 #include <Math/Vector4Dfwd.h> // for PxPyPzEVector
 #include <Rtypes.h>           // for Double_t, THashConsistencyHolder, Int_t, ClassDef
-#include <TMatrixDfwd.h>      // for TMatrixD
-#include <TMatrixT.h>         // for TMatrixT
 #include <TObject.h>          // for TObject
 
-#include <cmath>  // for sqrt
-#include <memory> // for unique_ptr
-#include <tuple>  // for tuple
-#include <vector> // for vector
+#include <cmath>   // for sqrt
+#include <cstddef> // for size_t
+#include <tuple>   // for tuple
+#include <vector>  // for vector
 class TBuffer;
 class TClass;
 class TMemberInspector;
@@ -29,19 +27,20 @@ class AtKinematics : public TObject {
 private:
    Int_t fVerbosity;
 
-   Int_t fNumParticles{3};              //
    Int_t fNumIterations{100};           //! Number of iterations for the minimizer
    Double_t fWeigth{0.05};              //! Minimization weighting
    Double_t fTargetMass{2.01410177812}; //! Mass of target for Kinematical fitting
 
-   std::vector<std::unique_ptr<TMatrixD>> fAlphaP; //! alpha row for n particles;
-   void ResetMatrices();
-   void PrintMatrices();
-   TMatrixD CalculateCovariance();
-   TMatrixD CalculateD(TMatrixD *alpha);
-   TMatrixD Calculated(TMatrixD *alpha);
+   // The covariance of the kinematical fit does not depend on the four-momenta, so the Cholesky
+   // factors and gains of each iteration are calculated once for a number of particles
+   Int_t fKFNumParticles{0};        //! Number of particles fKFCholesky and fKFGain were calculated for
+   std::vector<double> fKFCholesky; //! Lower triangle of the Cholesky factor L of the constraint covariance
+   std::vector<double> fKFGain;     //! Gain (4N x 4) applied to L^-1 d of each iteration
 
-   ClassDef(AtKinematics, 1);
+   void CalculateKFSchedule(Int_t numParticles);
+   void ClearKFSchedule() { fKFNumParticles = 0; }
+
+   ClassDef(AtKinematics, 2);
 
 public:
    AtKinematics();
@@ -57,8 +56,24 @@ public:
    Double_t omega(Double_t x, Double_t y, Double_t z);
 
    std::vector<double> KinematicalFit(std::vector<double> &parameters);
-   inline void SetKFIterations(Int_t iter) { fNumIterations = iter; }
-   inline void SetKFWeighting(Double_t weight) { fWeigth = weight; }
+   /**
+    * Fit numEvents events stored one after the other in parameters, each as the 4*numParticles
+    * coordinates KinematicalFit(std::vector<double>&) takes. The fitted coordinates are written to
+    * fitted in the same layout, which can be parameters itself.
+    */
+   void KinematicalFit(const double *parameters, double *fitted, size_t numEvents, Int_t numParticles);
+   /// Fit all the events in parameters, with 4*numParticles coordinates per event.
+   std::vector<double> KinematicalFit(const std::vector<double> &parameters, Int_t numParticles);
+   inline void SetKFIterations(Int_t iter)
+   {
+      fNumIterations = iter;
+      ClearKFSchedule();
+   }
+   inline void SetKFWeighting(Double_t weight)
+   {
+      fWeigth = weight;
+      ClearKFSchedule();
+   }
    inline void SetKFTargetMass(Double_t mass) { fTargetMass = mass; }
 };
 
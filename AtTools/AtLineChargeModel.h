@@ -6,6 +6,8 @@
 
 #include <Math/Point3D.h>
 #include <Math/Point3Dfwd.h>
+
+#include <memory> // for make_shared
 class AtDigiPar;
 
 using XYZPoint = ROOT::Math::XYZPoint;
@@ -22,6 +24,10 @@ private:
 public:
    AtLineChargeModel() = default;
    ~AtLineChargeModel() = default;
+   virtual std::shared_ptr<AtSpaceChargeModel> Clone() const override
+   {
+      return std::make_shared<AtLineChargeModel>(*this);
+   }
 
    virtual XYZPoint CorrectSpaceCharge(const XYZPoint &directInputPosition) override;
    virtual XYZPoint ApplySpaceCharge(const XYZPoint &reverseInputPosition) override;
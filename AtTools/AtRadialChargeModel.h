@@ -6,6 +6,7 @@
 #include <Rtypes.h> // for Double_t
 
 #include <functional>
+#include <memory> // for make_shared
 class AtDigiPar;
 
 /**
@@ -36,6 +37,10 @@ private:
 
 public:
    AtRadialChargeModel(EFieldPtr efield);
+   virtual std::shared_ptr<AtSpaceChargeModel> Clone() const override
+   {
+      return std::make_shared<AtRadialChargeModel>(*this);
+   }
 
    virtual XYZPoint CorrectSpaceCharge(const XYZPoint &directInputPosition) override;
    virtual XYZPoint ApplySpaceCharge(const XYZPoint &reverseInputPosition) override;
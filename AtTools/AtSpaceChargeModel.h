@@ -4,6 +4,8 @@
 
 #include <Math/Point3D.h>
 #include <Math/Point3Dfwd.h>
+
+#include <memory> // for shared_ptr
 class AtDigiPar;
 
 class AtSpaceChargeModel {
@@ -15,6 +17,7 @@ protected:
 
 public:
    virtual ~AtSpaceChargeModel() = default;
+   virtual std::shared_ptr<AtSpaceChargeModel> Clone() const = 0;
    /**
     * @brief Using model correct for space charge.
     *
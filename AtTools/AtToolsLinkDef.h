@@ -54,7 +54,11 @@
 #pragma link C++ class tk::spline - !;
 
 #pragma link C++ class AtFindVertex - !;
+#pragma link C++ class AtEntryListSource + ;
 
+#pragma link C++ class AtTools::HitKernel - !;
+#pragma link C++ function AtTools::GetHitKernelTB;
+#pragma link C++ function AtTools::AddHitToTrace;
 #pragma link C++ function AtTools::GetHitFunctionTB;
 #pragma link C++ function AtTools::GetHitFunction;
 #pragma link C++ function AtTools::GetTB;
@@ -8,262 +8,228 @@
 #include <Math/Point3D.h> // for PositionVector3D, Cart...
 #include <Math/Point3Dfwd.h>
 #include <Math/Vector3D.h>  // for DisplacementVector3D
-#include <TMath.h>          // for Power, Sqrt, ATan2, Pi
+#include <TMath.h>          // for Sqrt
 #include <TMatrixDSymfwd.h> // for TMatrixDSym
 #include <TMatrixTSym.h>    // for TMatrixTSym
-#include <TVector3.h>       // for TVector3
 
-#include <algorithm> // for max, for_each, copy_if
-#include <iterator>  // for back_insert_iterator
+#include <algorithm> // for sort, lower_bound
+#include <array>     // for array
+#include <cmath>     // for floor
+#include <iterator>  // for next
 #include <memory>    // for shared_ptr, __shared_p...
+#include <utility>   // for pair
 #include <vector>    // for vector
 
 AtTools::AtTrackTransformer::AtTrackTransformer() = default;
 AtTools::AtTrackTransformer::~AtTrackTransformer() = default;
 using XYZPoint = ROOT::Math::XYZPoint;
 
+namespace {
+
+// Diffusion coefficients (TODO: Get them from the parameter file)
+const Double_t driftVel = 1.0;       // cm/us
+const Double_t samplingRate = 0.320; // us
+const Double_t d_t = 0.0009;         // cm^2/us
+const Double_t d_l = 0.0009;         // cm^2/us
+const Double_t D_T = TMath::Sqrt((2.0 * d_t) / driftVel);
+const Double_t D_L = TMath::Sqrt((2.0 * d_l) / driftVel);
+
+/**
+ * Hits of a track sorted into a grid of cubic cells, so the hits near a point are found by only
+ * looking at the cells around it.
+ */
+class HitGrid {
+   using Cell = std::array<Int_t, 3>;
+
+   const AtTrack::HitVector &fHits;
+   Double_t fCellSize;
+   std::vector<std::pair<Cell, Int_t>> fCells; //< Cell of each hit (and its index), sorted by cell
+
+public:
+   HitGrid(const AtTrack::HitVector &hits, Double_t cellSize) : fHits(hits), fCellSize(cellSize > 0 ? cellSize : 1)
+   {
+      fCells.reserve(hits.size());
+      for (int i = 0; i < hits.size(); ++i)
+         fCells.emplace_back(GetCell(hits[i]->GetPosition(), 0), i);
+      std::sort(fCells.begin(), fCells.end());
+   }
+
+   /// Fill neighbours with the indices, in increasing order, of the hits closer than radius to pos
+   void GetNeighbours(const XYZPoint &pos, Double_t radius, std::vector<Int_t> &neighbours) const
+   {
+      neighbours.clear();
+      if (radius <= 0)
+         return;
+
+      // Look a little past radius so rounding can't move a hit on the edge out of the cells searched
+      auto reach = radius * (1 + 1e-6);
+      auto minCell = GetCell(pos, -reach);
+      auto maxCell = GetCell(pos, reach);
+      for (auto x = minCell[0]; x <= maxCell[0]; ++x)
+         for (auto y = minCell[1]; y <= maxCell[1]; ++y) {
+            auto it = std::lower_bound(fCells.begin(), fCells.end(), std::make_pair(Cell{x, y, minCell[2]}, 0));
+            for (; it != fCells.end() && it->first[0] == x && it->first[1] == y && it->first[2] <= maxCell[2]; ++it)
+               if (TMath::Sqrt((fHits[it->second]->GetPosition() - pos).Mag2()) < radius)
+                  neighbours.push_back(it->second);
+         }
+      // Keep the order of the hits in the track so the sums are done in the same order
+      std::sort(neighbours.begin(), neighbours.end());
+   }
+
+private:
+   Cell GetCell(const XYZPoint &pos, Double_t shift) const
+   {
+      return {static_cast<Int_t>(std::floor((pos.X() + shift) / fCellSize)),
+              static_cast<Int_t>(std::floor((pos.Y() + shift) / fCellSize)),
+              static_cast<Int_t>(std::floor((pos.Z() + shift) / fCellSize))};
+   }
+};
+
+/**
+ * Hit cluster with charge weighted x and y, and mean z and time stamp of the hits, accumulated in a
+ * single pass over the hits.
+ */
+std::shared_ptr<AtHitCluster> MakeCluster(const AtTrack::HitVector &hits, const std::vector<Int_t> &indices)
+{
+   // Calculation of variance (DOI: 10.1051/,00010 (2017)715001EPJ Web of Conferences50epjconf/2010010)
+   const Double_t posRes2 = 0.2 * 0.2; // 0.2 mm of position resolution
+   const Double_t D_T2 = D_T * D_T;
+   const Double_t D_L2 = D_L * D_L;
+   const Double_t timeRes2 = (1.0 / 6.0) * ((driftVel * samplingRate) * (driftVel * samplingRate));
+
+   double x = 0, y = 0, z = 0;
+   double sigma_x = 0, sigma_y = 0, sigma_z = 0;
+   int timeStamp = 0;
+   Double_t hitQ = 0.0;
+   for (auto i : indices) {
+      const auto &hit = *hits[i];
+      const auto &pos = hit.GetPosition();
+      x += pos.X() * hit.GetCharge();
+      y += pos.Y() * hit.GetCharge();
+      z += pos.Z();
+      hitQ += hit.GetCharge();
+      timeStamp += hit.GetTimeStamp();
+
+      sigma_x += hit.GetCharge() * TMath::Sqrt(posRes2 + pos.Z() * D_T2);
+      sigma_y += sigma_x;
+      sigma_z += TMath::Sqrt(timeRes2 + pos.Z() * D_L2);
+   }
+   x /= hitQ;
+   y /= hitQ;
+   z /= indices.size();
+   timeStamp /= static_cast<int>(indices.size());
+
+   sigma_x /= hitQ;
+   sigma_y /= hitQ;
+   sigma_z /= indices.size();
+
+   auto hitCluster = std::make_shared<AtHitCluster>();
+   hitCluster->SetCharge(hitQ);
+   hitCluster->SetPosition({x, y, z});
+   hitCluster->SetTimeStamp(timeStamp);
+   TMatrixDSym cov(3); // TODO: Setting covariant matrix based on pad size and drift time resolution.
+                       // Using estimations for the moment.
+   cov(0, 1) = 0;
+   cov(1, 2) = 0;
+   cov(2, 0) = 0;
+   cov(0, 0) = sigma_x * sigma_x; // 0.04;
+   cov(1, 1) = sigma_y * sigma_y; // 0.04;
+   cov(2, 2) = sigma_z * sigma_z; // 0.01;
+   hitCluster->SetCovMatrix(cov);
+   return hitCluster;
+}
+
+} // namespace
+
 void AtTools::AtTrackTransformer::ClusterizeSmooth3D(AtTrack &track, Float_t radius, Float_t distance)
 {
-   std::vector<AtHit> hitArray = track.GetHitArrayObject();
-   std::vector<AtHit> hitTBArray;
+   const auto &hitArray = track.GetHitArray();
+   if (hitArray.empty())
+      return;
+
+   // Built once, the neighbourhoods of the clusters and of the smoothed clusters are both found in it
+   HitGrid grid(hitArray, radius);
+   std::vector<Int_t> neighbours;
    int clusterID = 0;
 
-   // std::cout<<" ================================================================= "<<"\n";
-   // std::cout<<" Clusterizing track : "<<track.GetTrackID()<<"\n";
+   auto refPos = hitArray.at(0)->GetPosition(); // First hit
+   // TODO: Create a clustered hit from the very first hit (test)
 
-   /*for(auto iHits=0;iHits<hitArray->size();++iHits)
-     {
-       TVector3 pos    = hitArray->at(iHits).GetPosition();
-       double Q = hitArray->at(iHits).GetCharge();
-       int TB          = hitArray->at(iHits).GetTimeStamp();
-       //std::cout<<" Pos : "<<pos.X()<<" - "<<pos.Y()<<" - "<<pos.Z()<<" - TB : "<<TB<<" - Charge : "<<Q<<"\n";
-       }*/
+   for (const auto &hit : hitArray) {
 
-   // Diffusion coefficients (TODO: Get them from the parameter file)
-   Double_t driftVel = 1.0;       // cm/us
-   Double_t samplingRate = 0.320; // us
-   Double_t d_t = 0.0009;         // cm^2/us
-   Double_t d_l = 0.0009;         // cm^2/us
-   Double_t D_T = TMath::Sqrt((2.0 * d_t) / driftVel);
-   Double_t D_L = TMath::Sqrt((2.0 * d_l) / driftVel);
+      // Check distance with respect to reference Hit
+      Double_t distRef = TMath::Sqrt((hit->GetPosition() - refPos).Mag2());
 
-   if (hitArray.size() > 0) {
+      if (distRef >= distance) {
 
-      auto refPos = hitArray.at(0).GetPosition(); // First hit
-      // TODO: Create a clustered hit from the very first hit (test)
+         grid.GetNeighbours(refPos, radius, neighbours);
 
-      for (auto iHit = 0; iHit < hitArray.size(); ++iHit) {
+         if (!neighbours.empty()) {
+            auto hitCluster = MakeCluster(hitArray, neighbours);
+            const auto &clustPos = hitCluster->GetPosition();
 
-         auto hit = hitArray.at(iHit);
+            // Check distance with respect to existing clusters
+            Bool_t checkDistance = kTRUE;
+            for (const auto &iClusterHit : *track.GetHitClusterArray()) {
+               if (TMath::Sqrt((iClusterHit.GetPosition() - clustPos).Mag2()) < distance) {
+                  checkDistance = kFALSE;
+                  break;
+               }
+            }
 
-         // Check distance with respect to reference Hit
-         Double_t distRef = TMath::Sqrt((hit.GetPosition() - refPos).Mag2());
+            if (checkDistance) {
+               hitCluster->SetClusterID(clusterID);
+               ++clusterID;
+               track.AddClusterHit(hitCluster);
+            }
+         }
 
-         if (distRef < distance) {
+         refPos = hit->GetPosition();
+      }
+   } // for
 
-            continue;
+   // Smoothing track
+   std::vector<AtHitCluster> *hitClusterArray = track.GetHitClusterArray();
+   radius /= 2.0;
+   std::vector<std::shared_ptr<AtHitCluster>> hitClusterBuffer;
 
-         } else {
+   if (hitClusterArray->size() > 2) {
 
-            // std::cout<<" Clustering "<<iHit<<" of "<<hitArray->size()<<"\n";
-            // std::cout<<" Distance to reference : "<<distRef<<"\n";
-            // std::cout<<" Reference position : "<<refPos.X()<<" - "<<refPos.Y()<<" - "<<refPos.Z()<<" -
-            // "<<refPos.Mag()<<"\n";
+      for (auto iHitCluster = 0; iHitCluster < hitClusterArray->size() - 1;
+           ++iHitCluster) // Calculating distances between pairs of clusters
+      {
 
-            Double_t clusterQ = 0.0;
-            hitTBArray.clear();
-            std::copy_if(
-               hitArray.begin(), hitArray.end(), std::back_inserter(hitTBArray),
-               [&refPos, radius](AtHit &hitIn) { return TMath::Sqrt((hitIn.GetPosition() - refPos).Mag2()) < radius; });
+         XYZPoint clusBack = hitClusterArray->at(iHitCluster).GetPosition();
+         XYZPoint clusForw = hitClusterArray->at(iHitCluster + 1).GetPosition();
+         XYZPoint clusMidPos = clusBack + (clusForw - clusBack) * 0.5;
+         std::vector<XYZPoint> renormClus{clusBack, clusMidPos};
 
-            // std::cout<<" Clustered "<<hitTBArray.size()<<" Hits "<<"\n";
+         if (iHitCluster == (hitClusterArray->size() - 2))
+            renormClus.push_back(clusForw);
 
-            if (hitTBArray.size() > 0) {
-               double x = 0, y = 0, z = 0;
-               double sigma_x = 0, sigma_y = 0, sigma_z = 0;
+         // Create a new cluster and renormalize the charge of the other with half the radius.
+         for (const auto &iClus : renormClus) {
+            grid.GetNeighbours(iClus, radius, neighbours);
 
-               int timeStamp;
-               std::shared_ptr<AtHitCluster> hitCluster = std::make_shared<AtHitCluster>();
+            if (!neighbours.empty()) {
+               auto hitCluster = MakeCluster(hitArray, neighbours);
                hitCluster->SetClusterID(clusterID);
-               Double_t hitQ = 0.0;
-               std::for_each(hitTBArray.begin(), hitTBArray.end(),
-                             [&x, &y, &z, &hitQ, &timeStamp, &sigma_x, &sigma_y, &sigma_z, &D_T, &D_L, &driftVel,
-                              &samplingRate](AtHit &hitInQ) {
-                                XYZPoint pos = hitInQ.GetPosition();
-                                x += pos.X() * hitInQ.GetCharge();
-                                y += pos.Y() * hitInQ.GetCharge();
-                                z += pos.Z();
-                                hitQ += hitInQ.GetCharge();
-                                timeStamp += hitInQ.GetTimeStamp();
-
-                                // Calculation of variance (DOI: 10.1051/,00010 (2017)715001EPJ Web of
-                                // Conferences50epjconf/2010010)
-                                sigma_x += hitInQ.GetCharge() *
-                                           TMath::Sqrt(TMath::Power(0.2, 2) +
-                                                       pos.Z() * TMath::Power(D_T, 2)); // 0.2 mm of position resolution
-                                sigma_y += sigma_x;
-                                sigma_z += TMath::Sqrt((1.0 / 6.0) * TMath::Power(driftVel * samplingRate, 2) +
-                                                       pos.Z() * TMath::Power(D_L, 2));
-                             });
-               x /= hitQ;
-               y /= hitQ;
-               z /= hitTBArray.size();
-               timeStamp /= hitTBArray.size();
-
-               sigma_x /= hitQ;
-               sigma_y /= hitQ;
-               sigma_z /= hitTBArray.size();
-
-               XYZPoint clustPos(x, y, z);
-               Bool_t checkDistance = kTRUE;
-
-               // Check distance with respect to existing clusters
-               for (auto iClusterHit : *track.GetHitClusterArray()) {
-                  if (TMath::Sqrt((iClusterHit.GetPosition() - clustPos).Mag2()) < distance) {
-                     // std::cout<<" Cluster with less than  : "<<distance<<" found "<<"\n";
-                     checkDistance = kFALSE;
-                     continue;
-                  }
-               }
-
-               if (checkDistance) {
-                  hitCluster->SetCharge(hitQ);
-                  hitCluster->SetPosition({x, y, z});
-                  hitCluster->SetTimeStamp(timeStamp);
-                  TMatrixDSym cov(3); // TODO: Setting covariant matrix based on pad size and drift time resolution.
-                                      // Using estimations for the moment.
-                  cov(0, 1) = 0;
-                  cov(1, 2) = 0;
-                  cov(2, 0) = 0;
-                  cov(0, 0) = TMath::Power(sigma_x, 2); // 0.04;
-                  cov(1, 1) = TMath::Power(sigma_y, 2); // 0.04;
-                  cov(2, 2) = TMath::Power(sigma_z, 2); // 0.01;
-                  hitCluster->SetCovMatrix(cov);
-                  ++clusterID;
-                  track.AddClusterHit(hitCluster);
-               }
+               ++clusterID;
+               hitClusterBuffer.push_back(hitCluster);
             }
-         }
 
-         // Sanity check
-         /*std::cout<<" Hits for cluster "<<iHit<<" centered in "<<refPos.X()<<" - "<<refPos.Y()<<"-"<<refPos.Z()<<"\n";
-    for(auto iHits=0;iHits<hitTBArray.size();++iHits)
-         {
-           TVector3 pos    = hitTBArray.at(iHits).GetPosition();
-           double Q = hitTBArray.at(iHits).GetCharge();
-           int TB          = hitTBArray.at(iHits).GetTimeStamp();
-           std::cout<<" Pos : "<<pos.X()<<" - "<<pos.Y()<<" - "<<pos.Z()<<" - TB : "<<TB<<" - Charge : "<<Q<<"\n";
-      std::cout<<" Distance to cluster center "<<TMath::Abs((track.GetHitClusterArray()->back().GetPosition() -
-    pos).Mag())<<"\n";
-    }
-         std::cout<<"=================================================="<<"\n";*/
-
-         refPos = hitArray.at(iHit).GetPosition();
-
-         //} // if distance
-
-      } // for
-
-      // Smoothing track
-      std::vector<AtHitCluster> *hitClusterArray = track.GetHitClusterArray();
-      radius /= 2.0;
-      std::vector<std::shared_ptr<AtHitCluster>> hitClusterBuffer;
-
-      // std::cout<<" Hit cluster array size "<<hitClusterArray->size()<<"\n";
-
-      if (hitClusterArray->size() > 2) {
-
-         for (auto iHitCluster = 0; iHitCluster < hitClusterArray->size() - 1;
-              ++iHitCluster) // Calculating distances between pairs of clusters
-         {
-
-            XYZPoint clusBack = hitClusterArray->at(iHitCluster).GetPosition();
-            XYZPoint clusForw = hitClusterArray->at(iHitCluster + 1).GetPosition();
-            XYZPoint clusMidPos = clusBack + (clusForw - clusBack) * 0.5;
-            std::vector<XYZPoint> renormClus{clusBack, clusMidPos};
-
-            if (iHitCluster == (hitClusterArray->size() - 2))
-               renormClus.push_back(clusForw);
-
-            // Create a new cluster and renormalize the charge of the other with half the radius.
-            for (auto iClus : renormClus) {
-               hitTBArray.clear();
-               std::copy_if(hitArray.begin(), hitArray.end(), std::back_inserter(hitTBArray),
-                            [&iClus, radius](AtHit &hitIn) {
-                               return TMath::Sqrt((hitIn.GetPosition() - iClus).Mag2()) < radius;
-                            });
-
-               if (hitTBArray.size() > 0) {
-                  double x = 0, y = 0, z = 0;
-                  double sigma_x = 0, sigma_y = 0, sigma_z = 0;
-
-                  int timeStamp = 0;
-                  std::shared_ptr<AtHitCluster> hitCluster = std::make_shared<AtHitCluster>();
-                  hitCluster->SetClusterID(clusterID);
-                  Double_t hitQ = 0.0;
-                  std::for_each(hitTBArray.begin(), hitTBArray.end(),
-                                [&x, &y, &z, &hitQ, &timeStamp, &sigma_x, &sigma_y, &sigma_z, &D_T, &D_L, &driftVel,
-                                 &samplingRate](AtHit &hitInQ) {
-                                   auto pos = hitInQ.GetPosition();
-                                   x += pos.X() * hitInQ.GetCharge();
-                                   y += pos.Y() * hitInQ.GetCharge();
-                                   z += pos.Z();
-                                   hitQ += hitInQ.GetCharge();
-                                   timeStamp += hitInQ.GetTimeStamp();
-
-                                   // Calculation of variance (DOI: 10.1051/,00010 (2017)715001EPJ Web of
-                                   // Conferences50epjconf/2010010)
-                                   sigma_x +=
-                                      hitInQ.GetCharge() *
-                                      TMath::Sqrt(TMath::Power(0.2, 2) +
-                                                  pos.Z() * TMath::Power(D_T, 2)); // 0.2 mm of position resolution
-                                   sigma_y += sigma_x;
-                                   sigma_z += TMath::Sqrt((1.0 / 6.0) * TMath::Power(driftVel * samplingRate, 2) +
-                                                          pos.Z() * TMath::Power(D_L, 2));
-                                });
-                  x /= hitQ;
-                  y /= hitQ;
-                  z /= hitTBArray.size();
-                  timeStamp /= hitTBArray.size();
-
-                  sigma_x /= hitQ;
-                  sigma_y /= hitQ;
-                  sigma_z /= hitTBArray.size();
-
-                  TVector3 clustPos(x, y, z);
-                  hitCluster->SetCharge(hitQ);
-                  hitCluster->SetPosition({x, y, z});
-                  hitCluster->SetTimeStamp(timeStamp);
-                  TMatrixDSym cov(3); // TODO: Setting covariant matrix based on pad size and drift time resolution.
-                                      // Using estimations for the moment.
-                  cov(0, 1) = 0;
-                  cov(1, 2) = 0;
-                  cov(2, 0) = 0;
-                  cov(0, 0) = TMath::Power(sigma_x, 2); // 0.04;
-                  cov(1, 1) = TMath::Power(sigma_y, 2); // 0.04;
-                  cov(2, 2) = TMath::Power(sigma_z, 2); // 0.01;
-                  hitCluster->SetCovMatrix(cov);
-                  ++clusterID;
-                  hitClusterBuffer.push_back(hitCluster);
-
-               } // hitTBArray size
-
-            } // for iClus
-
-         } // for HitArray
-
-         // Remove previous clusters
-         track.ResetHitClusterArray();
-
-         // Adding new clusters
-         for (auto iHitClusterRe : hitClusterBuffer) {
-
-            track.AddClusterHit(iHitClusterRe);
-         }
+         } // for iClus
+
+      } // for HitArray
+
+      // Remove previous clusters
+      track.ResetHitClusterArray();
 
-      } // Cluster array size
+      // Adding new clusters
+      for (auto &iHitClusterRe : hitClusterBuffer)
+         track.AddClusterHit(iHitClusterRe);
 
-   } // if array size
+   } // Cluster array size
 }
 
 const std::tuple<Double_t, Double_t> AtTools::AtTrackTransformer::GetPIDFromHits(AtTrack &track, Double_t theta)
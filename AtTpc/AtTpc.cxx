@@ -27,6 +27,7 @@
 #include <TVirtualMCStack.h>
 
 #include <iostream>
+#include <utility> // for move
 
 using std::cout;
 using std::endl;
@@ -45,6 +46,18 @@ AtTpc::AtTpc(const char *name, Bool_t active)
 {
 }
 
+AtTpc::AtTpc(const AtTpc &other)
+   : FairDetector(other), fTrackID(-1), fVolumeID(-1), fPos(), fMom(), fTime(-1.), fLength(-1.), fELoss(-1),
+     fPosIndex(-1), fAtTpcPointCollection(new TClonesArray("AtMCPoint")), fELossAcc(-1),
+     fMaxSegLength(other.fMaxSegLength), fMaxSegELoss(other.fMaxSegELoss)
+{
+}
+
+FairModule *AtTpc::CloneModule() const
+{
+   return new AtTpc(*this);
+}
+
 AtTpc::~AtTpc()
 {
    if (fAtTpcPointCollection) {
@@ -72,8 +85,7 @@ void AtTpc::trackEnteringVolume()
    fTrackID = gMC->GetStack()->GetCurrentTrackNumber();
 
    // Position of the first hit of the beam in the TPC volume ( For tracking purposes in the TPC)
-   if (AtVertexPropagator::Instance()->GetBeamEvtCnt() % 2 != 0 && fTrackID == 0 &&
-       (fVolName == "drift_volume" || fVolName == "cell"))
+   if (AtVertexPropagator::Instance()->GetBeamEvtCnt() % 2 != 0 && fTrackID == 0 && fVolInfo->fIsBeamGas)
       InPos = fPosIn;
 
    Int_t VolumeID = 0;
@@ -83,7 +95,7 @@ void AtTpc::trackEnteringVolume()
    else if (AtVertexPropagator::Instance()->GetDecayEvtCnt() % 2 == 0)
       LOG(debug) << cBLUE << " AtTPC: Reaction/Decay Event ";
 
-   LOG(debug) << " AtTPC: First hit in Volume " << fVolName;
+   LOG(debug) << " AtTPC: First hit in Volume " << gMC->CurrentVolName();
    LOG(debug) << " Particle : " << gMC->ParticleName(gMC->TrackPid());
    LOG(debug) << " PID PdG : " << gMC->TrackPid();
    LOG(debug) << " Atomic Mass : " << AZ.first;
@@ -112,6 +124,7 @@ void AtTpc::getTrackParametersFromMC()
    gMC->TrackPosition(fPosIn);
    gMC->TrackMomentum(fMomIn);
    fTrackID = gMC->GetStack()->GetCurrentTrackNumber();
+   fTrackPdG = gMC->TrackPid();
 }
 
 void AtTpc::getTrackParametersWhileExiting()
@@ -123,8 +136,7 @@ void AtTpc::getTrackParametersWhileExiting()
    // Correct fPosOut
    if (gMC->IsTrackExiting()) {
       correctPosOut();
-      if ((fVolName.Contains("drift_volume") || fVolName.Contains("cell")) &&
-          AtVertexPropagator::Instance()->GetBeamEvtCnt() % 2 != 0 && fTrackID == 0)
+      if (fVolInfo->fIsGas && AtVertexPropagator::Instance()->GetBeamEvtCnt() % 2 != 0 && fTrackID == 0)
          resetVertex();
    }
 }
@@ -168,30 +180,54 @@ bool AtTpc::reactionOccursHere()
 {
    bool atEnergyLoss = fELossAcc * 1000 > AtVertexPropagator::Instance()->GetRndELoss();
    bool isPrimaryBeam = AtVertexPropagator::Instance()->GetBeamEvtCnt() % 2 != 0 && fTrackID == 0;
-   bool isInRightVolume = fVolName.Contains("drift_volume") || fVolName.Contains("cell");
+   bool isInRightVolume = fVolInfo->fIsGas;
    return atEnergyLoss && isPrimaryBeam && isInRightVolume;
 }
+
+void AtTpc::setCurrentVolume(Int_t mcID)
+{
+   auto it = fVolumeInfo.find(mcID);
+   if (it == fVolumeInfo.end()) {
+      TString name = gMC->CurrentVolName();
+      VolumeInfo info{name, AtMCPoint::FindVolID(name), name.Contains("drift_volume") || name.Contains("cell"),
+                      name == "drift_volume" || name == "cell"};
+      it = fVolumeInfo.emplace(mcID, std::move(info)).first;
+   }
+   fVolInfo = &it->second;
+}
+
 Bool_t AtTpc::ProcessHits(FairVolume *vol)
 {
    /** This method is called from the MC stepping */
 
    auto *stack = dynamic_cast<AtStack *>(gMC->GetStack());
-   fVolName = gMC->CurrentVolName();
+
+   // Close a merged segment left open by a different track or volume while the members still
+   // describe its last step
+   if (fSegOpen && (fSegTrackID != stack->GetCurrentTrackNumber() || fSegVolumeID != vol->getMCid()))
+      closeSegment();
+
    fVolumeID = vol->getMCid();
    fDetCopyID = vol->getCopyNo();
+   setCurrentVolume(fVolumeID);
 
    if (gMC->IsTrackEntering())
       trackEnteringVolume();
 
    getTrackParametersFromMC();
 
-   if (gMC->IsTrackExiting() || gMC->IsTrackStop() || gMC->IsTrackDisappeared())
+   bool isLeaving = gMC->IsTrackExiting() || gMC->IsTrackStop() || gMC->IsTrackDisappeared();
+   if (isLeaving)
       getTrackParametersWhileExiting();
 
-   addHit();
+   bool isReaction = reactionOccursHere();
+   if (fMaxSegLength > 0 || fMaxSegELoss > 0)
+      mergeStep(isLeaving || isReaction);
+   else
+      addHit(fELoss);
 
    // Reaction Occurs here
-   if (reactionOccursHere())
+   if (isReaction)
       startReactionEvent();
 
    // Increment number of AtTpc det points in TParticle
@@ -220,9 +256,53 @@ void AtTpc::startReactionEvent()
                                              StopMom.Px(), StopMom.Py(), StopMom.Pz(), StopEnergy);
 }
 
-void AtTpc::addHit()
+/**
+ * Add the current step to the open segment, or start a new one. The step entering the volume is
+ * always recorded on its own so the start of the track is known. The segment is closed once it
+ * is longer than fMaxSegLength, has more than fMaxSegELoss deposited, or endOfSegment is true.
+ */
+void AtTpc::mergeStep(bool endOfSegment)
 {
-   auto AZ = DecodePdG(gMC->TrackPid());
+   if (!fSegOpen || gMC->IsTrackEntering()) {
+      addHit(fELoss);
+      fSegOpen = !endOfSegment;
+      fSegTrackID = fTrackID;
+      fSegVolumeID = fVolumeID;
+      fSegStart = fLength;
+      fSegELoss = 0;
+      return;
+   }
+
+   fSegELoss += fELoss;
+   bool isFull = (fMaxSegLength > 0 && fLength - fSegStart >= fMaxSegLength) ||
+                 (fMaxSegELoss > 0 && fSegELoss >= fMaxSegELoss);
+   if (isFull || endOfSegment) {
+      closeSegment();
+      fSegOpen = !endOfSegment;
+   }
+}
+
+/// Record the open segment at the position of its last step.
+void AtTpc::closeSegment()
+{
+   if (!fSegOpen)
+      return;
+   addHit(fSegELoss);
+   fSegOpen = false;
+   fSegStart = fLength;
+   fSegELoss = 0;
+}
+
+void AtTpc::PostTrack()
+{
+   // Everything ending a track in the volume already closes the segment, this catches tracks
+   // killed by something else (e.g. stack cuts) so their energy is not lost.
+   closeSegment();
+}
+
+void AtTpc::addHit(Double_t eLoss)
+{
+   auto AZ = DecodePdG(fTrackPdG);
 
    Double_t EIni = 0;
    Double_t AIni = 0;
@@ -237,13 +317,16 @@ void AtTpc::addHit()
       AIni = AtVertexPropagator::Instance()->GetTrackAngle(fTrackID);
    }
 
-   AddHit(fTrackID, fVolumeID, fVolName, fDetCopyID, TVector3(fPosIn.X(), fPosIn.Y(), fPosIn.Z()),
-          TVector3(fMomIn.Px(), fMomIn.Py(), fMomIn.Pz()), fTime, fLength, fELoss, EIni, AIni, AZ.first, AZ.second);
+   auto point =
+      AddHit(fTrackID, fVolumeID, fVolInfo->fVolID, fDetCopyID, TVector3(fPosIn.X(), fPosIn.Y(), fPosIn.Z()),
+             TVector3(fMomIn.Px(), fMomIn.Py(), fMomIn.Pz()), fTime, fLength, eLoss, EIni, AIni, AZ.first, AZ.second);
+   if (fVolInfo->fVolID == AtMCPoint::kOtherVolume)
+      point->SetVolName(fVolInfo->fName);
 }
 
 void AtTpc::EndOfEvent()
 {
-
+   fSegOpen = false;
    fAtTpcPointCollection->Clear();
 }
 
@@ -308,6 +391,15 @@ AtTpc::AddHit(Int_t trackID, Int_t detID, TVector3 pos, TVector3 mom, Double_t t
 // -----   Private method AddHit   --------------------------------------------
 AtMCPoint *AtTpc::AddHit(Int_t trackID, Int_t detID, TString VolName, Int_t detCopyID, TVector3 pos, TVector3 mom,
                          Double_t time, Double_t length, Double_t eLoss, Double_t EIni, Double_t AIni, Int_t A, Int_t Z)
+{
+   auto point =
+      AddHit(trackID, detID, AtMCPoint::kOtherVolume, detCopyID, pos, mom, time, length, eLoss, EIni, AIni, A, Z);
+   point->SetVolName(std::move(VolName));
+   return point;
+}
+
+AtMCPoint *AtTpc::AddHit(Int_t trackID, Int_t detID, Int_t volID, Int_t detCopyID, TVector3 pos, TVector3 mom,
+                         Double_t time, Double_t length, Double_t eLoss, Double_t EIni, Double_t AIni, Int_t A, Int_t Z)
 {
    TClonesArray &clref = *fAtTpcPointCollection;
    Int_t size = clref.GetEntriesFast();
@@ -316,7 +408,7 @@ AtMCPoint *AtTpc::AddHit(Int_t trackID, Int_t detID, TString VolName, Int_t detC
                 << detID << ", track " << trackID << ", energy loss " << eLoss * 1e06 << " keV";
 
    return new (clref[size])
-      AtMCPoint(trackID, detID, pos, mom, time, length, eLoss, VolName, detCopyID, EIni, AIni, A, Z);
+      AtMCPoint(trackID, detID, pos, mom, time, length, eLoss, volID, detCopyID, EIni, AIni, A, Z);
 }
 
 std::pair<Int_t, Int_t> AtTpc::DecodePdG(Int_t PdG_Code)
@@ -16,6 +16,7 @@
 #include <TVector3.h>
 
 #include <string>
+#include <unordered_map>
 #include <utility>
 
 class AtMCPoint;
@@ -51,10 +52,29 @@ private:
    TClonesArray *fTraCollection{}; //!  The hit collection
    Bool_t kGeoSaved{};             //!
    TList *flGeoPar{};              //!
-   TString fVolName;
+   Int_t fTrackPdG{};              //!  PdG code of the current track
    Double32_t fELossAcc;
    TLorentzVector InPos;
 
+   /** Information about a sensitive volume, looked up once per MC volume ID */
+   struct VolumeInfo {
+      TString fName;     // Name of the volume in the geometry
+      Int_t fVolID;      // ID stored in the AtMCPoint (see AtMCPoint::VolumeID)
+      Bool_t fIsGas;     // Name contains drift_volume or cell
+      Bool_t fIsBeamGas; // Name is drift_volume or cell
+   };
+   std::unordered_map<Int_t, VolumeInfo> fVolumeInfo; //!
+   const VolumeInfo *fVolInfo{nullptr};                //!  Volume of the current step
+
+   /** Step merging (disabled if both limits are zero) */
+   Double_t fMaxSegLength{0}; //!  Maximum length of a merged segment [cm]
+   Double_t fMaxSegELoss{0};  //!  Maximum energy deposited in a merged segment [GeV]
+   Bool_t fSegOpen{false};    //!  If steps are being accumulated into a segment
+   Int_t fSegTrackID{-1};     //!
+   Int_t fSegVolumeID{-1};    //!
+   Double_t fSegStart{0};     //!  Track length at the start of the segment
+   Double_t fSegELoss{0};     //!  Energy deposited so far in the segment
+
    /** container for data points */
 
    TClonesArray *fAtTpcPointCollection; //!
@@ -76,16 +96,38 @@ public:
    virtual void Reset() override;
    virtual void Print(Option_t *option = "") const override;
    virtual void EndOfEvent() override;
+   virtual void PostTrack() override;
 
    /** From FairModule **/
    virtual void ConstructGeometry() override;
    virtual Bool_t CheckIfSensitive(std::string name) override;
+   /// Copy for a Geant4 worker thread, with its own point collection
+   virtual FairModule *CloneModule() const override;
+
+   /**
+    * Merge consecutive steps of a track into segments instead of creating an AtMCPoint for every
+    * Geant step. A segment ends when its length exceeds maxLength [cm], its energy deposit exceeds
+    * maxELoss [MeV], or the track leaves the volume, stops, or reacts. The point is placed at the
+    * end of the segment with the summed energy loss so the number of electrons (and their Fano
+    * fluctuations) generated by AtClusterize is unchanged; the entry and exit points are still
+    * recorded. AtClusterize spreads the electrons evenly along the straight line from the previous
+    * point, so maxLength should be small compared to the radius of curvature of the tracks and to
+    * the length over which the stopping power changes (e.g. near the Bragg peak).
+    * A limit <= 0 is ignored. Both <= 0 (the default) disables merging.
+    */
+   void SetStepMerging(Double_t maxLength, Double_t maxELoss = 0)
+   {
+      fMaxSegLength = maxLength;
+      fMaxSegELoss = maxELoss / 1000.;
+   }
 
    AtMCPoint *
    AddHit(Int_t trackID, Int_t detID, TVector3 pos, TVector3 mom, Double_t time, Double_t length, Double_t eLoss);
 
    AtMCPoint *AddHit(Int_t trackID, Int_t detID, TString VolName, Int_t detCopyID, TVector3 pos, TVector3 mom,
                      Double_t time, Double_t length, Double_t eLoss, Double_t EIni, Double_t AIni, Int_t A, Int_t Z);
+   AtMCPoint *AddHit(Int_t trackID, Int_t detID, Int_t volID, Int_t detCopyID, TVector3 pos, TVector3 mom,
+                     Double_t time, Double_t length, Double_t eLoss, Double_t EIni, Double_t AIni, Int_t A, Int_t Z);
 
 private:
    std::pair<Int_t, Int_t> DecodePdG(Int_t PdG_Code);
@@ -95,14 +137,17 @@ private:
    void getTrackParametersWhileExiting();
    void correctPosOut();
    void resetVertex();
-   void addHit();
+   void addHit(Double_t eLoss);
+   void mergeStep(bool endOfSegment);
+   void closeSegment();
+   void setCurrentVolume(Int_t mcID);
    bool reactionOccursHere();
    void startReactionEvent();
 
-   AtTpc(const AtTpc &);
+   AtTpc(const AtTpc &other);
    AtTpc &operator=(const AtTpc &);
 
-   ClassDefOverride(AtTpc, 2)
+   ClassDefOverride(AtTpc, 3)
 };
 
 #endif // NEWDETECTOR_H